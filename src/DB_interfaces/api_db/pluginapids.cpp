@@ -1199,7 +1199,7 @@ localstatus TPluginApiDS::apiReadSyncSet(bool aNeedAll)
         return LOCERR_WRONGUSAGE; // completely wrong usage - should never happen as compatibility is tested at module connect
         #endif
         // now save syncset item
-        fSyncSetList.push_back(syncSetItemP);
+        addToSyncSet(syncSetItemP);
       } while (true);
     } // try
     SYSYNC_CATCH (...)
@@ -3278,7 +3278,7 @@ localstatus TODBCApiDS::apiReadSyncSet(bool aNeedAll)
       // %%% for now, we do not read item contents yet
       syncsetitemP->itemP=NULL; // no item data
       // save ID in list
-      fSyncSetList.push_back(syncsetitemP);
+      addToSyncSet(syncsetitemP);
     }
     // - no more records
     finalizeSQLStatement(fODBCReadStatement, true);
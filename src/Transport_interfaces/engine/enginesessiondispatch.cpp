@@ -107,6 +107,10 @@ TEngineSessionDispatch::TEngineSessionDispatch() :
 TEngineSessionDispatch::~TEngineSessionDispatch()
 {
   fDeleting=true; // flag deletion to block calling critical (virtual) methods
+  #ifdef MULTI_THREAD_SUPPORT
+  // complete session steps still queued while sessions and this dispatcher still exist
+  stopWorkerPool();
+  #endif
   // clean up
   // %%%
 } // TEngineSessionDispatch::~TEngineSessionDispatch
@@ -290,6 +294,16 @@ TEngineServerSessionHandle::TEngineServerSessionHandle(TServerEngineInterface *a
   fSmlInstanceID = 0;
   fServerSessionStatus = LOCERR_WRONGUSAGE;
   fServerEngineInterface = aServerEngineInterface;
+  #ifdef MULTI_THREAD_SUPPORT
+  fStepMutex = newMutex();
+  fStepState = stepstate_idle;
+  fStepRefs = 0;
+  fCloseAfterCallback = false;
+  fStepCmd = STEPCMD_STEP;
+  fStepInfoP = NULL;
+  fStepDoneFunc = NULL;
+  fStepDoneContext = NULL;
+  #endif
 }
 
 TEngineServerSessionHandle::~TEngineServerSessionHandle()
@@ -300,9 +314,26 @@ TEngineServerSessionHandle::~TEngineServerSessionHandle()
   // also release the toolkit instance
   fServerEngineInterface->getSyncAppBase()->freeSmlInstance(fSmlInstanceID);
   fSmlInstanceID=NULL;
+  #ifdef MULTI_THREAD_SUPPORT
+  freeMutex(fStepMutex);
+  #endif
 }
 
 
+#ifdef MULTI_THREAD_SUPPORT
+
+bool TEngineServerSessionHandle::inStepCallback(void)
+{
+  uIntArch me = myThreadID();
+  for (std::vector<uIntArch>::iterator pos=fCallbackThreads.begin(); pos!=fCallbackThreads.end(); ++pos) {
+    if (*pos==me) return true;
+  }
+  return false;
+} // TEngineServerSessionHandle::inStepCallback
+
+#endif
+
+
 // TServerEngineInterface
 // ======================
 
@@ -420,9 +451,34 @@ TSyError TServerEngineInterface::OpenSessionKey(SessionH aSessionH, KeyH &aNewKe
 TSyError TServerEngineInterface::CloseSession(SessionH aSessionH)
 {
   if (!aSessionH) return LOCERR_WRONGUSAGE;
-  TSyError sta = LOCERR_OK;
   TEngineServerSessionHandle *sessionHandleP = reinterpret_cast<TEngineServerSessionHandle *>(aSessionH);
-  TSyncAgent *serverSessionP = sessionHandleP->fServerSessionP;
+  #ifdef MULTI_THREAD_SUPPORT
+  // session must not be closed while a worker executes a step for it
+  lockMutex(sessionHandleP->fStepMutex);
+  if (sessionHandleP->fCloseAfterCallback) {
+    // already closing
+    unlockMutex(sessionHandleP->fStepMutex);
+    return LOCERR_WRONGUSAGE;
+  }
+  if (sessionHandleP->inStepCallback()) {
+    // called from completion callback: close when the last step frame using the handle returns
+    sessionHandleP->fCloseAfterCallback = true;
+    unlockMutex(sessionHandleP->fStepMutex);
+    return LOCERR_OK;
+  }
+  bool busy = sessionHandleP->fStepRefs>0;
+  unlockMutex(sessionHandleP->fStepMutex);
+  if (busy) return LOCERR_WRONGUSAGE;
+  #endif
+  return closeSessionHandle(sessionHandleP);
+} // TServerEngineInterface::CloseSession
+
+
+// terminates the session and deletes the handle
+TSyError TServerEngineInterface::closeSessionHandle(TEngineServerSessionHandle *aSessionHandleP)
+{
+  TSyError sta = LOCERR_OK;
+  TSyncAgent *serverSessionP = aSessionHandleP->fServerSessionP;
   if (serverSessionP) {
     // session still exists
     if (!serverSessionP->isAborted()) {
@@ -433,19 +489,19 @@ TSyError TServerEngineInterface::CloseSession(SessionH aSessionH)
       // - terminate (might hang a while until subthreads properly terminate)
       serverSessionP->TerminateSession();
       // - delete
-      sessionHandleP->fServerSessionP = NULL; // consider deleted, whatever happens
+      aSessionHandleP->fServerSessionP = NULL; // consider deleted, whatever happens
       delete serverSessionP; // might hang until subthreads have terminated
     }
     SYSYNC_CATCH(...)
-      sessionHandleP->fServerSessionP = NULL; // consider deleted, even if failed
+      aSessionHandleP->fServerSessionP = NULL; // consider deleted, even if failed
       sta = LOCERR_EXCEPTION;
     SYSYNC_ENDCATCH
   }
   // forget session handle (and toolkit instance)
-  delete sessionHandleP;
+  delete aSessionHandleP;
   // done
   return LOCERR_OK;
-}
+} // TServerEngineInterface::closeSessionHandle
 
 
 /// @brief Executes sync session or other sync related activity step by step
@@ -481,6 +537,88 @@ TSyError TServerEngineInterface::SessionStep(SessionH aSessionH, uInt16 &aStepCm
 } // TServerEngineInterface::SessionStep
 
 
+#ifdef MULTI_THREAD_SUPPORT
+
+// executes the step posted by SessionStepAsync on a worker thread
+void TEngineServerSessionHandle::StepWorkFunc(void *aContext)
+{
+  TEngineServerSessionHandle *sessionHandleP = static_cast<TEngineServerSessionHandle *>(aContext);
+  uInt16 stepCmd = sessionHandleP->fStepCmd;
+  TSyError sta;
+  SYSYNC_TRY {
+    sta = sessionHandleP->fServerEngineInterface->SessionStep((SessionH)sessionHandleP, stepCmd, sessionHandleP->fStepInfoP);
+  }
+  SYSYNC_CATCH (...)
+    sta = LOCERR_EXCEPTION;
+  SYSYNC_ENDCATCH
+  // step is complete, callback may post the next one or close the session
+  uIntArch me = myThreadID();
+  lockMutex(sessionHandleP->fStepMutex);
+  TSessionStepDoneFunc doneFunc = sessionHandleP->fStepDoneFunc;
+  void *doneContext = sessionHandleP->fStepDoneContext;
+  sessionHandleP->fStepState = stepstate_callback;
+  sessionHandleP->fCallbackThreads.push_back(me);
+  unlockMutex(sessionHandleP->fStepMutex);
+  if (doneFunc) doneFunc((SessionH)sessionHandleP, stepCmd, sta, doneContext);
+  // callback has returned. Note that a step posted by the callback may have run and
+  // returned from its own callback in the meantime (nested, or on another worker)
+  lockMutex(sessionHandleP->fStepMutex);
+  for (std::vector<uIntArch>::iterator pos=sessionHandleP->fCallbackThreads.begin(); pos!=sessionHandleP->fCallbackThreads.end(); ++pos) {
+    if (*pos==me) {
+      sessionHandleP->fCallbackThreads.erase(pos);
+      break;
+    }
+  }
+  if (sessionHandleP->fStepState==stepstate_callback && sessionHandleP->fCallbackThreads.empty())
+    sessionHandleP->fStepState = stepstate_idle;
+  // this frame no longer uses the handle
+  bool closeNow = --sessionHandleP->fStepRefs==0 && sessionHandleP->fCloseAfterCallback;
+  unlockMutex(sessionHandleP->fStepMutex);
+  // Note: unless closeNow, the handle must not be touched any more from here, as another
+  //       frame or the application might close the session now
+  if (closeNow)
+    sessionHandleP->fServerEngineInterface->closeSessionHandle(sessionHandleP);
+} // TEngineServerSessionHandle::StepWorkFunc
+
+
+/// @brief Executes a session step on the engine's worker pool
+TSyError TServerEngineInterface::SessionStepAsync(SessionH aSessionH, uInt16 aStepCmd, TEngineProgressInfo *aInfoP, TSessionStepDoneFunc aDoneFunc, void *aContext)
+{
+  if (!aSessionH) return LOCERR_WRONGUSAGE;
+  TEngineServerSessionHandle *sessionHandleP = reinterpret_cast<TEngineServerSessionHandle *>(aSessionH);
+  // previous step must be completed (or we are called from its completion callback)
+  lockMutex(sessionHandleP->fStepMutex);
+  if (
+    sessionHandleP->fStepState==TEngineServerSessionHandle::stepstate_running ||
+    (sessionHandleP->fStepState==TEngineServerSessionHandle::stepstate_callback && !sessionHandleP->inStepCallback()) ||
+    sessionHandleP->fCloseAfterCallback
+  ) {
+    unlockMutex(sessionHandleP->fStepMutex);
+    return LOCERR_WRONGUSAGE;
+  }
+  // set up step, which holds a reference on the handle until it returns from its callback
+  sessionHandleP->fStepState = TEngineServerSessionHandle::stepstate_running;
+  sessionHandleP->fStepRefs++;
+  sessionHandleP->fStepCmd = aStepCmd;
+  sessionHandleP->fStepInfoP = aInfoP;
+  sessionHandleP->fStepDoneFunc = aDoneFunc;
+  sessionHandleP->fStepDoneContext = aContext;
+  unlockMutex(sessionHandleP->fStepMutex);
+  TWorkerPool *poolP = getSyncAppBase()->getWorkerPool();
+  if (poolP) {
+    // run on the pool, keep the session on the same worker unless it gets stolen
+    poolP->post(TEngineServerSessionHandle::StepWorkFunc, sessionHandleP, NULL, NULL, (uIntArch)sessionHandleP);
+  }
+  else {
+    // no worker pool configured, execute right now
+    TEngineServerSessionHandle::StepWorkFunc(sessionHandleP);
+  }
+  return LOCERR_OK;
+} // TServerEngineInterface::SessionStepAsync
+
+#endif // MULTI_THREAD_SUPPORT
+
+
 /// @brief returns the SML instance for a given session handle
 ///   (internal helper to allow TEngineInterface to provide the access to the SyncML buffer)
 InstanceID_t TServerEngineInterface::getSmlInstanceOfSession(SessionH aSessionH)
@@ -19,11 +19,24 @@
 namespace sysync {
 
 
+#ifdef MULTI_THREAD_SUPPORT
+/// @brief completion callback for SessionStepAsync
+/// @param aSessionH[in] session handle the step was executed for
+/// @param aStepCmd[in] step command returned by the step (STEPCMD_xxx, see SessionStep)
+/// @param aStatus[in] status returned by the step
+/// @param aContext[in] context passed to SessionStepAsync
+typedef void (*TSessionStepDoneFunc)(SessionH aSessionH, uInt16 aStepCmd, TSyError aStatus, void *aContext);
+#endif
+
+
+class TEngineServerSessionHandle;
+
 // Engine module class
 class TServerEngineInterface :
   public TEngineInterface
 {
   typedef TEngineInterface inherited;
+  friend class TEngineServerSessionHandle;
 public:
   // constructor
   TServerEngineInterface() {};
@@ -64,11 +77,33 @@ public:
   /// @return LOCERR_OK on success, SyncML or LOCERR_xxx error code on failure
   virtual TSyError SessionStep(SessionH aSessionH, uInt16 &aStepCmd,  TEngineProgressInfo *aInfoP = NULL);
 
+  #ifdef MULTI_THREAD_SUPPORT
+  /// @brief Executes a session step on the engine's worker pool
+  /// @note  Only one step per session may be outstanding; the next step may be posted
+  ///        from within the completion callback. CloseSession may be called from within the
+  ///        completion callback as well, the session is then closed when the last step posted
+  ///        for it has returned from its callback. If no <workerthreads> are configured,
+  ///        the step is executed synchronously and the callback is called before returning.
+  /// @param aSessionH[in] session handle obtained with OpenSession
+  /// @param aStepCmd[in] step command (STEPCMD_xxx), see SessionStep
+  /// @param aInfoP[in] pointer to a TEngineProgressInfo structure, NULL if no progress info needed.
+  ///        Must remain valid until the completion callback is called.
+  /// @param aDoneFunc[in] called on the worker thread when the step has completed
+  /// @param aContext[in] passed to aDoneFunc
+  /// @return LOCERR_OK if step was posted, LOCERR_WRONGUSAGE if session has a step outstanding
+  virtual TSyError SessionStepAsync(SessionH aSessionH, uInt16 aStepCmd, TEngineProgressInfo *aInfoP, TSessionStepDoneFunc aDoneFunc, void *aContext);
+  #endif
+
 protected:
 
   /// @brief returns the SML instance for a given session handle
   virtual InstanceID_t getSmlInstanceOfSession(SessionH aSessionH);
 
+private:
+
+  /// @brief terminates the session and deletes the handle (no step must be outstanding)
+  TSyError closeSessionHandle(TEngineServerSessionHandle *aSessionHandleP);
+
 }; // TServerEngineInterface
 
 
@@ -133,6 +168,26 @@ public:
   InstanceID_t fSmlInstanceID;
   // status of the session
   localstatus fServerSessionStatus;
+  #ifdef MULTI_THREAD_SUPPORT
+  // outstanding SessionStepAsync, all protected by fStepMutex
+  MutexPtr_t fStepMutex;
+  enum {
+    stepstate_idle,     // no step outstanding
+    stepstate_running,  // step posted or executing
+    stepstate_callback  // completion callback executing (may post next step or close the session)
+  } fStepState;
+  sInt32 fStepRefs; // steps posted and not yet returned from their completion callback (nested ones included)
+  std::vector<uIntArch> fCallbackThreads; // threads executing a completion callback of this session
+  bool fCloseAfterCallback; // CloseSession was called from a completion callback, last step to return closes the session
+  uInt16 fStepCmd;
+  TEngineProgressInfo *fStepInfoP;
+  TSessionStepDoneFunc fStepDoneFunc;
+  void *fStepDoneContext;
+  // worker function for SessionStepAsync
+  static void StepWorkFunc(void *aContext);
+  // true if called from within one of this session's completion callbacks (fStepMutex must be locked)
+  bool inStepCallback(void);
+  #endif
 };
 
 
@@ -88,6 +88,7 @@ SYSYNC=\
   sysync/sysync_md5.cpp\
   sysync/syncsession.cpp\
   sysync/syncappbase.cpp\
+  sysync/workerpool.cpp\
   sysync/lineartime.cpp\
   sysync/iso8601.cpp\
   sysync/stringutils.cpp\
@@ -23,6 +23,14 @@ bool   tryLockMutex( MutexPtr_t m );
 bool    unlockMutex( MutexPtr_t m );
 void      freeMutex( MutexPtr_t m );
 
+typedef void* CondPtr_t;
+
+CondPtr_t   newCond();
+bool       waitCond( CondPtr_t c, MutexPtr_t m ); // m must be locked
+bool     signalCond( CondPtr_t c );
+bool  broadcastCond( CondPtr_t c );
+void       freeCond( CondPtr_t c );
+
 
 #endif /* PLATFORM_MUTEX_H */
 /* eof */
@@ -25,4 +25,12 @@ bool    unlockMutex( MutexPtr_t m ) { return pthread_mutex_unlock ( (pthread_mut
 void      freeMutex( MutexPtr_t m ) {        pthread_mutex_destroy( (pthread_mutex_t*)m );
                                                       delete (pthread_mutex_t*)m;   }
 
+CondPtr_t   newCond()                          {        pthread_cond_t* c= new pthread_cond_t;
+                                                        pthread_cond_init     ( (pthread_cond_t*)c, NULL ); return c; }
+bool       waitCond( CondPtr_t c, MutexPtr_t m ) { return pthread_cond_wait     ( (pthread_cond_t*)c, (pthread_mutex_t*)m ) == 0; }
+bool     signalCond( CondPtr_t c )             { return pthread_cond_signal   ( (pthread_cond_t*)c ) == 0; }
+bool  broadcastCond( CondPtr_t c )             { return pthread_cond_broadcast( (pthread_cond_t*)c ) == 0; }
+void       freeCond( CondPtr_t c )             {        pthread_cond_destroy  ( (pthread_cond_t*)c );
+                                                        delete (pthread_cond_t*)c;    }
+
 /* eof */
@@ -66,12 +66,15 @@ static void printUsage(const char *aCmdName)
   execSQL(-1,NULL);
   #endif
   convertData(-1,NULL);
+  syncBench(-1,NULL);
   testLogin(-1,NULL);
   charConv(-1,NULL);
   timeConv(-1,NULL);
   rruleConv(-1,NULL);
   parse2822AddrSpec(-1,NULL);
   wbxmlConv(-1,NULL);
+  decodeBench(-1,NULL);
+  codecBench(-1,NULL);
 }
 
 
@@ -213,6 +216,8 @@ int main(int argc, char *argv[])
   #endif
   else if (strucmp(command,"convert")==0)
     exit(sysync::convertData(cmdargc,cmdargv));
+  else if (strucmp(command,"bench")==0)
+    exit(sysync::syncBench(cmdargc,cmdargv));
   else if (strucmp(command,"login")==0)
     exit(sysync::testLogin(cmdargc,cmdargv));
   else if (strucmp(command,"charconv")==0)
@@ -225,6 +230,10 @@ int main(int argc, char *argv[])
     exit(sysync::rruleConv(cmdargc,cmdargv));
   else if (strucmp(command,"wbxml2xml")==0)
     exit(sysync::wbxmlConv(cmdargc,cmdargv));
+  else if (strucmp(command,"decodebench")==0)
+    exit(sysync::decodeBench(cmdargc,cmdargv));
+  else if (strucmp(command,"codecbench")==0)
+    exit(sysync::codecBench(cmdargc,cmdargv));
   else {
     CONSOLEPRINTF(("Unknown Command '%s'\n",command));
     printUsage(argv[0]);
@@ -88,6 +88,7 @@ SML_API_DEF Ret_t smlLockReadBuffer(InstanceID_t id, MemPtr_t *pReadPosition, Me
 SML_API_DEF Ret_t smlUnlockReadBuffer(InstanceID_t id, MemSize_t processedBytes);
 #ifdef NOWSM
 SML_API Ret_t smlSetMaxOutgoingSize(InstanceID_t id, MemSize_t maxOutgoingSize);
+SML_API Ret_t smlSetWBXMLStringTable(InstanceID_t id, Boolean_t enable);
 SML_API Ret_t smlSetOutgoingBegin(InstanceID_t id);
 SML_API Ret_t smlReadOutgoingAgain(InstanceID_t id);
 SML_API Ret_t smlPeekMessageBuffer(InstanceID_t id, Boolean_t outgoing, MemPtr_t *message, MemSize_t *msgsize);
@@ -146,6 +147,7 @@ SML_API_DEF Ret_t smlMoveCmd(InstanceID_t id, SmlMovePtr_t pContent);
 #endif
 SML_API_DEF Ret_t smlStartEvaluation(InstanceID_t id);
 SML_API_DEF Ret_t smlEndEvaluation(InstanceID_t id, MemSize_t *freemem);
+SML_API_DEF Ret_t smlReuseEvaluation(InstanceID_t id);
 
 
 /*
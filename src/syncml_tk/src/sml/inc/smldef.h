@@ -196,7 +196,8 @@ typedef enum {
   SML_FIRST_COMMAND,
   SML_NEXT_COMMAND,
   SML_NEXT_MESSAGE,
-  SML_ALL_COMMANDS
+  SML_ALL_COMMANDS,
+  SML_AVAILABLE_COMMANDS /**< like SML_ALL_COMMANDS, but the workspace may not yet contain the entire message */
 } SmlProcessMode_t;
 
 
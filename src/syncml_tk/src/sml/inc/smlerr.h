@@ -62,6 +62,7 @@
 #define SML_ERR_OK               0x00      /**< OK  */
 
 #define SML_ERR_CONTINUE         0x01      /**< OK, but processing of message not finished yet (smlProcessData(NEXT_COMMAND) case) */
+#define SML_ERR_NEED_MORE_DATA   0x02      /**< OK, but the workspace ends within the message (smlProcessData(AVAILABLE_COMMANDS) case) */
 
 
 /*
@@ -198,3 +198,98 @@ SML_API void *smlLibMalloc(MemSize_t size) {
 
 
 #endif /* SML_LIB_MEMORY_FUNCTION_POINTERS */
+
+
+/*************************************************************************
+ *  Scratch arena
+ *************************************************************************/
+
+/* allocations are aligned to this */
+#define ARENA_ALIGN(n) (((n) + sizeof(void *) - 1) & ~(MemSize_t)(sizeof(void *) - 1))
+/* block header size, rounded up so the payload is aligned as well */
+#define ARENA_HDRSIZE ARENA_ALIGN(sizeof(SmlLibArenaBlock_t))
+
+
+/**
+ * Creates a new, empty arena. The first block is allocated with the
+ * first smlLibArenaAlloc() call.
+ *
+ * @param blockSize (IN)
+ *        default size of the blocks the arena gets from the heap
+ * @return the new arena\n
+ *         NULL, if not enough memory
+ */
+SML_API SmlLibArenaPtr_t smlLibArenaNew(MemSize_t blockSize)
+{
+  SmlLibArenaPtr_t pArena;
+
+  if ((pArena = (SmlLibArenaPtr_t)smlLibMalloc(sizeof(SmlLibArena_t))) == NULL)
+    return NULL;
+  pArena->current = NULL;
+  pArena->blockSize = blockSize;
+  return pArena;
+}
+
+
+/**
+ * Allocates "size" bytes from the arena. Requests which do not fit into
+ * the current block get a new block of at least the arena's block size.
+ *
+ * @return pointer to the (uninitialized) memory\n
+ *         NULL, if not enough memory
+ */
+SML_API void *smlLibArenaAlloc(SmlLibArenaPtr_t pArena, MemSize_t size)
+{
+  SmlLibArenaBlockPtr_t pBlock = pArena->current;
+  MemSize_t bsize;
+  void *p;
+
+  size = ARENA_ALIGN(size);
+  if (pBlock == NULL || pBlock->size - pBlock->used < size) {
+    /* need a new block */
+    bsize = size > pArena->blockSize ? size : pArena->blockSize;
+    if ((pBlock = (SmlLibArenaBlockPtr_t)smlLibMalloc(ARENA_HDRSIZE + bsize)) == NULL)
+      return NULL;
+    pBlock->next = pArena->current;
+    pBlock->size = bsize;
+    pBlock->used = 0;
+    pArena->current = pBlock;
+  }
+  p = (MemPtr_t)pBlock + ARENA_HDRSIZE + pBlock->used;
+  pBlock->used += size;
+  return p;
+}
+
+
+/**
+ * Gives back everything allocated from the arena so far. The most recent
+ * block is kept for reuse, all others are freed.
+ */
+SML_API void smlLibArenaReset(SmlLibArenaPtr_t pArena)
+{
+  SmlLibArenaBlockPtr_t pBlock, pNext;
+
+  if (pArena == NULL || pArena->current == NULL)
+    return;
+  pBlock = pArena->current->next;
+  while (pBlock) {
+    pNext = pBlock->next;
+    smlLibFree(pBlock);
+    pBlock = pNext;
+  }
+  pArena->current->next = NULL;
+  pArena->current->used = 0;
+}
+
+
+/**
+ * Frees the arena and all memory allocated from it.
+ */
+SML_API void smlLibArenaFree(SmlLibArenaPtr_t pArena)
+{
+  if (pArena == NULL)
+    return;
+  smlLibArenaReset(pArena);
+  smlLibFree(pArena->current);
+  smlLibFree(pArena);
+}
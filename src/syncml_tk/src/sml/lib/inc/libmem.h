@@ -102,5 +102,38 @@ extern void  *(*smlLibMalloc)(MemSize_t size);
 #endif
 
 
+/*************************************************************************
+ *  Scratch arena
+ *************************************************************************/
+
+/**
+ * Bump allocator for short lived scratch memory (e.g. tag names while
+ * scanning a message). Memory obtained from an arena must NOT be passed
+ * to smlLibFree(); it is given back all at once by smlLibArenaReset()
+ * or smlLibArenaFree().
+ * Protocol elements returned by the decoder do not come from an arena
+ * (yet): they are owned by the application (see xltDecNext()), which may
+ * keep them beyond the message and frees or replaces parts of them one by
+ * one with smlLibFree(), possibly from another thread. A per-message
+ * element arena needs a deep copy out of it for all elements kept beyond
+ * the message (delayed commands, incomplete chunked items) first.
+ */
+typedef struct SmlLibArenaBlock_s {
+  struct SmlLibArenaBlock_s *next;  /**< previously filled block */
+  MemSize_t size;                   /**< usable bytes in this block */
+  MemSize_t used;                   /**< bytes handed out from this block */
+} SmlLibArenaBlock_t, *SmlLibArenaBlockPtr_t;
+
+typedef struct SmlLibArena_s {
+  SmlLibArenaBlockPtr_t current;    /**< block allocations are taken from, NULL if none yet */
+  MemSize_t blockSize;              /**< default size for new blocks */
+} SmlLibArena_t, *SmlLibArenaPtr_t;
+
+SML_API_DEF SmlLibArenaPtr_t smlLibArenaNew(MemSize_t blockSize);
+SML_API_DEF void *smlLibArenaAlloc(SmlLibArenaPtr_t pArena, MemSize_t size);
+SML_API_DEF void smlLibArenaReset(SmlLibArenaPtr_t pArena);
+SML_API_DEF void smlLibArenaFree(SmlLibArenaPtr_t pArena);
+
+
 #endif
 
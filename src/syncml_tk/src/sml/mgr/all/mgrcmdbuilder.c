@@ -247,6 +247,10 @@ SML_API Ret_t smlEndMessage(InstanceID_t id, Boolean_t final)
   MemPtr_t            pCurrentWritePosition;       // current Position from to which to write
   MemPtr_t            pBeginPosition;              // saves the first position which has been written
   MemSize_t           freeSize;                    // size of free memory for writing
+  #ifdef NOWSM
+  SmlEncoding_t       enc;                         // encoding of the message
+  MemSize_t           msgSize;                     // size of the complete message
+  #endif
 
 
   #ifdef NOWSM
@@ -263,6 +267,9 @@ SML_API Ret_t smlEndMessage(InstanceID_t id, Boolean_t final)
   if (pInstanceInfo==NULL) return SML_ERR_MGR_INVALID_INSTANCE_INFO;
   // %%% luz 2003-08-19: added NULL check as previously failed encoding will delete encoder
   if (pInstanceInfo->encoderState==NULL) return SML_ERR_MGR_INVALID_INSTANCE_INFO;
+  #ifdef NOWSM
+  enc = ((XltEncoderPtr_t)(pInstanceInfo->encoderState))->enc;
+  #endif
 
 
   /* --- Get Write Access to the workspace --- */
@@ -300,6 +307,15 @@ SML_API Ret_t smlEndMessage(InstanceID_t id, Boolean_t final)
   /* --- End Write Access to the workspace --- */
   rc = smlUnlockWriteBuffer(id, (MemSize_t)pCurrentWritePosition-(MemSize_t)pBeginPosition);
 
+  #ifdef NOWSM
+  // now that the message is complete, move repeated strings into the WBXML string table
+  if (rc==SML_ERR_OK && pInstanceInfo->wbxmlStringTable && pInstanceInfo->outgoingMsgStart) {
+    msgSize = pInstanceInfo->writePointer-pInstanceInfo->outgoingMsgStart;
+    // message is left as-is if compacting fails
+    if (xltEncStringTable(enc, pInstanceInfo->outgoingMsgStart, &msgSize)==SML_ERR_OK)
+      pInstanceInfo->writePointer = pInstanceInfo->outgoingMsgStart+msgSize;
+  }
+  #endif
 
   return rc;
 }
@@ -701,6 +717,38 @@ SML_API Ret_t smlEndEvaluation(InstanceID_t id, MemSize_t *freemem)
   return rc;
 }
 
+
+/**
+ * Declares that the next command API call will issue the command measured by
+ * the last evaluation run again, with unchanged content. The encoding made
+ * during evaluation is then committed instead of encoding the command twice.
+ *
+ * @param id (IN)
+ *        ID of the used instance
+ * @return Return Code
+ */
+SML_API Ret_t smlReuseEvaluation(InstanceID_t id)
+{
+  InstanceInfoPtr_t   pInstanceInfo;               // pointer the the instance info structure for this id
+
+  #ifdef NOWSM
+    pInstanceInfo = (InstanceInfoPtr_t)id; // ID is the instance info pointer
+  #else
+    /* --- Retrieve the corresponding instanceInfo structure --- */
+    #ifdef __SML_LITE__  /* Only ONE instance is supported in the Toolkit lite version */
+      pInstanceInfo = mgrGetInstanceListAnchor();
+    #else
+      pInstanceInfo = (InstanceInfoPtr_t) findInfo(id);
+    #endif
+  #endif
+
+  if (pInstanceInfo==NULL) return SML_ERR_MGR_INVALID_INSTANCE_INFO;
+  if (pInstanceInfo->encoderState==NULL)
+    return SML_ERR_WRONG_USAGE;
+
+  return xltReuseEvaluation((XltEncoderPtr_t)(pInstanceInfo->encoderState));
+}
+
 #endif
 
 
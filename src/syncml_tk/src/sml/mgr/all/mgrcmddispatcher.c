@@ -74,13 +74,16 @@
 #endif
 Ret_t smlLockReadBuffer(InstanceID_t id, MemPtr_t *pReadPosition, MemSize_t *usedSize);
 Ret_t smlUnlockReadBuffer(InstanceID_t id, MemSize_t processedBytes);
+Ret_t smlLockWriteBuffer(InstanceID_t id, MemPtr_t *pWritePosition, MemSize_t *freeSize);
+Ret_t smlUnlockWriteBuffer(InstanceID_t id, MemSize_t writtenBytes);
 
 /* Prototypes of exported SyncML API functions */
 extern Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode);
 
 /* Private function prototypes */
-static Ret_t mgrProcessNextCommand(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo);
-static Ret_t mgrProcessStartMessage(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo);
+static Ret_t mgrProcessNextCommand(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo, Boolean_t partial);
+static Ret_t mgrProcessStartMessage(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo, Boolean_t partial);
+static Boolean_t mgrTerminateAvailableData(InstanceID_t id);
 Ret_t mgrResetWorkspace (InstanceID_t id);
 
 
@@ -106,6 +109,14 @@ Ret_t mgrResetWorkspace (InstanceID_t id);
  *        subsequently until the end of the entire workspace buffer
  *        is reached. The NEXT_COMMAND flag defines the blocking mode,
  *        the ALL_COMMANDS tag defines the non-blocking mode.
+ *        AVAILABLE_COMMANDS processes all commands the workspace completely
+ *        contains so far, and returns SML_ERR_NEED_MORE_DATA when it ends
+ *        within the message. The application then appends the next part of
+ *        the message and calls smlProcessData again, which continues with
+ *        the incomplete command. Once the message is known to be complete,
+ *        ALL_COMMANDS or NEXT_COMMAND must be used to detect invalid
+ *        documents, as AVAILABLE_COMMANDS cannot tell them from
+ *        incomplete ones.
  * @return Return Code
  */
 SML_API Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode)
@@ -113,6 +124,7 @@ SML_API Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode)
   /* --- Definitions --- */
   InstanceInfoPtr_t   pInstanceInfo;               // state info for the given instanceID
   Ret_t               rc;                          // Temporary return code saver
+  Boolean_t           partial=FALSE;               // workspace may not contain the entire message yet
 
 
   #ifdef NOWSM
@@ -131,11 +143,18 @@ SML_API Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode)
   /* --- Are callback functions defined? --- */
   if (pInstanceInfo->callbacks==NULL) return SML_ERR_COMMAND_NOT_HANDLED;
 
+  /* --- Can more of the message still arrive? --- */
+  if (mode==SML_AVAILABLE_COMMANDS) {
+    // if the workspace is full, nothing can be appended any more, so what
+    // we have must be the entire message
+    partial = mgrTerminateAvailableData(id);
+  }
+
   /* --- Is parsing already in progress? --- */
   if (pInstanceInfo->decoderState==NULL)
     {
     /* No! Parse the Message header section first */
-    rc = mgrProcessStartMessage(id, pInstanceInfo);
+    rc = mgrProcessStartMessage(id, pInstanceInfo, partial);
 
     if (rc!=SML_ERR_OK) return rc;
     }
@@ -143,17 +162,20 @@ SML_API Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode)
 
   /* --- Parse now the Message body section! --- */
   do {
-    rc=mgrProcessNextCommand(id, pInstanceInfo);
+    rc=mgrProcessNextCommand(id, pInstanceInfo, partial);
   } while (
     // keep processing while no error occurs,
     // AND the document end was not reached (decoderState has been invalidated),
-    // AND the ALL_COMMAND mode is used
+    // AND the ALL_COMMAND or AVAILABLE_COMMANDS mode is used
     (rc==SML_ERR_OK)
     &&((pInstanceInfo->decoderState)!=NULL)
-    &&(mode==SML_ALL_COMMANDS)
+    &&(mode==SML_ALL_COMMANDS || mode==SML_AVAILABLE_COMMANDS)
   );
 
-  if (rc != SML_ERR_OK) {
+  if (rc==SML_ERR_NEED_MORE_DATA) {
+    // decoder and workspace are kept as they are, waiting for more data
+  }
+  else if (rc != SML_ERR_OK) {
     // abort, unlock the buffer again without changing it's current position
     smlUnlockReadBuffer(id, (MemSize_t)0);
     // Reset the decoder module (free the decoding object)
@@ -182,6 +204,33 @@ SML_API Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode)
 
 
 
+/**
+ * Places a NUL byte after the data currently in the workspace (without
+ * adding it to the data), so the scanners cannot run beyond the end of a
+ * message that is not yet complete.
+ *
+ * @param id (IN)
+ *        current InstanceID
+ * @return TRUE if the workspace has room for more data,\n
+ *         FALSE if it is full (and the message therefore cannot grow any more)
+ */
+static Boolean_t mgrTerminateAvailableData(InstanceID_t id)
+{
+  MemPtr_t            pWritePosition;              // end of the data in the workspace
+  MemSize_t           freeSize;                    // room left in the workspace
+
+  if (smlLockWriteBuffer(id, &pWritePosition, &freeSize)!=SML_ERR_OK) {
+    smlUnlockWriteBuffer(id, (MemSize_t)0);
+    return FALSE;
+  }
+  if (freeSize>0)
+    *pWritePosition=0;
+  smlUnlockWriteBuffer(id, (MemSize_t)0);
+  return freeSize>0;
+}
+
+
+
 /**
  * Parses the header information at the beginning of an SyncML document.
  *
@@ -190,10 +239,13 @@ SML_API Ret_t smlProcessData(InstanceID_t id, SmlProcessMode_t mode)
  * @param pInstanceInfo (IN/OUT)
  *        state information of the given InstanceID
  *        (decoder state will be changed)
+ * @param partial (IN)
+ *        if set, the workspace may not yet contain the entire header
  * @return Return value of the Parser,\n
- *         SML_ERR_OK if next command was handled successfully
+ *         SML_ERR_OK if next command was handled successfully,\n
+ *         SML_ERR_NEED_MORE_DATA if partial and the header is incomplete
  */
-static Ret_t mgrProcessStartMessage(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo)
+static Ret_t mgrProcessStartMessage(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo, Boolean_t partial)
 {
 
 
@@ -226,6 +278,13 @@ static Ret_t mgrProcessStartMessage(InstanceID_t id, InstanceInfoPtr_t pInstance
                   pCurrentReadPosition+usedSize-1, &pCurrentReadPosition,
                   (XltDecoderPtr_t *)&(pInstanceInfo->decoderState), &pContent);
 
+  if (rc!=SML_ERR_OK && partial) {
+    // header not yet complete, leave everything in the workspace and
+    // decode the header again from the beginning when more data has arrived
+    smlUnlockReadBuffer(id, (MemSize_t)0);
+    pInstanceInfo->decoderState=NULL;
+    return SML_ERR_NEED_MORE_DATA;
+  }
   if (rc!=SML_ERR_OK) {
     // abort, unlock the buffer again without changing it's current position
     smlUnlockReadBuffer(id, (MemSize_t)0);
@@ -270,10 +329,13 @@ static Ret_t mgrProcessStartMessage(InstanceID_t id, InstanceInfoPtr_t pInstance
  *        current InstanceID to pass to callback functions
  * @param pInstanceInfo (IN)
  *        state information of the given InstanceID
+ * @param partial (IN)
+ *        if set, the workspace may not yet contain the entire command
  * @return Return value of the Parser of the called application callback,\n
- *         SML_ERR_OK if next command was handled successfully
+ *         SML_ERR_OK if next command was handled successfully,\n
+ *         SML_ERR_NEED_MORE_DATA if partial and the command is incomplete
  */
-static Ret_t mgrProcessNextCommand(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo)
+static Ret_t mgrProcessNextCommand(InstanceID_t id, InstanceInfoPtr_t pInstanceInfo, Boolean_t partial)
 {
 
   /* --- Definitions --- */
@@ -300,7 +362,20 @@ static Ret_t mgrProcessNextCommand(InstanceID_t id, InstanceInfoPtr_t pInstanceI
 
 
   /* --- Parse next Command --- */
-  rc = xltDecNext(pInstanceInfo->decoderState, pCurrentReadPosition+usedSize, &pCurrentReadPosition, &cmdType, &pContent);
+  if (partial) {
+    // remember where the command starts in case it is not yet complete
+    rc = xltDecMark(pInstanceInfo->decoderState);
+    if (rc==SML_ERR_OK) {
+      rc = xltDecNext(pInstanceInfo->decoderState, pCurrentReadPosition+usedSize, &pCurrentReadPosition, &cmdType, &pContent);
+      if (rc!=SML_ERR_OK && xltDecRewind(pInstanceInfo->decoderState)==SML_ERR_OK) {
+        // command not yet complete, retry it when more data has arrived
+        smlUnlockReadBuffer(id, (MemSize_t)0);
+        return SML_ERR_NEED_MORE_DATA;
+      }
+    }
+  }
+  else
+    rc = xltDecNext(pInstanceInfo->decoderState, pCurrentReadPosition+usedSize, &pCurrentReadPosition, &cmdType, &pContent);
 
   if (rc!=SML_ERR_OK) {
     // abort, unlock the buffer again without changing it's current position
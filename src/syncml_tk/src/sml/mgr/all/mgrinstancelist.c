@@ -82,11 +82,46 @@ Ret_t removeInfo(InstanceID_t id);
 
 
 /* Private function prototypes */
+static Short_t findSlot(InstanceID_t id);
 
 
 
 
 
+/*************************************************************************
+ *  Private functions
+ *************************************************************************/
+
+
+/**
+ * Searches the instance table slot holding the instance with the given ID.
+ * There can't be more instances than workspace buffers, so the table has
+ * MAX_WSM_BUFFERS slots and is searched starting at the slot the ID hashes to
+ * (which is a direct hit for the usual small sequential workspace handles).
+ * Must be called with the toolkit locked, as other instances' slots may be
+ * cleared concurrently.
+ *
+ * @param id (IN)
+ *        ID of the instance to find, or 0 to find a free slot
+ * @return index of the slot\n
+ *         -1, if not found
+ */
+static Short_t findSlot(InstanceID_t id)
+{
+  InstanceInfoPtr_t *_table = mgrGetSyncMLAnchor()->instanceTable;
+  Short_t _start = (Short_t)((unsigned short)id % MAX_WSM_BUFFERS);
+  Short_t _i = _start;
+
+  do {
+    InstanceInfoPtr_t _pInfo = _table[_i];
+    if (id==0 ? _pInfo==NULL : (_pInfo!=NULL && _pInfo->id==id))
+      return _i;
+    _i = (Short_t)((_i+1) % MAX_WSM_BUFFERS);
+  } while (_i!=_start);
+  return -1;
+}
+
+
 
 /*************************************************************************
  *  SyncML internal functions
@@ -107,8 +142,17 @@ Ret_t addInfo(InstanceInfoPtr_t pInfo)
   if (pInfo!=NULL)
     {
     InstanceInfoPtr_t _pTmp;
+    Short_t _slot;
 
     LOCKTOOLKIT("addInfo");
+    /* Enter into the lookup table first (ID 0 finds a free slot starting at the hashed one) */
+    if ((_slot=findSlot(pInfo->id))<0) _slot=findSlot(0);
+    if (_slot<0) {
+      RELEASETOOLKIT("addInfo");
+      return SML_ERR_WSM_BUF_TABLE_FULL;
+    }
+    mgrGetSyncMLAnchor()->instanceTable[_slot]=pInfo;
+
     /* Remember old beginning of the list */
     _pTmp=mgrGetInstanceListAnchor();
 
@@ -130,7 +174,7 @@ Ret_t addInfo(InstanceInfoPtr_t pInfo)
 
 
 /**
- * Searches an element with the given InstanceID in the list
+ * Searches an element with the given InstanceID in the lookup table
  *
  * @param id (IN)
  *        ID of the InstanceInfo structure to be retrieved
@@ -140,19 +184,15 @@ Ret_t addInfo(InstanceInfoPtr_t pInfo)
 InstanceInfoPtr_t findInfo(InstanceID_t id)
 {
 
-  InstanceInfoPtr_t _pTmp;                // A helper pointer
+  Short_t _slot;
+  InstanceInfoPtr_t _pInfo;
 
-  /* go through the list until end */
+  /* findSlot() probes slots of other instances, which removeInfo() may clear meanwhile */
   LOCKTOOLKIT("findInfo");
-  for (_pTmp=mgrGetInstanceListAnchor(); _pTmp!=NULL; _pTmp=_pTmp->nextInfo)
-  {
-    if (_pTmp->id == id) {
-      RELEASETOOLKIT("findInfo");
-      return _pTmp;                       // STOP, we've found the info, return!
-    }
-  }
+  _slot=findSlot(id);
+  _pInfo = _slot<0 ? NULL : mgrGetSyncMLAnchor()->instanceTable[_slot];
   RELEASETOOLKIT("findInfo");
-  return NULL;                            // Info was not found, return NULL
+  return _pInfo;
 
 }
 
@@ -173,9 +213,14 @@ Ret_t removeInfo(InstanceID_t id)
 
   InstanceInfoPtr_t _pTmp;               // A helper pointer
   InstanceInfoPtr_t _pRemember;          // A helper pointer
+  Short_t _slot;                         // lookup table slot of the instance
 
 
   LOCKTOOLKIT("removeInfo");
+  /* Remove from lookup table */
+  if ((_slot=findSlot(id))>=0)
+    mgrGetSyncMLAnchor()->instanceTable[_slot]=NULL;
+
   /* Remember current anchor */
   _pRemember=mgrGetInstanceListAnchor();
 
@@ -81,6 +81,7 @@ SML_API Ret_t smlLockReadBuffer(InstanceID_t id, MemPtr_t *pReadPosition, MemSiz
 SML_API Ret_t smlUnlockReadBuffer(InstanceID_t id, MemSize_t processedBytes);
 #ifdef NOWSM
 SML_API Ret_t smlSetMaxOutgoingSize(InstanceID_t id, MemSize_t maxOutgoingSize);
+SML_API Ret_t smlSetWBXMLStringTable(InstanceID_t id, Boolean_t enable);
 SML_API Ret_t smlSetOutgoingBegin(InstanceID_t id);
 #endif
 SML_API Ret_t smlLockWriteBuffer(InstanceID_t id, MemPtr_t *pWritePosition, MemSize_t *freeSize);
@@ -212,6 +213,7 @@ SML_API Ret_t smlInitInstance(SmlCallbacksCPtr_t pCallbacks, SmlInstanceOptionsP
   // create a instance buffer
   pInstanceInfo->instanceBufSiz=pOptions->workspaceSize; // get requested size for the buffer
   pInstanceInfo->maxOutgoingSize=pOptions->maxOutgoingSize; // set max outgoing message size
+  pInstanceInfo->wbxmlStringTable=0; // plain inline strings unless enabled with smlSetWBXMLStringTable()
   pInstanceInfo->instanceBuffer=smlLibMalloc(pInstanceInfo->instanceBufSiz);
   if (pInstanceInfo->instanceBuffer==NULL)
     return SML_ERR_NOT_ENOUGH_SPACE;
@@ -691,6 +693,31 @@ SML_API Ret_t smlSetMaxOutgoingSize(InstanceID_t id, MemSize_t maxOutgoingSize)
 }
 
 
+/**
+ * Enable or disable string table compression of outgoing WBXML messages.
+ * When enabled, smlEndMessage moves strings which occur repeatedly in the
+ * message (LocURIs, meta types, ...) into the WBXML string table.
+ *
+ * @param id (IN)
+ *        ID of the Instance
+ * @param enable (IN)
+ *        set to compress outgoing WBXML messages
+ * @return Return value,\n
+ *         SML_ERR_OK if successful
+ */
+SML_API Ret_t smlSetWBXMLStringTable(InstanceID_t id, Boolean_t enable)
+{
+  InstanceInfoPtr_t pInstanceInfo;
+
+  pInstanceInfo = (InstanceInfoPtr_t)id; // ID is the instance info pointer
+  if (pInstanceInfo==NULL) return SML_ERR_MGR_INVALID_INSTANCE_INFO;
+
+  pInstanceInfo->wbxmlStringTable = enable;
+
+  return SML_ERR_OK;
+}
+
+
 /**
  * Marks the current write pointer position as beginning of a new outgoing
  * message. This is used to track outgoing message size while writing it
@@ -101,6 +101,7 @@ typedef struct instance_info_s {
   MemPtr_t                 outgoingMsgStart;  /**< set whenever a smlStartMessage is issued, NULL when invalid */
   MemPtr_t                 incomingMsgStart;  /**< set whenever mgrProcessStartMessage starts reading a message, NULL when invalid */
   MemSize_t                maxOutgoingSize;   /**< if<>0, smlXXXCmd will not modify the buffer when there's not enough room */
+  Boolean_t                wbxmlStringTable;  /**< if set, smlEndMessage moves repeated strings of WBXML messages into the string table */
   #endif
   InstanceStatus_t         status;            /**< current internal state of instance */
   SmlCallbacksPtr_t        callbacks;         /**< Defined callback refererences for this Instance */
@@ -135,6 +136,9 @@ typedef struct tokeninfo_s {
  */
 typedef struct syncml_info_s {
   InstanceInfoPtr_t        instanceListAnchor;/**< Anchor of the global list of known SyncML instances */
+  #ifndef __SML_LITE__
+  InstanceInfoPtr_t        instanceTable[MAX_WSM_BUFFERS]; /**< known SyncML instances by hashed ID, for findInfo() */
+  #endif
   SmlOptionsPtr_t          syncmlOptions;     /**< Options valid for this SyncML Process */
   WsmGlobalsPtr_t          wsmGlobals;        /**< Workspace global variables */
   TokenInfoPtr_t           tokTbl;
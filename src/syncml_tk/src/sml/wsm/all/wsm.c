@@ -77,11 +77,9 @@
 
 /* defines for convient use of global anchor */
 
-#define wsmRet          (mgrGetSyncMLAnchor())->wsmGlobals->wsmRet
 #define initWasCalled   (mgrGetSyncMLAnchor())->wsmGlobals->initWasCalled
 #define maxWsmAvailMem     (mgrGetSyncMLAnchor())->syncmlOptions->maxWorkspaceAvailMem
 #define wsmBuf          (mgrGetSyncMLAnchor())->wsmGlobals->wsmBuf
-#define wsmIndex        (mgrGetSyncMLAnchor())->wsmGlobals->wsmIndex
 
 void createDataStructs(void);
 
@@ -91,9 +89,7 @@ void createDataStructs() {
       return;
     }
     smlLibMemset((mgrGetSyncMLAnchor())->wsmGlobals, 0, sizeof(WsmGlobals_t));
-    wsmRet = 0;
     initWasCalled = 0;
-    wsmIndex = 0;
 #ifdef __ANSI_C__
     (mgrGetSyncMLAnchor())->wsmGlobals->wsmSm = NULL;
 #endif
@@ -151,17 +147,11 @@ static Short_t getNextFreeEntry() {
 static Short_t lookup(MemHandle_t memH) {
   Short_t i;
 
-  // first check cache
-  if ( wsmBuf[wsmIndex].memH == memH )
-    return wsmIndex;
-
   // search through buffer
   for ( i=0; (i < MAX_WSM_BUFFERS) && (wsmBuf[i].memH != memH); ++i )
     ;
-  if ( i < MAX_WSM_BUFFERS ) {
-    wsmIndex = i;
+  if ( i < MAX_WSM_BUFFERS )
     return i;
-  }
   else {
     return -1;     // memH not found
   }
@@ -175,11 +165,6 @@ static Short_t lookup(MemHandle_t memH) {
 static MemHandle_t nameToHandle(String_t name) {
   int i;
 
-  // first check cache
-  if ( (wsmBuf[wsmIndex].bufName != NULL) &&
-       (smlLibStrcmp(wsmBuf[wsmIndex].bufName, name) == 0) )
-    return wsmBuf[wsmIndex].memH;
-
   // search through buffer
   for ( i=0; ((i < MAX_WSM_BUFFERS) &&
         (wsmBuf[i].bufName == NULL ? 1 :
@@ -199,19 +184,21 @@ static MemHandle_t nameToHandle(String_t name) {
  * Return -1, if handle not found.
  */
 static Short_t deleteBufferHandle(MemHandle_t memH) {
-  if ( (wsmIndex = lookup(memH)) < 0 )
+  Short_t idx;
+  if ( (idx = lookup(memH)) < 0 )
     return -1;  // handle not found
 
   // reset the values
-  wsmBuf[wsmIndex].memH = WSM_MEMH_UNUSED;
-  wsmBuf[wsmIndex].pFirstFree = NULL;
-  wsmBuf[wsmIndex].pFirstData = NULL;
-  wsmBuf[wsmIndex].size      = 0;
-  wsmBuf[wsmIndex].usedBytes = 0;
-  //wsmBuf[wsmIndex].flags     = ~WSM_VALID_F;
-  wsmBuf[wsmIndex].flags     = ((Byte_t) ~WSM_VALID_F);
-  smlLibFree(wsmBuf[wsmIndex].bufName);   // free mem
-  wsmBuf[wsmIndex].bufName   = NULL;
+  wsmBuf[idx].memH = WSM_MEMH_UNUSED;
+  wsmBuf[idx].pFirstFree = NULL;
+  wsmBuf[idx].pFirstData = NULL;
+  wsmBuf[idx].size      = 0;
+  wsmBuf[idx].usedBytes = 0;
+  wsmBuf[idx].dataOffset = 0;
+  //wsmBuf[idx].flags     = ~WSM_VALID_F;
+  wsmBuf[idx].flags     = ((Byte_t) ~WSM_VALID_F);
+  smlLibFree(wsmBuf[idx].bufName);   // free mem
+  wsmBuf[idx].bufName   = NULL;
 
   return 0;
 }
@@ -224,24 +211,26 @@ static Short_t deleteBufferHandle(MemHandle_t memH) {
  * or -1 if table is full
  */
 static Short_t resetBufferGlobals(MemHandle_t memH) {
-  if ( (wsmIndex = lookup(memH)) < 0 ) {
+  Short_t idx;
+  if ( (idx = lookup(memH)) < 0 ) {
     // create new one
-    if ( (wsmIndex = getNextFreeEntry()) < 0 )
+    if ( (idx = getNextFreeEntry()) < 0 )
       return -1;  // buffer table full
-    wsmBuf[wsmIndex].memH = memH;
+    wsmBuf[idx].memH = memH;
   } else
     // use existing one, which has to be reset prior usage
-    smlLibFree(wsmBuf[wsmIndex].bufName);   // free mem
+    smlLibFree(wsmBuf[idx].bufName);   // free mem
 
   // reset the values
-  wsmBuf[wsmIndex].pFirstFree = NULL;
-  wsmBuf[wsmIndex].pFirstData = NULL;
-  wsmBuf[wsmIndex].size      = 0;
-  wsmBuf[wsmIndex].usedBytes = 0;
-  wsmBuf[wsmIndex].flags     = WSM_VALID_F;
-  wsmBuf[wsmIndex].bufName   = NULL;
-
-  return wsmIndex;
+  wsmBuf[idx].pFirstFree = NULL;
+  wsmBuf[idx].pFirstData = NULL;
+  wsmBuf[idx].size      = 0;
+  wsmBuf[idx].usedBytes = 0;
+  wsmBuf[idx].dataOffset = 0;
+  wsmBuf[idx].flags     = WSM_VALID_F;
+  wsmBuf[idx].bufName   = NULL;
+
+  return idx;
 }
 
 
@@ -314,10 +303,9 @@ Ret_t wsmInit (const WsmOptions_t *wsmOpts) {
   // init resources
   for ( i=0; i < MAX_WSM_BUFFERS; ++i )
     wsmBuf[i].memH = WSM_MEMH_UNUSED;
-  wsmIndex = 0;
   initWasCalled = (Byte_t) 1;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -345,6 +333,8 @@ Ret_t wsmInit (const WsmOptions_t *wsmOpts) {
  * @see wsmDestroy
  */
 Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
+  Short_t idx;
+  Ret_t ret;
 
   *wsmH = 0;    // 0 in case of error
 
@@ -353,7 +343,7 @@ Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
 
   // check buffer space
   if ( getNextFreeEntry() == -1 ) {
-    return wsmRet=SML_ERR_WSM_BUF_TABLE_FULL;
+    return SML_ERR_WSM_BUF_TABLE_FULL;
   }
   // check for maxMemAvailable
   if ( ! isMemAvailable(bufSize) ) {
@@ -361,38 +351,38 @@ Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
   }
 
   // create buffer
-  if ( (wsmRet = smCreate(bufName, bufSize, wsmH)) != SML_ERR_OK ) {
-    if ( wsmRet == SML_ERR_WRONG_USAGE ) {    // buffer already exists
+  if ( (ret = smCreate(bufName, bufSize, wsmH)) != SML_ERR_OK ) {
+    if ( ret == SML_ERR_WRONG_USAGE ) {    // buffer already exists
       // resize existing buffer
       // open buffer
-      if ( (wsmRet = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
-        return wsmRet=SML_ERR_NOT_ENOUGH_SPACE;
+      if ( (ret = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
+        return SML_ERR_NOT_ENOUGH_SPACE;
       }
       // resize buffer
-      if ( (wsmRet = smSetSize(*wsmH, bufSize)) != SML_ERR_OK ) {
-        return wsmRet=SML_ERR_NOT_ENOUGH_SPACE;
+      if ( (ret = smSetSize(*wsmH, bufSize)) != SML_ERR_OK ) {
+        return SML_ERR_NOT_ENOUGH_SPACE;
       }
     }
     else {
-      return wsmRet;
+      return ret;
     }
   }
 
   // reset buffer vars
-  wsmIndex = resetBufferGlobals(*wsmH);
+  idx = resetBufferGlobals(*wsmH);
 
   // set buffer vars
-  wsmBuf[wsmIndex].size = bufSize;
-  wsmBuf[wsmIndex].bufName = smlLibStrdup(bufName);
+  wsmBuf[idx].size = bufSize;
+  wsmBuf[idx].bufName = smlLibStrdup(bufName);
 
-   if (wsmBuf[wsmIndex].bufName == NULL) {
+   if (wsmBuf[idx].bufName == NULL) {
     smClose(*wsmH);
     smDestroy(bufName);
-    return wsmRet=SML_ERR_NOT_ENOUGH_SPACE;
+    return SML_ERR_NOT_ENOUGH_SPACE;
    }
 
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -411,20 +401,22 @@ Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
  * @see wsmClose
  */
 Ret_t wsmOpen (String_t bufName, MemHandle_t *wsmH){
+  Short_t idx;
+  Ret_t ret;
 
   // open buffer
-  if ( (wsmRet = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
+    return ret;
   }
 
   // reset buffer vars
-  wsmIndex = resetBufferGlobals(*wsmH);
+  idx = resetBufferGlobals(*wsmH);
 
   // set buf vars
-  wsmRet = smGetSize(*wsmH, &wsmBuf[wsmIndex].size);
-  wsmBuf[wsmIndex].bufName = smlLibStrdup(bufName);
+  smGetSize(*wsmH, &wsmBuf[idx].size);
+  wsmBuf[idx].bufName = smlLibStrdup(bufName);
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -444,19 +436,20 @@ Ret_t wsmOpen (String_t bufName, MemHandle_t *wsmH){
  * @see wsmOpen
  */
 Ret_t wsmClose (MemHandle_t wsmH) {
+  Ret_t ret;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
 
   // close handle
-  if ( (wsmRet = smClose(wsmH)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = smClose(wsmH)) != SML_ERR_OK ) {
+    return ret;
   }
-  wsmRet = deleteBufferHandle(wsmH);
+  deleteBufferHandle(wsmH);
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -478,18 +471,19 @@ Ret_t wsmClose (MemHandle_t wsmH) {
  * @see wsmCreate
  */
 Ret_t wsmDestroy (String_t bufName) {
+  Ret_t ret;
 
   // free resources
-  if ( (wsmRet = wsmClose(nameToHandle(bufName))) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = wsmClose(nameToHandle(bufName))) != SML_ERR_OK ) {
+    return ret;
   }
 
   // free buffer
-  if ( (wsmRet = smDestroy(bufName)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = smDestroy(bufName)) != SML_ERR_OK ) {
+    return ret;
   }
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -529,7 +523,8 @@ Ret_t wsmTerminate (void) {
  *      - noBytes <= wsmGetUsedSize
  * @post
  *       - noBytes starting at wsmGetPtr() position are deleted;
- *       - remaining bytes are copied to wsmGetPtr(SML_FIRST_FREE_ITEM) position
+ *       - the read position advances past them (remaining bytes are
+ *         moved to the buffer start only by the next write lock)
  *       - wsmGetUsedSize -= noBytes
  *       - wsmGetFreeSize += noBytes
  * @param wsmH (IN)
@@ -544,35 +539,40 @@ Ret_t wsmTerminate (void) {
  * @see wsmGetFreeSize
  */
 Ret_t wsmProcessedBytes (MemHandle_t wsmH, MemSize_t noBytes) {
+  Short_t idx;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is unlocked
   if ( ! isLockedMemH(wsmH) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
-  wsmIndex = lookup(wsmH);
+  idx = lookup(wsmH);
 
-  if ( noBytes > wsmBuf[wsmIndex].usedBytes ) {
-    return wsmRet=SML_ERR_INVALID_SIZE;
+  if ( noBytes > wsmBuf[idx].usedBytes ) {
+    return SML_ERR_INVALID_SIZE;
   }
 
   // adapt usedSize
-  wsmBuf[wsmIndex].usedBytes -= noBytes;
-
-  // move memory
-  // check return ?????
-  smlLibMemmove(wsmBuf[wsmIndex].pFirstData,
-    (wsmBuf[wsmIndex].pFirstData + noBytes),
-    wsmBuf[wsmIndex].usedBytes);
-
-  // move pFirstFree
-  wsmBuf[wsmIndex].pFirstFree -= noBytes;
+  wsmBuf[idx].usedBytes -= noBytes;
+
+  // just advance the read cursor, remaining data is only moved to the
+  // front of the buffer when space for writing is requested (wsmLockH)
+  if ( wsmBuf[idx].usedBytes == 0 ) {
+    // buffer is empty now, restart at beginning
+    wsmBuf[idx].pFirstData -= wsmBuf[idx].dataOffset;
+    wsmBuf[idx].pFirstFree = wsmBuf[idx].pFirstData;
+    wsmBuf[idx].dataOffset = 0;
+  }
+  else {
+    wsmBuf[idx].pFirstData += noBytes;
+    wsmBuf[idx].dataOffset += noBytes;
+  }
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -606,39 +606,49 @@ Ret_t wsmProcessedBytes (MemHandle_t wsmH, MemSize_t noBytes) {
  */
 Ret_t wsmLockH (MemHandle_t wsmH, SmlBufPtrPos_t requestedPos,
     MemPtr_t *pMem) {
+  Short_t idx;
+  Ret_t ret;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is locked
   if ( isLockedMemH(wsmH) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
   // lock
-  if ( (wsmRet = smLock(wsmH, pMem)) != SML_ERR_OK ) {
-    return wsmRet=SML_ERR_UNSPECIFIC;
+  if ( (ret = smLock(wsmH, pMem)) != SML_ERR_OK ) {
+    return SML_ERR_UNSPECIFIC;
+  }
+
+  idx = lookup(wsmH);
+  // compact before writing, such that all free space is contiguous at the end
+  if ( requestedPos == SML_FIRST_FREE_ITEM && wsmBuf[idx].dataOffset > 0 ) {
+    smlLibMemmove(*pMem,
+      (*pMem + wsmBuf[idx].dataOffset),
+      wsmBuf[idx].usedBytes);
+    wsmBuf[idx].dataOffset = 0;
   }
 
   // set local pointers
-  wsmIndex = lookup(wsmH);
-  wsmBuf[wsmIndex].pFirstData = *pMem;
-  wsmBuf[wsmIndex].pFirstFree = *pMem + wsmBuf[wsmIndex].usedBytes;
-  wsmBuf[wsmIndex].flags |= WSM_LOCKED_F;
+  wsmBuf[idx].pFirstData = *pMem + wsmBuf[idx].dataOffset;
+  wsmBuf[idx].pFirstFree = wsmBuf[idx].pFirstData + wsmBuf[idx].usedBytes;
+  wsmBuf[idx].flags |= WSM_LOCKED_F;
 
   switch (requestedPos) {
   case SML_FIRST_DATA_ITEM:
-    *pMem = wsmBuf[wsmIndex].pFirstData;
+    *pMem = wsmBuf[idx].pFirstData;
     break;
   case SML_FIRST_FREE_ITEM:
-    *pMem = wsmBuf[wsmIndex].pFirstFree;
+    *pMem = wsmBuf[idx].pFirstFree;
     break;
   default:
-    return wsmRet=SML_ERR_UNSPECIFIC;
+    return SML_ERR_UNSPECIFIC;
   }
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -657,17 +667,18 @@ Ret_t wsmLockH (MemHandle_t wsmH, SmlBufPtrPos_t requestedPos,
  * @see wsmGetUsedSize, wsmProcessedBytes
  */
 Ret_t wsmGetFreeSize(MemHandle_t wsmH, MemSize_t *freeSize) {
+  Short_t idx;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
 
-  wsmIndex = lookup(wsmH);
+  idx = lookup(wsmH);
 
-  *freeSize = wsmBuf[wsmIndex].size - wsmBuf[wsmIndex].usedBytes;
+  *freeSize = wsmBuf[idx].size - wsmBuf[idx].usedBytes;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -686,17 +697,18 @@ Ret_t wsmGetFreeSize(MemHandle_t wsmH, MemSize_t *freeSize) {
  * @see wsmGetFreeSize, wsmSetUsedSize
  */
 Ret_t wsmGetUsedSize(MemHandle_t wsmH, MemSize_t *usedSize) {
+  Short_t idx;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
 
-  wsmIndex = lookup(wsmH);
+  idx = lookup(wsmH);
 
-  *usedSize = wsmBuf[wsmIndex].usedBytes;
+  *usedSize = wsmBuf[idx].usedBytes;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -718,28 +730,30 @@ Ret_t wsmGetUsedSize(MemHandle_t wsmH, MemSize_t *usedSize) {
  * @see wsmLockH
  */
 Ret_t wsmUnlockH (MemHandle_t wsmH) {
+  Short_t idx;
+  Ret_t ret;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is already unlocked
   if ( ! isLockedMemH(wsmH) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
   // unlock
-  if ( (wsmRet = smUnlock(wsmH)) != SML_ERR_OK ) {
-    return wsmRet=SML_ERR_UNSPECIFIC;
+  if ( (ret = smUnlock(wsmH)) != SML_ERR_OK ) {
+    return SML_ERR_UNSPECIFIC;
   }
 
   // set local pointers
-  wsmIndex = lookup(wsmH);
-  wsmBuf[wsmIndex].pFirstData = NULL;
-  wsmBuf[wsmIndex].pFirstFree = NULL;
-  wsmBuf[wsmIndex].flags &= ~WSM_LOCKED_F;
+  idx = lookup(wsmH);
+  wsmBuf[idx].pFirstData = NULL;
+  wsmBuf[idx].pFirstFree = NULL;
+  wsmBuf[idx].flags &= ~WSM_LOCKED_F;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -765,31 +779,32 @@ Ret_t wsmUnlockH (MemHandle_t wsmH) {
  * @see wsmGetUsedSize
  */
 Ret_t wsmSetUsedSize (MemHandle_t wsmH, MemSize_t usedSize) {
+  Short_t idx;
 
   // check if handle is invalid
   if ( ! isValidMemH(wsmH) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is unlocked
   if ( ! isLockedMemH(wsmH) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
-  wsmIndex = lookup(wsmH);
+  idx = lookup(wsmH);
 
   // usedSize > freeSize?
   if ( usedSize >
-       (wsmBuf[wsmIndex].size - wsmBuf[wsmIndex].usedBytes) ) {
-    return wsmRet=SML_ERR_INVALID_SIZE;
+       (wsmBuf[idx].size - wsmBuf[idx].dataOffset - wsmBuf[idx].usedBytes) ) {
+    return SML_ERR_INVALID_SIZE;
   }
 
   // adapt usedSize
-  wsmBuf[wsmIndex].usedBytes += usedSize;
+  wsmBuf[idx].usedBytes += usedSize;
 
   // move pFirstFree
-  wsmBuf[wsmIndex].pFirstFree += usedSize;
+  wsmBuf[idx].pFirstFree += usedSize;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 /**
@@ -803,11 +818,13 @@ Ret_t wsmSetUsedSize (MemHandle_t wsmH, MemSize_t usedSize) {
  *         - SML_ERR_OK, if O.K.
  */
 Ret_t wsmReset (MemHandle_t wsmH) {
+  Short_t idx;
 
-  wsmIndex = lookup(wsmH);
-  wsmBuf[wsmIndex].pFirstFree = wsmBuf[wsmIndex].pFirstFree - wsmBuf[wsmIndex].usedBytes ;
-  wsmBuf[wsmIndex].pFirstData = wsmBuf[wsmIndex].pFirstFree;
-  wsmBuf[wsmIndex].usedBytes = 0;
+  idx = lookup(wsmH);
+  wsmBuf[idx].pFirstFree = wsmBuf[idx].pFirstFree - wsmBuf[idx].usedBytes - wsmBuf[idx].dataOffset;
+  wsmBuf[idx].pFirstData = wsmBuf[idx].pFirstFree;
+  wsmBuf[idx].usedBytes = 0;
+  wsmBuf[idx].dataOffset = 0;
 
   return SML_ERR_OK;
 }
@@ -822,11 +839,9 @@ Ret_t wsmReset (MemHandle_t wsmH) {
 /* =========== */
 
 /* defines for convient use of global anchor */
-#define wsmRet          (mgrGetSyncMLAnchor())->wsmGlobals->wsmRet
 #define initWasCalled   (mgrGetSyncMLAnchor())->wsmGlobals->initWasCalled
 #define maxWsmAvailMem  (mgrGetSyncMLAnchor())->syncmlOptions->maxWorkspaceAvailMem
 #define wsmBuf          (mgrGetSyncMLAnchor())->wsmGlobals->wsmBuf
-#define wsmIndex        (mgrGetSyncMLAnchor())->wsmGlobals->wsmIndex
 
 void createDataStructs(void);
 
@@ -835,9 +850,7 @@ void createDataStructs() {
     if ( ((mgrGetSyncMLAnchor())->wsmGlobals=smlLibMalloc(sizeof(WsmGlobals_t))) == 0 ) {
       return;
     }
-    wsmRet = 0;
     initWasCalled = 0;
-    wsmIndex = 0;
 #ifdef __ANSI_C__
     (mgrGetSyncMLAnchor())->wsmGlobals->wsmSm = NULL;
 #endif
@@ -881,6 +894,7 @@ static Short_t deleteBufferHandle(MemHandle_t memH) {
   wsmBuf[0].pFirstData = NULL;
   wsmBuf[0].size      = 0;
   wsmBuf[0].usedBytes = 0;
+  wsmBuf[0].dataOffset = 0;
   wsmBuf[0].flags     = ~WSM_VALID_F;
   smlLibFree(wsmBuf[0].bufName);   // free mem
   wsmBuf[0].bufName   = NULL;
@@ -908,6 +922,7 @@ static Short_t resetBufferGlobals(MemHandle_t memH) {
   wsmBuf[0].pFirstData = NULL;
   wsmBuf[0].size      = 0;
   wsmBuf[0].usedBytes = 0;
+  wsmBuf[0].dataOffset = 0;
   wsmBuf[0].flags     = WSM_VALID_F;
   wsmBuf[0].bufName   = NULL;
 
@@ -953,14 +968,14 @@ Ret_t wsmInit (const WsmOptions_t *wsmOpts) {
 
   // init resources
   wsmBuf[0].memH = WSM_MEMH_UNUSED;
-  wsmIndex = 0;
   initWasCalled = (Byte_t) 1;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
+  Ret_t ret;
 
   *wsmH = 0;    // 0 in case of error
 
@@ -969,7 +984,7 @@ Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
 
   // check buffer space
   if ( wsmBuf[0].memH != WSM_MEMH_UNUSED ) {
-    return wsmRet=SML_ERR_WSM_BUF_TABLE_FULL;
+    return SML_ERR_WSM_BUF_TABLE_FULL;
   }
   // check for maxMemAvailable
   if ( ! isMemAvailable(bufSize) ) {
@@ -977,20 +992,20 @@ Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
   }
 
   // create buffer
-  if ( (wsmRet = smCreate(bufName, bufSize, wsmH)) != SML_ERR_OK ) {
-    if ( wsmRet == SML_ERR_WRONG_USAGE ) {    // buffer already exists
+  if ( (ret = smCreate(bufName, bufSize, wsmH)) != SML_ERR_OK ) {
+    if ( ret == SML_ERR_WRONG_USAGE ) {    // buffer already exists
       // resize existing buffer
       // open buffer
-      if ( (wsmRet = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
-  return wsmRet=SML_ERR_NOT_ENOUGH_SPACE;
+      if ( (ret = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
+  return SML_ERR_NOT_ENOUGH_SPACE;
       }
       // resize buffer
-      if ( (wsmRet = smSetSize(*wsmH, bufSize)) != SML_ERR_OK ) {
-  return wsmRet=SML_ERR_NOT_ENOUGH_SPACE;
+      if ( (ret = smSetSize(*wsmH, bufSize)) != SML_ERR_OK ) {
+  return SML_ERR_NOT_ENOUGH_SPACE;
       }
     }
     else {
-      return wsmRet;
+      return ret;
     }
   }
 
@@ -1001,59 +1016,62 @@ Ret_t wsmCreate (String_t bufName, MemSize_t bufSize, MemHandle_t *wsmH) {
   wsmBuf[0].size = bufSize;
   wsmBuf[0].bufName = smlLibStrdup(bufName);
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmOpen (String_t bufName, MemHandle_t *wsmH){
+  Ret_t ret;
 
   // open buffer
-  if ( (wsmRet = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = smOpen(bufName, wsmH)) != SML_ERR_OK ) {
+    return ret;
   }
 
   // reset buffer vars
   resetBufferGlobals(*wsmH);
 
   // set buf vars
-  wsmRet = smGetSize(*wsmH, &wsmBuf[0].size);
+  smGetSize(*wsmH, &wsmBuf[0].size);
   wsmBuf[0].bufName = smlLibStrdup(bufName);
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmClose (MemHandle_t wsmH) {
+  Ret_t ret;
 
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
 
   // close handle
-  if ( (wsmRet = smClose(wsmH)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = smClose(wsmH)) != SML_ERR_OK ) {
+    return ret;
   }
-  wsmRet = deleteBufferHandle(wsmH);
+  deleteBufferHandle(wsmH);
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmDestroy (String_t bufName) {
+  Ret_t ret;
 
   // free resources
-  if ( (wsmRet = wsmClose(wsmBuf[0].memH)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = wsmClose(wsmBuf[0].memH)) != SML_ERR_OK ) {
+    return ret;
   }
 
   // free buffer
-  if ( (wsmRet = smDestroy(bufName)) != SML_ERR_OK ) {
-    return wsmRet;
+  if ( (ret = smDestroy(bufName)) != SML_ERR_OK ) {
+    return ret;
   }
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -1080,56 +1098,69 @@ Ret_t wsmProcessedBytes (MemHandle_t wsmH, MemSize_t noBytes) {
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is unlocked
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_LOCKED_F)) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
   if ( noBytes > wsmBuf[0].usedBytes ) {
-    return wsmRet=SML_ERR_INVALID_SIZE;
+    return SML_ERR_INVALID_SIZE;
   }
 
   // adapt usedSize
   wsmBuf[0].usedBytes -= noBytes;
 
-  // move memory
-  // check return ?????
-  smlLibMemmove(wsmBuf[0].pFirstData,
-    (wsmBuf[0].pFirstData + noBytes),
-    wsmBuf[0].usedBytes);
-
-  // move pFirstFree
-  wsmBuf[0].pFirstFree -= noBytes;
+  // just advance the read cursor, remaining data is only moved to the
+  // front of the buffer when space for writing is requested (wsmLockH)
+  if ( wsmBuf[0].usedBytes == 0 ) {
+    // buffer is empty now, restart at beginning
+    wsmBuf[0].pFirstData -= wsmBuf[0].dataOffset;
+    wsmBuf[0].pFirstFree = wsmBuf[0].pFirstData;
+    wsmBuf[0].dataOffset = 0;
+  }
+  else {
+    wsmBuf[0].pFirstData += noBytes;
+    wsmBuf[0].dataOffset += noBytes;
+  }
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmLockH (MemHandle_t wsmH, SmlBufPtrPos_t requestedPos,
     MemPtr_t *pMem) {
+  Ret_t ret;
 
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is locked
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_LOCKED_F)) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
   // lock
-  if ( (wsmRet = smLock(wsmH, pMem)) != SML_ERR_OK ) {
-    return wsmRet=SML_ERR_UNSPECIFIC;
+  if ( (ret = smLock(wsmH, pMem)) != SML_ERR_OK ) {
+    return SML_ERR_UNSPECIFIC;
+  }
+
+  // compact before writing, such that all free space is contiguous at the end
+  if ( requestedPos == SML_FIRST_FREE_ITEM && wsmBuf[0].dataOffset > 0 ) {
+    smlLibMemmove(*pMem,
+      (*pMem + wsmBuf[0].dataOffset),
+      wsmBuf[0].usedBytes);
+    wsmBuf[0].dataOffset = 0;
   }
 
   // set local pointers
-  wsmBuf[0].pFirstData = *pMem;
-  wsmBuf[0].pFirstFree = *pMem + wsmBuf[0].usedBytes;
+  wsmBuf[0].pFirstData = *pMem + wsmBuf[0].dataOffset;
+  wsmBuf[0].pFirstFree = wsmBuf[0].pFirstData + wsmBuf[0].usedBytes;
   wsmBuf[0].flags |= WSM_LOCKED_F;
 
   switch (requestedPos) {
@@ -1140,10 +1171,10 @@ Ret_t wsmLockH (MemHandle_t wsmH, SmlBufPtrPos_t requestedPos,
     *pMem = wsmBuf[0].pFirstFree;
     break;
   default:
-    return wsmRet=SML_ERR_UNSPECIFIC;
+    return SML_ERR_UNSPECIFIC;
   }
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -1152,12 +1183,12 @@ Ret_t wsmGetFreeSize(MemHandle_t wsmH, MemSize_t *freeSize) {
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
 
   *freeSize = wsmBuf[0].size - wsmBuf[0].usedBytes;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -1166,31 +1197,32 @@ Ret_t wsmGetUsedSize(MemHandle_t wsmH, MemSize_t *usedSize) {
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
 
   *usedSize = wsmBuf[0].usedBytes;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmUnlockH (MemHandle_t wsmH) {
+  Ret_t ret;
 
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is already unlocked
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_LOCKED_F)) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
   // unlock
-  if ( (wsmRet = smUnlock(wsmH)) != SML_ERR_OK ) {
-    return wsmRet=SML_ERR_UNSPECIFIC;
+  if ( (ret = smUnlock(wsmH)) != SML_ERR_OK ) {
+    return SML_ERR_UNSPECIFIC;
   }
 
   // set local pointers
@@ -1198,7 +1230,7 @@ Ret_t wsmUnlockH (MemHandle_t wsmH) {
   wsmBuf[0].pFirstFree = NULL;
   wsmBuf[0].flags &= ~WSM_LOCKED_F;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
@@ -1207,18 +1239,18 @@ Ret_t wsmSetUsedSize (MemHandle_t wsmH, MemSize_t usedSize) {
   // check if handle is invalid
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_VALID_F)) ) {
-    return wsmRet=SML_ERR_INVALID_HANDLE;
+    return SML_ERR_INVALID_HANDLE;
   }
   // check if handle is unlocked
   // must be buffer 0, as only this one exists
   if ( ! ((wsmBuf[0].memH == wsmH) || (wsmBuf[0].flags & WSM_LOCKED_F)) ) {
-    return wsmRet=SML_ERR_WRONG_USAGE;
+    return SML_ERR_WRONG_USAGE;
   }
 
   // usedSize > freeSize?
   if ( usedSize >
-       (wsmBuf[0].size - wsmBuf[0].usedBytes) ) {
-    return wsmRet=SML_ERR_INVALID_SIZE;
+       (wsmBuf[0].size - wsmBuf[0].dataOffset - wsmBuf[0].usedBytes) ) {
+    return SML_ERR_INVALID_SIZE;
   }
 
   // adapt usedSize
@@ -1227,14 +1259,15 @@ Ret_t wsmSetUsedSize (MemHandle_t wsmH, MemSize_t usedSize) {
   // move pFirstFree
   wsmBuf[0].pFirstFree += usedSize;
 
-  return wsmRet=SML_ERR_OK;
+  return SML_ERR_OK;
 }
 
 
 Ret_t wsmReset (MemHandle_t wsmH) {
-  wsmBuf[0].pFirstFree = wsmBuf[0].pFirstFree - wsmBuf[0].usedBytes ;
+  wsmBuf[0].pFirstFree = wsmBuf[0].pFirstFree - wsmBuf[0].usedBytes - wsmBuf[0].dataOffset;
   wsmBuf[0].pFirstData = wsmBuf[0].pFirstFree;
   wsmBuf[0].usedBytes = 0;
+  wsmBuf[0].dataOffset = 0;
 
   return SML_ERR_OK;
 }
@@ -86,16 +86,18 @@ typedef struct WsmBuf_s {
   MemPtr_t    pFirstData;  /**< pointer to first data element in buffer */
   MemSize_t   size;        /**< size of buffer */
   MemSize_t   usedBytes;   /**< used bytes in buffer */
+  MemSize_t   dataOffset;  /**< offset of first unprocessed byte from buffer start */
   Byte_t      flags;
 } WsmBuf_t;
 
 
-/** WSM globals for use with global Anchor */
+/** WSM globals for use with global Anchor
+ *  (no per-call scratch state such as a "current buffer" index or a
+ *  last return code here, so calls for different buffers don't write
+ *  shared data) */
 typedef struct WsmGlobals_s {
-  Ret_t           wsmRet;          /**< last WSM return code */
   Byte_t          initWasCalled;   /**< was wsmInit() called? */
   WsmBuf_t        wsmBuf[MAX_WSM_BUFFERS];
-  Short_t         wsmIndex;        /**< Index of actual buffer */
   WsmSmGlobals_t  wsmSm;           /**< WSM_SM global; device dependent! */
 } *WsmGlobalsPtr_t, WsmGlobals_t;
 
@@ -413,6 +413,7 @@ xltDecInit(const SmlEncoding_t enc,
     pDecoder->finished = 0;
     pDecoder->final = 0;
     pDecoder->scanner = NULL;
+    pDecoder->marktagstack = NULL;
     if ((rc = xltUtilCreateStack(&pDecoder->tagstack, 10)) != SML_ERR_OK) {
         xltDecTerminate(pDecoder);
         return rc;
@@ -617,6 +618,8 @@ xltDecTerminate(XltDecoderPtr_t pDecoder)
         pDecPriv->scanner->destroy(pDecPriv->scanner);
     if (pDecPriv->tagstack != NULL)
         pDecPriv->tagstack->destroy(pDecPriv->tagstack);
+    if (pDecPriv->marktagstack != NULL)
+        pDecPriv->marktagstack->destroy(pDecPriv->marktagstack);
     smlLibFree(pDecPriv);
 
     return SML_ERR_OK;
@@ -628,6 +631,42 @@ Ret_t xltDecReset(XltDecoderPtr_t pDecoder)
   return xltDecTerminate(pDecoder);
 }
 
+/**
+ * Description see XLTDec.h header file.
+ */
+Ret_t
+xltDecMark(XltDecoderPtr_t pDecoder)
+{
+    Ret_t rc;
+
+    if (pDecoder->marktagstack == NULL &&
+        (rc = xltUtilCreateStack(&pDecoder->marktagstack, 10)) != SML_ERR_OK)
+        return rc;
+    if ((rc = xltUtilCopyStack(pDecoder->marktagstack, pDecoder->tagstack)) != SML_ERR_OK)
+        return rc;
+    pDecoder->markfinal = pDecoder->final;
+
+    return pDecoder->scanner->mark(pDecoder->scanner);
+}
+
+/**
+ * Description see XLTDec.h header file.
+ */
+Ret_t
+xltDecRewind(XltDecoderPtr_t pDecoder)
+{
+    Ret_t rc;
+
+    if (pDecoder->marktagstack == NULL)
+        return SML_ERR_WRONG_USAGE;
+    if ((rc = xltUtilCopyStack(pDecoder->tagstack, pDecoder->marktagstack)) != SML_ERR_OK)
+        return rc;
+    pDecoder->final = pDecoder->markfinal;
+    pDecoder->finished = 0;
+
+    return pDecoder->scanner->rewind(pDecoder->scanner);
+}
+
 /**
  * Gets the next token from the scanner.
  * Checks if the current tag is an end tag and if so, whether the last
@@ -2423,7 +2462,7 @@ buildPCData(XltDecoderPtr_t pDecoder, VoidPtr_t *ppPCData)
 
             /* the scanner must point to the closing PCDATA tag */
             if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-                smlLibFree(pPCData);
+                smlFreePcdata(pPCData);
                 return rc;
             }
             break;
@@ -151,6 +151,30 @@ struct XltDecScanner_s
      */
     MemPtr_t (*getPos)(XltDecScannerPtr_t pScanner, Long_t *remaining);
 
+    /**
+     * Saves the complete scanner state (position, current token, open
+     * namespaces/codepages) so that scanning can later be resumed from
+     * this point. Only one state is saved, a new mark replaces the old one.
+     *
+     * @param pScanner (IN/OUT)
+     *        the scanner
+     * @return SML_ERR_OK or an appropriate error code
+     */
+    Ret_t (*mark)(XltDecScannerPtr_t pScanner);
+
+    /**
+     * Restores the scanner state saved by the last call of mark. This is
+     * used to retry a protocol element that could not be decoded because
+     * the document was not yet completely available.
+     *
+     * @pre mark has been called before
+     * @post the next call of nextTok will find the token following the mark
+     * @param pScanner (IN/OUT)
+     *        the scanner
+     * @return SML_ERR_OK or an appropriate error code
+     */
+    Ret_t (*rewind)(XltDecScannerPtr_t pScanner);
+
     /* public attributes */
 
     /** Contains the last valid token found by a call to nextTok. */
@@ -125,6 +125,8 @@ struct wbxmlScannerPriv_s
     Ret_t (*pushTok)(XltDecScannerPtr_t);
     void (*setBuf)(XltDecScannerPtr_t pScanner, const MemPtr_t pBufStart, const MemPtr_t pBufEnd);
     MemPtr_t (*getPos)(XltDecScannerPtr_t pScanner, Long_t *remaining);
+    Ret_t (*mark)(XltDecScannerPtr_t pScanner);
+    Ret_t (*rewind)(XltDecScannerPtr_t pScanner);
 
     /* public attributes */
     XltDecTokenPtr_t curtok;       /**< current token */
@@ -153,6 +155,18 @@ struct wbxmlScannerPriv_s
     SmlPcdataExtension_t cptag;     /**< current codepage for tags */
     Byte_t cpattr;                  /**< current codepage for attributes */
     SmlPcdataExtension_t activeExt; /**< the active Sub DTD */
+
+    /* state saved by mark */
+    struct {
+        XltDecToken_t tok;          /**< current token (without pcdata) */
+        XltUtilStackPtr_t tagstack; /**< copy of the open start tags */
+        MemPtr_t pos;
+        Flag_t finished;
+        Byte_t state;
+        SmlPcdataExtension_t cptag;
+        Byte_t cpattr;
+        SmlPcdataExtension_t activeExt;
+    } saved;
 };
 
 /* typedef for multi-byte unsigned integers as specified in the
@@ -169,6 +183,8 @@ static Ret_t _nextTok(XltDecScannerPtr_t);
 static Ret_t _pushTok(XltDecScannerPtr_t);
 static void _setBuf(XltDecScannerPtr_t, const MemPtr_t, const MemPtr_t);
 static MemPtr_t _getPos(XltDecScannerPtr_t, Long_t *remaining);
+static Ret_t _mark(XltDecScannerPtr_t);
+static Ret_t _rewind(XltDecScannerPtr_t);
 
 /**
  * Advance the current position pointer after checking whether the end of
@@ -274,6 +290,8 @@ xltDecWbxmlInit(const MemPtr_t pBufEnd, MemPtr_t *ppBufPos,
     pScanner->pushTok = _pushTok;
     pScanner->setBuf = _setBuf;
     pScanner->getPos = _getPos;
+    pScanner->mark = _mark;
+    pScanner->rewind = _rewind;
 
     /* decode WBXML header */
     if ((rc = wbxmlHeader(pScanner)) != SML_ERR_OK) {
@@ -301,6 +319,8 @@ _destroy(XltDecScannerPtr_t pScanner)
     pScannerPriv = (wbxmlScannerPrivPtr_t)pScanner;
     if (pScannerPriv->tagstack != NULL)
         pScannerPriv->tagstack->destroy(pScannerPriv->tagstack);
+    if (pScannerPriv->saved.tagstack != NULL)
+        pScannerPriv->saved.tagstack->destroy(pScannerPriv->saved.tagstack);
     smlLibFree(pScannerPriv->curtok);
     smlLibFree(pScannerPriv->strtbl);
     smlLibFree(pScannerPriv);
@@ -405,6 +425,50 @@ _getPos(XltDecScannerPtr_t pScanner, Long_t *remaining)
     return ((wbxmlScannerPrivPtr_t)pScanner)->pos;
 }
 
+static Ret_t
+_mark(XltDecScannerPtr_t pScanner)
+{
+    wbxmlScannerPrivPtr_t pScannerPriv = (wbxmlScannerPrivPtr_t)pScanner;
+    Ret_t rc;
+
+    if (pScannerPriv->saved.tagstack == NULL &&
+        (rc = xltUtilCreateStack(&pScannerPriv->saved.tagstack, 10)) != SML_ERR_OK)
+        return rc;
+    if ((rc = xltUtilCopyStack(pScannerPriv->saved.tagstack, pScannerPriv->tagstack)) != SML_ERR_OK)
+        return rc;
+    pScannerPriv->saved.tok = *pScannerPriv->curtok;
+    pScannerPriv->saved.tok.pcdata = NULL; /* owned by the decoded element by now */
+    pScannerPriv->saved.pos = pScannerPriv->pos;
+    pScannerPriv->saved.finished = pScannerPriv->finished;
+    pScannerPriv->saved.state = pScannerPriv->state;
+    pScannerPriv->saved.cptag = pScannerPriv->cptag;
+    pScannerPriv->saved.cpattr = pScannerPriv->cpattr;
+    pScannerPriv->saved.activeExt = pScannerPriv->activeExt;
+
+    return SML_ERR_OK;
+}
+
+static Ret_t
+_rewind(XltDecScannerPtr_t pScanner)
+{
+    wbxmlScannerPrivPtr_t pScannerPriv = (wbxmlScannerPrivPtr_t)pScanner;
+    Ret_t rc;
+
+    if (pScannerPriv->saved.tagstack == NULL)
+        return SML_ERR_WRONG_USAGE;
+    if ((rc = xltUtilCopyStack(pScannerPriv->tagstack, pScannerPriv->saved.tagstack)) != SML_ERR_OK)
+        return rc;
+    *pScannerPriv->curtok = pScannerPriv->saved.tok;
+    pScannerPriv->pos = pScannerPriv->saved.pos;
+    pScannerPriv->finished = pScannerPriv->saved.finished;
+    pScannerPriv->state = pScannerPriv->saved.state;
+    pScannerPriv->cptag = pScannerPriv->saved.cptag;
+    pScannerPriv->cpattr = pScannerPriv->saved.cpattr;
+    pScannerPriv->activeExt = pScannerPriv->saved.activeExt;
+
+    return SML_ERR_OK;
+}
+
 /*************************************************************************/
 /* Internal Functions                                                    */
 /*************************************************************************/
@@ -595,8 +659,10 @@ wbxmlStringToken(wbxmlScannerPrivPtr_t pScanner)
     /* copy the string into the new PCdata struct */
     if (IS_STR_I(pScanner->pos)) {
         /* inline string */
-        if (!readBytes(pScanner, 1))
+        if (!readBytes(pScanner, 1)) {
+            smlLibFree(pPcdata);
             return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"wbxmlStringToken");
+        }
         pPcdata->extension   = SML_EXT_UNDEFINED;
         pPcdata->contentType = SML_PCDATA_STRING;
         pPcdata->length = smlLibStrlen((String_t)pScanner->pos);
@@ -614,8 +680,10 @@ wbxmlStringToken(wbxmlScannerPrivPtr_t pScanner)
     } else {
         /* string table reference */
         MBINT offset; /* offset into string table */
-        if (!readBytes(pScanner, 1))
+        if (!readBytes(pScanner, 1)) {
+            smlLibFree(pPcdata);
             return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"wbxmlStringToken");
+        }
         if ((rc = parseInt(pScanner, &offset)) != SML_ERR_OK) {
             smlLibFree(pPcdata);
             return rc;
@@ -631,7 +699,10 @@ wbxmlStringToken(wbxmlScannerPrivPtr_t pScanner)
             return SML_ERR_NOT_ENOUGH_SPACE;
         }
         smlLibStrncpy(pPcdata->content, (String_t)(pScanner->strtbl + offset), pPcdata->length + 1);
-        readBytes(pScanner, 1);
+        if (!readBytes(pScanner, 1)) {
+            smlFreePcdata(pPcdata);
+            return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"wbxmlStringToken");
+        }
     }
 
     pScanner->curtok->pcdata = pPcdata;
@@ -986,6 +1057,7 @@ subdtdDecodeWbxml(XltDecoderPtr_t pDecoder,SmlPcdataPtr_t *ppPcdata) {
     pSubDecoder->finished = 0;
     pSubDecoder->final    = 0;
     pSubDecoder->scanner  = NULL;
+    pSubDecoder->marktagstack = NULL;
     if (xltUtilCreateStack(&pSubDecoder->tagstack, 10) != SML_ERR_OK) {
         smlLibFree(pSubDecoder);
         smlLibFree(pSubBuf);
@@ -59,6 +59,32 @@
 
 #include <smlerr.h>
 
+/* the scanning loops over character data and whitespace test 16 bytes at
+ * once with SSE2 where the compiler targets it (all x86-64 compilers do) */
+#if defined(__SSE2__) && !defined(__SML_NO_SIMD__)
+  #define XML_SCAN_SSE2
+  #include <emmintrin.h>
+#endif
+
+/* default block size of the scanner's scratch arena, holds the strings of a typical tag */
+#define XML_SCRATCH_BLOCKSIZE 256
+
+/**
+ * Scanner state saved by mark, restored by rewind.
+ */
+typedef struct
+{
+    XltDecToken_t tok;             /**< current token (without pcdata) */
+    SmlPcdataExtension_t ext;
+    SmlPcdataExtension_t prev_ext;
+    XltTagID_t ext_tag;
+    XltTagID_t prev_ext_tag;
+    String_t   nsprefix;           /**< copy of the active namespace prefix */
+    Byte_t     nsprelen;
+    Flag_t finished;
+    MemPtr_t pos;
+} xmlScannerState_t;
+
 /** @copydoc wbxmlScannerPriv_s */
 typedef struct xmlScannerPriv_s xmlScannerPriv_t, *xmlScannerPrivPtr_t;
 /**
@@ -72,6 +98,8 @@ struct xmlScannerPriv_s
     Ret_t (*pushTok)(XltDecScannerPtr_t);
     void  (*setBuf)(XltDecScannerPtr_t pScanner, const MemPtr_t pBufStart, const MemPtr_t pBufEnd);
     MemPtr_t (*getPos)(XltDecScannerPtr_t pScanner, Long_t *remaining);
+    Ret_t (*mark)(XltDecScannerPtr_t pScanner);
+    Ret_t (*rewind)(XltDecScannerPtr_t pScanner);
 
     XltDecTokenPtr_t curtok;       /**< current token */
     Long_t charset;                /**< 0 */
@@ -83,12 +111,14 @@ struct xmlScannerPriv_s
     XltTagID_t ext_tag;            /**< which tag started the actual namespace ? */
     XltTagID_t prev_ext_tag;       /**< which tag started the previous open namespace ? */
     String_t   nsprefix;           /**< prefix used for active namespace (if any) */
+    SmlLibArenaPtr_t scratch;      /**< temporary strings (tag names, attributes) of the current token */
     Byte_t     nsprelen;           /**< how long is the prefix ? (to save smlLibStrlen calls) */
     Flag_t finished;
 
     /* private */
     MemPtr_t pos;                  /**< current position */
     MemPtr_t bufend;               /**< end of buffer */
+    xmlScannerState_t saved;       /**< state saved by mark */
 };
 
 /*
@@ -101,6 +131,8 @@ static Ret_t _nextTok(XltDecScannerPtr_t);
 static Ret_t _pushTok(XltDecScannerPtr_t);
 static void _setBuf(XltDecScannerPtr_t, const MemPtr_t, const MemPtr_t);
 static MemPtr_t _getPos(XltDecScannerPtr_t, Long_t *remaining);
+static Ret_t _mark(XltDecScannerPtr_t);
+static Ret_t _rewind(XltDecScannerPtr_t);
 
 /**
  * Advance the current position pointer after checking whether the end of
@@ -121,6 +153,20 @@ static Boolean_t readBytes(xmlScannerPrivPtr_t pScanner, Long_t bytes);
  */
 static void skipS(xmlScannerPrivPtr_t pScanner);
 
+/**
+ * Find the first occurrence of c1 or c2 between pos and end.
+ *
+ * @return pointer to the found byte, end if there is none
+ */
+static MemPtr_t scanFor(MemPtr_t pos, MemPtr_t end, MemByte_t c1, MemByte_t c2);
+
+/**
+ * Find the first byte between pos and end which is not whitespace.
+ *
+ * @return pointer to the found byte, end if there is none
+ */
+static MemPtr_t scanSpace(MemPtr_t pos, MemPtr_t end);
+
 /**
  * BOM processing. Currently only check BOMs for UTF-8, UTF-16le, UTF-16be, 
  * UTF-32le and UTF-32be. Note that SML_ERR_XLT_ENC_UNK is also returned 
@@ -178,6 +224,13 @@ xltDecXmlInit(const MemPtr_t pBufEnd, MemPtr_t *ppBufPos, XltDecScannerPtr_t *pp
     }
 
     memset(pScanner->curtok, 0, sizeof(*pScanner->curtok));
+    pScanner->scratch = smlLibArenaNew(XML_SCRATCH_BLOCKSIZE);
+    if (pScanner->scratch == NULL) {
+      smlLibFree(pScanner->curtok);
+      smlLibFree(pScanner);
+      *ppScanner = NULL;
+      return SML_ERR_NOT_ENOUGH_SPACE;
+    }
     pScanner->curtok->tagid = TN_UNDEF;
     pScanner->ext          = SML_EXT_UNDEFINED;
     pScanner->prev_ext     = (SmlPcdataExtension_t)255;
@@ -190,13 +243,15 @@ xltDecXmlInit(const MemPtr_t pBufEnd, MemPtr_t *ppBufPos, XltDecScannerPtr_t *pp
     pScanner->pushTok = _pushTok;
     pScanner->setBuf = _setBuf;
     pScanner->getPos = _getPos;
-
-    if((rc = bomDecl(pScanner)) != SML_ERR_OK)
-        return rc;
-
-    if ((rc = xmlProlog(pScanner)) != SML_ERR_OK) {
-      smlLibFree(pScanner->curtok);
-      smlLibFree(pScanner);
+    pScanner->mark = _mark;
+    pScanner->rewind = _rewind;
+
+    if ((rc = bomDecl(pScanner)) == SML_ERR_OK)
+      rc = xmlProlog(pScanner);
+    smlLibArenaReset(pScanner->scratch);
+    if (rc != SML_ERR_OK) {
+      /* also reached with an incomplete prolog while streaming, so don't leak anything */
+      _destroy((XltDecScannerPtr_t)pScanner);
       *ppScanner = NULL;
       return rc;
     }
@@ -221,8 +276,11 @@ _destroy(XltDecScannerPtr_t pScanner)
 
   pScannerPriv = (xmlScannerPrivPtr_t)pScanner;
   smlLibFree(pScannerPriv->curtok);
+  smlLibArenaFree(pScannerPriv->scratch);
   smlLibFree(pScannerPriv->charsetStr);
   smlLibFree(pScannerPriv->pubIDStr);
+  smlLibFree(pScannerPriv->nsprefix);
+  smlLibFree(pScannerPriv->saved.nsprefix);
   smlLibFree(pScannerPriv);
 
   return SML_ERR_OK;
@@ -239,6 +297,10 @@ _nextTok(XltDecScannerPtr_t pScanner)
 
   pScannerPriv = (xmlScannerPrivPtr_t)pScanner;
   pScannerPriv->curtok->start = pScannerPriv->pos;
+  /* content of the previous token belongs to the decoder now */
+  pScannerPriv->curtok->pcdata = NULL;
+  /* temporary strings of the previous token are no longer needed */
+  smlLibArenaReset(pScannerPriv->scratch);
 
   if (pScannerPriv->curtok->type!=TOK_CONT)
     skipS(pScannerPriv);
@@ -318,6 +380,60 @@ _getPos(XltDecScannerPtr_t pScanner, Long_t *remaining)
     return ((xmlScannerPrivPtr_t)pScanner)->pos;
 }
 
+/**
+ * Save the scanner state. Description see XltDecCom.h.
+ */
+static Ret_t
+_mark(XltDecScannerPtr_t pScanner)
+{
+    xmlScannerPrivPtr_t pScannerPriv = (xmlScannerPrivPtr_t)pScanner;
+    xmlScannerState_t *pSaved = &pScannerPriv->saved;
+
+    smlLibFree(pSaved->nsprefix);
+    pSaved->nsprefix = NULL;
+    if (pScannerPriv->nsprefix != NULL &&
+        (pSaved->nsprefix = smlLibStrdup(pScannerPriv->nsprefix)) == NULL)
+        return SML_ERR_NOT_ENOUGH_SPACE;
+    pSaved->tok          = *pScannerPriv->curtok;
+    pSaved->tok.pcdata   = NULL; /* owned by the decoded element by now */
+    pSaved->ext          = pScannerPriv->ext;
+    pSaved->prev_ext     = pScannerPriv->prev_ext;
+    pSaved->ext_tag      = pScannerPriv->ext_tag;
+    pSaved->prev_ext_tag = pScannerPriv->prev_ext_tag;
+    pSaved->nsprelen     = pScannerPriv->nsprelen;
+    pSaved->finished     = pScannerPriv->finished;
+    pSaved->pos          = pScannerPriv->pos;
+
+    return SML_ERR_OK;
+}
+
+/**
+ * Restore the scanner state saved by _mark. Description see XltDecCom.h.
+ */
+static Ret_t
+_rewind(XltDecScannerPtr_t pScanner)
+{
+    xmlScannerPrivPtr_t pScannerPriv = (xmlScannerPrivPtr_t)pScanner;
+    xmlScannerState_t *pSaved = &pScannerPriv->saved;
+
+    smlLibFree(pScannerPriv->nsprefix);
+    pScannerPriv->nsprefix = NULL;
+    if (pSaved->nsprefix != NULL &&
+        (pScannerPriv->nsprefix = smlLibStrdup(pSaved->nsprefix)) == NULL)
+        return SML_ERR_NOT_ENOUGH_SPACE;
+    *pScannerPriv->curtok      = pSaved->tok;
+    pScannerPriv->ext          = pSaved->ext;
+    pScannerPriv->prev_ext     = pSaved->prev_ext;
+    pScannerPriv->ext_tag      = pSaved->ext_tag;
+    pScannerPriv->prev_ext_tag = pSaved->prev_ext_tag;
+    pScannerPriv->nsprelen     = pSaved->nsprelen;
+    pScannerPriv->finished     = pSaved->finished;
+    pScannerPriv->pos          = pSaved->pos;
+    smlLibArenaReset(pScannerPriv->scratch);
+
+    return SML_ERR_OK;
+}
+
 
 
 
@@ -344,6 +460,8 @@ readBytes(xmlScannerPrivPtr_t pScanner, Long_t bytes)
  */
 static void skipS(xmlScannerPrivPtr_t pScanner)
 {
+    // jump over the whitespace before bufend, the loop checks the rest
+    pScanner->pos = scanSpace(pScanner->pos, pScanner->bufend);
     for (;;) {
         switch (*pScanner->pos) {
             case  9: /* tab stop */
@@ -358,6 +476,57 @@ static void skipS(xmlScannerPrivPtr_t pScanner)
         }
     }
 }
+
+/**
+ * Find c1 or c2. Description see above.
+ */
+static MemPtr_t scanFor(MemPtr_t pos, MemPtr_t end, MemByte_t c1, MemByte_t c2)
+{
+#ifdef XML_SCAN_SSE2
+    const __m128i v1 = _mm_set1_epi8((char)c1);
+    const __m128i v2 = _mm_set1_epi8((char)c2);
+    while (end - pos >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)pos);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2)));
+        if (mask) {
+            while (!(mask & 1)) { mask >>= 1; pos++; }
+            return pos;
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < end && *pos != c1 && *pos != c2)
+        pos++;
+    return pos;
+}
+
+/**
+ * Find non-whitespace. Description see above.
+ */
+static MemPtr_t scanSpace(MemPtr_t pos, MemPtr_t end)
+{
+#ifdef XML_SCAN_SSE2
+    const __m128i tab = _mm_set1_epi8(9);
+    const __m128i lf = _mm_set1_epi8(10);
+    const __m128i cr = _mm_set1_epi8(13);
+    const __m128i sp = _mm_set1_epi8(32);
+    while (end - pos >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)pos);
+        int mask = _mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, tab), _mm_cmpeq_epi8(chunk, lf)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, sp))
+        )) ^ 0xFFFF;
+        if (mask) {
+            while (!(mask & 1)) { mask >>= 1; pos++; }
+            return pos;
+        }
+        pos += 16;
+    }
+#endif
+    while (pos < end && (*pos == 9 || *pos == 10 || *pos == 13 || *pos == 32))
+        pos++;
+    return pos;
+}
 static Ret_t bomDecl(xmlScannerPrivPtr_t pScanner)
 {
     Short_t bomLength = 0;
@@ -446,7 +615,6 @@ xmlDocTypeDecl(xmlScannerPrivPtr_t pScanner)
     readBytes(pScanner, 9);
     skipS(pScanner);
     if ((rc = xmlName(pScanner, &name)) != SML_ERR_OK) {
-        smlLibFree(name);
         return rc;
     }
     skipS(pScanner);
@@ -457,8 +625,6 @@ xmlDocTypeDecl(xmlScannerPrivPtr_t pScanner)
         readBytes(pScanner, 6);
         skipS(pScanner);
         if ((rc = xmlStringConst(pScanner, &syslit)) != SML_ERR_OK) {
-            smlLibFree(name);
-            smlLibFree(syslit);
             return rc;
         }
     } else if ((pScanner->pos + 6 <= pScanner->bufend) &&
@@ -466,23 +632,14 @@ xmlDocTypeDecl(xmlScannerPrivPtr_t pScanner)
         readBytes(pScanner, 6);
         skipS(pScanner);
         if ((rc = xmlStringConst(pScanner, &publit)) != SML_ERR_OK) {
-            smlLibFree(name);
-            smlLibFree(publit);
             return rc;
         }
         skipS(pScanner);
         if ((rc = xmlStringConst(pScanner, &syslit)) != SML_ERR_OK) {
-            smlLibFree(name);
-            smlLibFree(syslit);
-            smlLibFree(publit);
             return rc;
         }
     }
 
-    smlLibFree(name);
-    smlLibFree(syslit);
-    smlLibFree(publit);
-
     skipS(pScanner);
 
     if (*pScanner->pos != '>')
@@ -508,12 +665,8 @@ xmlXMLDecl(xmlScannerPrivPtr_t pScanner)
     if ((rc = xmlAttribute(pScanner, &name, &value)) != SML_ERR_OK)
         return rc;
     if (smlLibStrcmp(name, "version") != 0) {
-        smlLibFree(name);
-        smlLibFree(value);
         return SML_DECODEERROR(SML_ERR_XLT_INVAL_XML_DOC,pScanner,"xmlXMLDecl");
     }
-    smlLibFree(name);
-    smlLibFree(value);
 
     skipS(pScanner);
 
@@ -522,8 +675,6 @@ xmlXMLDecl(xmlScannerPrivPtr_t pScanner)
         (smlLibStrncmp((String_t)pScanner->pos, "?>", 2) != 0)) {
         if ((rc = xmlAttribute(pScanner, &name, &value)) != SML_ERR_OK)
             return rc;
-        smlLibFree(name);
-        smlLibFree(value);
         skipS(pScanner);
     }
 
@@ -559,7 +710,6 @@ xmlAttribute(xmlScannerPrivPtr_t pScanner, String_t *name, String_t *value)
     }
 
     if (*pScanner->pos != '=') {
-        smlLibFree(*name);
         *name = NULL;
         *value = NULL;
         return SML_DECODEERROR(SML_ERR_XLT_INVAL_XML_DOC,pScanner,"xmlAttribute");
@@ -569,7 +719,6 @@ xmlAttribute(xmlScannerPrivPtr_t pScanner, String_t *name, String_t *value)
     skipS(pScanner);
 
     if ((rc = xmlStringConst(pScanner, value)) != SML_ERR_OK) {
-        smlLibFree(*name);
         *name = NULL;
         *value = NULL;
         return rc;
@@ -601,7 +750,7 @@ xmlStringConst(xmlScannerPrivPtr_t pScanner, String_t *value)
         return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlStringConst");
     }
     len = end - (String_t)pScanner->pos;
-    if ((*value = (String_t)smlLibMalloc(len + 1)) == NULL)
+    if ((*value = (String_t)smlLibArenaAlloc(pScanner->scratch, len + 1)) == NULL)
   {
 
     return SML_ERR_NOT_ENOUGH_SPACE;
@@ -719,8 +868,7 @@ xmlCharData(xmlScannerPrivPtr_t pScanner)
         pPCData->extension   = SML_EXT_UNDEFINED;
         pPCData->length      = 0;
         pScanner->curtok->type = TOK_CONT;
-        pScanner->curtok->pcdata = pPCData;
-        //smlLibFree(pPCData);
+        smlLibFree(pPCData);
         return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlCharData");
     }
 
@@ -733,6 +881,8 @@ xmlCharData(xmlScannerPrivPtr_t pScanner)
         begin = (MemPtr_t)&entity;
         len = 1;
     } else {
+        // jump to the first delimiter before bufend, the loop checks what we got
+        pScanner->pos = scanFor(pScanner->pos, pScanner->bufend, '<', '&');
         while (*pScanner->pos != '<' && (*pScanner->pos != '&'))
         {
           if (pScanner->pos >= pScanner->bufend)
@@ -789,7 +939,7 @@ xmlName(xmlScannerPrivPtr_t pScanner, String_t *name)
     if (len == 0) return SML_ERR_OK;
 
 
-    tmp = (String_t)smlLibMalloc(len + 1);
+    tmp = (String_t)smlLibArenaAlloc(pScanner->scratch, len + 1);
     if (tmp == NULL) {
         *name = NULL;
         return SML_ERR_NOT_ENOUGH_SPACE;
@@ -809,7 +959,7 @@ static Ret_t
 xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
 {
     Ret_t rc;
-    String_t name, attname=NULL, value = NULL, nsprefix = NULL;
+    String_t name = NULL, attname=NULL, value = NULL, nsprefix = NULL;
   Byte_t nsprelen = 0;
     XltTagID_t tagid;
   SmlPcdataExtension_t ext;
@@ -835,6 +985,9 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
         }
 
     }
+    /* xmlName leaves name alone if there is none (e.g. at the end of the buffer) */
+    if (name == NULL)
+        return SML_DECODEERROR(SML_ERR_XLT_INVAL_XML_DOC,pScanner,"xmlTag");
 
   ext = pScanner->ext;
   if (!endtag) {
@@ -854,9 +1007,6 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
                     nsprelen = (Byte_t)smlLibStrlen(&attname[6]);
           nsprefix = smlLibMalloc(nsprelen+1);
           if (nsprefix == NULL) {
-              smlLibFree(attname);
-              smlLibFree(value);
-              smlLibFree(name);
               return SML_ERR_NOT_ENOUGH_SPACE;
           }
           smlLibStrcpy(nsprefix,&attname[6]);
@@ -864,24 +1014,15 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
         ext = getExtByName(value);
         if (ext == (SmlPcdataExtension_t)255) {
           smlLibFree(nsprefix); /* doesn't harm, even when empty */
-          smlLibFree(attname);
-          smlLibFree(value);
-          smlLibFree(name);
           return  SML_DECODEERROR(SML_ERR_XLT_INVALID_CODEPAGE,pScanner,"xmlTag");
         }
       } else {
         if (rc == SML_ERR_NOT_ENOUGH_SPACE) {
-          smlLibFree(attname);
-          smlLibFree(value);
-          smlLibFree(name);
           return SML_ERR_NOT_ENOUGH_SPACE;
         }
         else {
           /* we found an unknown attribute -> bail out */
-          smlLibFree(attname);
-          smlLibFree(value);
           /* nsprefix is empty here so we save us a function call */
-          smlLibFree(name);
           return SML_DECODEERROR(SML_ERR_XLT_INVAL_XML_DOC,pScanner,"xmlTag");
         }
       }
@@ -891,8 +1032,6 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
       /* xmlAttribute returns an SML_ERR_XLT_MISSING_CONT error when
        * no attribute was found. This is not an error, but everything else is.
        */
-      smlLibFree(value);
-      smlLibFree(name);
       return rc;
     }
   } // if endtag
@@ -907,9 +1046,6 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
      */
     if (pScanner->nsprelen > 0 && smlLibStrlen(name) > pScanner->nsprelen+1) {
       if (name[pScanner->nsprelen] != ':' || smlLibStrncmp(name,pScanner->nsprefix, pScanner->nsprelen) != 0) {
-        smlLibFree(name);
-        smlLibFree(attname);
-        smlLibFree(value);
         smlLibFree(nsprefix);
         return SML_DECODEERROR(SML_ERR_XLT_NO_MATCHING_CODEPAGE,pScanner,"xmlTag");
       }
@@ -932,9 +1068,6 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
     /* we have a new Namespace */
     if (nsprelen > 0 && smlLibStrlen(name) > nsprelen+1) {
       if (name[nsprelen] != ':' || smlLibStrncmp(name,nsprefix, nsprelen) != 0) {
-        smlLibFree(name);
-        smlLibFree(attname);
-        smlLibFree(value);
         smlLibFree(nsprefix);
         return SML_DECODEERROR(SML_ERR_XLT_NO_MATCHING_CODEPAGE,pScanner,"xmlTag");
       }
@@ -947,11 +1080,7 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
     else
       rc = getTagIDByStringAndExt(name, ext, &tagid);
   }
-  /* free temporary buffers */
-  smlLibFree(name);
-  smlLibFree(attname);
-  smlLibFree(value);
-
+  /* name, attname and value are scratch strings, released with the next token */
   if ((tagid == TN_UNDEF) || (rc != SML_ERR_OK)) {
     smlLibFree(nsprefix);
     return rc;
@@ -978,7 +1107,8 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
     if (smlLibStrncmp((String_t)pScanner->pos, ">", 1) != 0)
         return SML_DECODEERROR(SML_ERR_XLT_INVAL_XML_DOC,pScanner,"xmlTag");
     pScanner->curtok->type = TOK_TAG_END;
-    readBytes(pScanner, 1);
+    if (!readBytes(pScanner, 1))
+        return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlTag");
     /* in case of an endtag we might need to close the current CP */
     if (tagid == pScanner->ext_tag) {
       pScanner->ext_tag = pScanner->prev_ext_tag;
@@ -996,10 +1126,12 @@ xmlTag(xmlScannerPrivPtr_t pScanner, Byte_t endtag)
     if (smlLibStrncmp((String_t)pScanner->pos, "/>", 2) == 0) {
         /* found empty tag */
         pScanner->curtok->type = TOK_TAG_EMPTY;
-        readBytes(pScanner, 2);
+        if (!readBytes(pScanner, 2))
+            return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlTag");
     } else if (smlLibStrncmp((String_t)pScanner->pos, ">", 1) == 0) {
         pScanner->curtok->type = TOK_TAG_START;
-        readBytes(pScanner, 1);
+        if (!readBytes(pScanner, 1))
+            return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlTag");
     } else {
         return SML_DECODEERROR(SML_ERR_XLT_INVAL_XML_DOC,pScanner,"xmlTag");
     }
@@ -1083,9 +1215,16 @@ xmlCDATA(xmlScannerPrivPtr_t pScanner)
     pPCData->content = NULL;
 
     begin = pScanner->pos;
-    while (!((pScanner->pos[0] == ']') && (pScanner->pos[1] == ']') && (pScanner->pos[2] == '>')))
-      if (!readBytes(pScanner, 1))
+    for (;;) {
+      // jump to the next ']' which might start the end marker
+      pScanner->pos = scanFor(pScanner->pos, pScanner->bufend, ']', ']');
+      if ((pScanner->pos[0] == ']') && (pScanner->pos[1] == ']') && (pScanner->pos[2] == '>'))
+        break;
+      if (!readBytes(pScanner, 1)) {
+        smlLibFree(pPCData);
         return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlCDATA");
+      }
+    }
 
     len = pScanner->pos - begin;
     pPCData->content = smlLibMalloc(len + 1);
@@ -1134,21 +1273,19 @@ xmlSkipPCDATA(xmlScannerPrivPtr_t pScanner)
         return rc;
     }
 
-    _tagString = smlLibMalloc(XML_MAX_TAGLEN);
+    _tagString = smlLibArenaAlloc(pScanner->scratch, XML_MAX_TAGLEN);
     if (_tagString == NULL) return SML_ERR_NOT_ENOUGH_SPACE;
     if ((rc = getTagString(pScanner->curtok->tagid, _tagString, pScanner->curtok->ext)) != SML_ERR_OK)
     {
-        smlLibFree(_tagString);
         return rc;
     }
 
-    _tagString2 = smlLibMalloc(smlLibStrlen(_tagString) + 4 + (pScanner->nsprelen +1));
+    _tagString2 = smlLibArenaAlloc(pScanner->scratch, smlLibStrlen(_tagString) + 4 + (pScanner->nsprelen +1));
 
     // build a end tag String to compate (e.g. </Meta>)
     // beware of possible namespace prefixes
     if (_tagString2 == NULL)
     {
-        smlLibFree(_tagString);
         return SML_ERR_NOT_ENOUGH_SPACE;
     }
 
@@ -1159,7 +1296,6 @@ xmlSkipPCDATA(xmlScannerPrivPtr_t pScanner)
     }
     _tagString2 = smlLibStrcat(_tagString2,_tagString);
     _tagString2 = smlLibStrcat(_tagString2,">");
-    smlLibFree(_tagString);
 
     pPCData = (SmlPcdataPtr_t)smlLibMalloc(sizeof(SmlPcdata_t));
 
@@ -1167,7 +1303,6 @@ xmlSkipPCDATA(xmlScannerPrivPtr_t pScanner)
 
     if (pPCData == NULL)
     {
-        smlLibFree(_tagString2);
         return SML_ERR_NOT_ENOUGH_SPACE;
     }
     pPCData->contentType = SML_PCDATA_UNDEFINED;
@@ -1180,7 +1315,7 @@ xmlSkipPCDATA(xmlScannerPrivPtr_t pScanner)
     if (*pScanner->pos == '&') {
         Ret_t ret = xmlHTMLEntity(pScanner, &entity);
         if (ret) {
-            smlLibFree(_tagString2);
+            smlLibFree(pPCData);
             return ret;
         }
         begin = (MemPtr_t)&entity;
@@ -1192,7 +1327,7 @@ xmlSkipPCDATA(xmlScannerPrivPtr_t pScanner)
         {
           // check if end of buffer
           if (pScanner->pos >= pScanner->bufend) {
-            smlLibFree(_tagString2);
+            smlLibFree(pPCData);
             return SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"xmlSkipPCDATA");
           }
           // %%% luz 2006-09-07
@@ -1202,15 +1337,15 @@ xmlSkipPCDATA(xmlScannerPrivPtr_t pScanner)
             // stop PCDATA scanning here
             break;
           }
-          if (!readBytes(pScanner, 1))
+          if (!readBytes(pScanner, 1)) {
+            smlLibFree(pPCData);
             return SML_DECODEERROR(SML_ERR_XLT_END_OF_BUFFER,pScanner,"xmlSkipPCDATA");
+          }
 
         }
         len = pScanner->pos - begin;
     }
 
-    smlLibFree(_tagString2);
-
     pPCData->content = smlLibMalloc(len + 1);
     if (pPCData->content == NULL)
     {
@@ -122,7 +122,7 @@ Ret_t buildDevInfDevInfContent(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pElem);
+        smlFreeDevInfDevInf(pElem);
         return rc;
     }
 
@@ -181,11 +181,11 @@ Ret_t buildDevInfDevInfContent(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfDevInfContent");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pElem);
+            smlFreeDevInfDevInf(pElem);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pElem);
+            smlFreeDevInfDevInf(pElem);
             return rc;
         }
     }
@@ -304,7 +304,7 @@ Ret_t buildDevInfDataStoreCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pElem);
+        smlFreeDevInfDatastore(pElem);
         return rc;
     }
 
@@ -381,11 +381,11 @@ Ret_t buildDevInfDataStoreCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfDataStoreCmd");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pElem);
+            smlFreeDevInfDatastore(pElem);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pElem);
+            smlFreeDevInfDatastore(pElem);
             return rc;
         }
     }
@@ -414,7 +414,7 @@ Ret_t buildDevInfXmitCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pXmit);
+        smlFreeDevInfXmit(pXmit);
         return rc;
     }
 
@@ -431,11 +431,11 @@ Ret_t buildDevInfXmitCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfXmitCmd");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pXmit);
+            smlFreeDevInfXmit(pXmit);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pXmit);
+            smlFreeDevInfXmit(pXmit);
             return rc;
         }
     }
@@ -865,7 +865,7 @@ Ret_t buildDevInfDSMemCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pElem);
+        smlFreeDevInfDSMem(pElem);
         return rc;
     }
 
@@ -887,11 +887,11 @@ Ret_t buildDevInfDSMemCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfDSMemCmd");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pElem);
+            smlFreeDevInfDSMem(pElem);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pElem);
+            smlFreeDevInfDSMem(pElem);
             return rc;
         }
     }
@@ -920,7 +920,7 @@ Ret_t buildDevInfCTCapCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pElem);
+        smlFreeDevInfCTCap(pElem);
         return rc;
     }
 
@@ -933,11 +933,11 @@ Ret_t buildDevInfCTCapCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfCTCapCmd");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pElem);
+            smlFreeDevInfCTCap(pElem);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pElem);
+            smlFreeDevInfCTCap(pElem);
             return rc;
         }
     }
@@ -966,7 +966,7 @@ Ret_t buildDevInfSyncCapCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pElem);
+        smlFreeDevInfSynccap(pElem);
         return rc;
     }
 
@@ -979,11 +979,11 @@ Ret_t buildDevInfSyncCapCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfSyncCapCmd");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pElem);
+            smlFreeDevInfSynccap(pElem);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pElem);
+            smlFreeDevInfSynccap(pElem);
             return rc;
         }
     }
@@ -1012,7 +1012,7 @@ Ret_t buildDevInfExtCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
     }
 
     if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-        smlLibFree(pElem);
+        smlFreeDevInfExt(pElem);
         return rc;
     }
 
@@ -1028,11 +1028,11 @@ Ret_t buildDevInfExtCmd(XltDecoderPtr_t pDecoder, VoidPtr_t *ppElem) {
                 rc = SML_DECODEERROR(SML_ERR_XLT_INVAL_SYNCML_DOC,pScanner,"buildDevInfExtCmd");
         }
         if (rc != SML_ERR_OK) {
-            smlLibFree(pElem);
+            smlFreeDevInfExt(pElem);
             return rc;
         }
         if (((rc = nextToken(pDecoder)) != SML_ERR_OK)) {
-            smlLibFree(pElem);
+            smlFreeDevInfExt(pElem);
             return rc;
         }
     }
@@ -240,6 +240,7 @@ Ret_t xltEncInit(SmlEncoding_t enc,
   _pEncoder->last_ext = (SmlPcdataExtension_t)SML_EXT_UNDEFINED;
   _pEncoder->end_tag_size = 0;
   _pEncoder->space_evaluation = NULL;
+  _pEncoder->pending.state = XLT_PENDING_NONE;
 
 
   _pBufMgr->smlXltBufferP = *ppBufPos;
@@ -408,6 +409,33 @@ Ret_t xltEncAppend(const XltEncoderPtr_t pEncoder,
   //Structure containing buffer pointers, length and written bytes
   BufferMgmtPtr_t _pBufMgr;
 
+  // the command encoded tentatively by the preceding evaluation run
+  XltPendingEncodingPtr_t _pending = &pEncoder->pending;
+
+  // unaltered buffer management, for retrying the evaluation when tentative encoding overflows
+  BufferMgmt_t _initialBufMgr;
+
+  if (pEncoder->space_evaluation == NULL) {
+    if (
+      _pending->state == XLT_PENDING_ARMED &&
+      _pending->pe == pe &&
+      _pending->content == pContent &&
+      _pending->pos == *ppBufPos &&
+      _pending->written_bytes <= (MemSize_t)(pBufEnd - *ppBufPos)
+    ) {
+      // the evaluation run has already encoded exactly this command at this
+      // position, just commit it instead of encoding it again
+      pEncoder->end_tag_size += _pending->end_tag_size;
+      pEncoder->cur_ext = _pending->cur_ext;
+      pEncoder->last_ext = _pending->last_ext;
+      *ppBufPos += _pending->written_bytes;
+      _pending->state = XLT_PENDING_NONE;
+      return SML_ERR_OK;
+    }
+    // any real encoding invalidates the tentative one
+    _pending->state = XLT_PENDING_NONE;
+  }
+
   if ((_pBufMgr = (BufferMgmtPtr_t)smlLibMalloc(sizeof(BufferMgmt_t))) == NULL) return SML_ERR_NOT_ENOUGH_SPACE;
   smlLibMemset(_pBufMgr, 0, sizeof(BufferMgmt_t));
 
@@ -438,7 +466,40 @@ Ret_t xltEncAppend(const XltEncoderPtr_t pEncoder,
 
   _err = getTNbyPE(pe, &tagID);
 
-  _err = xltEncBlock(tagID, REQUIRED, pContent, _enc, _pBufMgr, SML_EXT_UNDEFINED);
+  if (
+    _pBufMgr->spaceEvaluation &&
+    pEncoder->space_evaluation->written_bytes == 0 &&
+    _pending->state == XLT_PENDING_NONE
+  ) {
+    // first command of this evaluation run: encode it for real behind the
+    // write position (which is not advanced), so a following real append can
+    // commit it without encoding it again
+    _initialBufMgr = *_pBufMgr;
+    _pBufMgr->spaceEvaluation = 0;
+    _err = xltEncBlock(tagID, REQUIRED, pContent, _enc, _pBufMgr, SML_EXT_UNDEFINED);
+    if (_err == SML_ERR_OK) {
+      _pending->state = XLT_PENDING_ENCODED;
+      _pending->pe = pe;
+      _pending->content = pContent;
+      _pending->pos = *ppBufPos;
+      // take the distance actually moved, smlXltWrittenBytes does not count
+      // every byte in real mode (e.g. the OPAQUE token of a WBXML sub-DTD)
+      _pending->written_bytes = _pBufMgr->smlXltBufferP - *ppBufPos;
+      _pending->end_tag_size = _pBufMgr->endTagSize;
+      _pending->cur_ext = _pBufMgr->smlCurExt;
+      _pending->last_ext = _pBufMgr->smlLastExt;
+    }
+    else if (_err == SML_ERR_XLT_BUF_ERR) {
+      // does not fit into the workspace, just count the size as usual
+      *_pBufMgr = _initialBufMgr;
+      _err = xltEncBlock(tagID, REQUIRED, pContent, _enc, _pBufMgr, SML_EXT_UNDEFINED);
+    }
+  }
+  else {
+    // more than one command evaluated, tentative encoding would be overwritten
+    if (_pBufMgr->spaceEvaluation) _pending->state = XLT_PENDING_NONE;
+    _err = xltEncBlock(tagID, REQUIRED, pContent, _enc, _pBufMgr, SML_EXT_UNDEFINED);
+  }
   if (_err != SML_ERR_OK)
   {
      smlLibFree(_pBufMgr);
@@ -453,6 +514,8 @@ Ret_t xltEncAppend(const XltEncoderPtr_t pEncoder,
     // save it only into evaluation state
     pEncoder->space_evaluation->cur_ext = _pBufMgr->smlCurExt;
     pEncoder->space_evaluation->last_ext = _pBufMgr->smlLastExt;
+    // write position must not move in evaluation mode
+    _pBufMgr->smlXltBufferP = *ppBufPos;
   } else {
     // really generating data
     pEncoder->end_tag_size += _pBufMgr->endTagSize;
@@ -529,6 +592,7 @@ Ret_t xltEncTerminate(const XltEncoderPtr_t pEncoder,
   _pBufMgr->switchExtTag = TN_UNDEF;
   _pBufMgr->spaceEvaluation = ((pEncoder->space_evaluation == NULL) ? 0 : 1);
   _pBufMgr->endTagSize =0;
+  pEncoder->pending.state = XLT_PENDING_NONE;
 
   if (pEncoder->final == 1)
   {
@@ -580,6 +644,30 @@ Ret_t xltEncReset(XltEncoderPtr_t pEncoder)
 }
 
 
+/**
+ * Compacts a complete message after xltEncTerminate() by moving strings
+ * which occur repeatedly into the WBXML string table. XML messages are
+ * left unchanged. The message never grows.
+ *
+ * @param enc (IN)
+ *        the encoding of the message
+ * @param pMsg (IN/OUT)
+ *        start of the message in the buffer
+ * @param pMsgSize (IN/OUT)
+ *        size of the message
+ * @return shows error codes of function,\n
+ *         0, if OK
+ */
+Ret_t xltEncStringTable(SmlEncoding_t enc, MemPtr_t pMsg, MemSize_t *pMsgSize)
+{
+  #ifdef __SML_WBXML__
+  if (enc == SML_WBXML)
+    return wbxmlBuildStringTable(pMsg, pMsgSize);
+  #endif
+  return SML_ERR_OK;
+}
+
+
 /**
  * Starts an evaluation run which prevents further API-Calls to write tags -
  * just the tag-sizes are calculated. Must be sopped via smlEndEvaluation
@@ -603,6 +691,8 @@ SML_API Ret_t xltStartEvaluation(XltEncoderPtr_t pEncoder)
   _pSpaceEvaluation->last_ext = pEncoder->last_ext;
 
   pEncoder->space_evaluation = _pSpaceEvaluation;
+  // a new evaluation run discards the tentative encoding of the previous one
+  pEncoder->pending.state = XLT_PENDING_NONE;
   return SML_ERR_OK;
 }
 
@@ -644,6 +734,24 @@ SML_API Ret_t xltEndEvaluation(InstanceID_t id, XltEncoderPtr_t pEncoder, MemSiz
 }
 
 
+/**
+ * Confirms that the command measured by the last evaluation run will be
+ * appended next, unchanged. The append then commits the tentative encoding
+ * made during evaluation instead of encoding the command a second time.
+ *
+ * @param pEncoder (IN)
+ *        the encoder object
+ * @return Return Code, SML_ERR_WRONG_USAGE if no tentative encoding is available
+ */
+SML_API Ret_t xltReuseEvaluation(XltEncoderPtr_t pEncoder)
+{
+  if (pEncoder->space_evaluation != NULL || pEncoder->pending.state != XLT_PENDING_ENCODED)
+    return SML_ERR_WRONG_USAGE;
+  pEncoder->pending.state = XLT_PENDING_ARMED;
+  return SML_ERR_OK;
+}
+
+
 /**
  * Generates a (WB)XML Block for a given tag ID and a given content
  *
@@ -1553,6 +1661,16 @@ Ret_t subdtdEncWBXML(XltTagID_t tagId, XltRO_t reqOptFlag, const VoidPtr_t pCont
     // move it to the 'real' encoder buffer
     // now set up the OPAQUE field
     if (pBufMgr->spaceEvaluation == 0) {
+      // the sub buffer may be larger than what is left in the real one, so
+      // check that OPAQUE token, mb_u_int32 size and sub document all fit
+      MemSize_t _needed = 2 + pSubBufMgr->smlXltWrittenBytes;
+      MemSize_t _sizeRest = pSubBufMgr->smlXltWrittenBytes >> 7;
+      while (_sizeRest) { _needed++; _sizeRest >>= 7; }
+      if (_needed > pBufMgr->smlXltBufferLen - pBufMgr->smlXltWrittenBytes) {
+        smlLibFree(pSubBufMgr->smlXltStoreBufP);
+        smlLibFree(pSubBufMgr);
+        return SML_ERR_XLT_BUF_ERR;
+      }
       pBufMgr->smlXltBufferP[0]     = 0xC3; // OPAQUE data identifier
       pBufMgr->smlXltBufferP       += 1;
 
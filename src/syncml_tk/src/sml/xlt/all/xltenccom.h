@@ -93,6 +93,31 @@ typedef struct XltSpaceEvaluation_s
   SmlPcdataExtension_t last_ext;
 } XltSpaceEvaluation_t, *XltSpaceEvaluationPtr_t;
 
+/** states of a tentative encoding left behind by an evaluation run */
+typedef enum {
+  XLT_PENDING_NONE = 0, // nothing pending
+  XLT_PENDING_ENCODED,  // encoded beyond write position, not yet committable
+  XLT_PENDING_ARMED     // caller confirmed unchanged content, next matching append commits it
+} XltPendingState_t;
+
+/** Type for storing a tentative encoding made during an evaluation run.
+ *  The evaluated command is encoded for real behind the current write position
+ *  of the workspace (without moving it), so the following real append of the
+ *  same, unchanged command only needs to commit these bytes instead of
+ *  encoding them a second time. Nothing needs to be rolled back when the
+ *  command is not sent, as the write position was never advanced. */
+typedef struct XltPendingEncoding_s
+{
+  XltPendingState_t state;
+  SmlProtoElement_t pe;      // protocol element that was encoded
+  VoidPtr_t content;         // content that was encoded
+  MemPtr_t pos;              // write position the encoding starts at
+  MemSize_t written_bytes;   // size of the encoding
+  MemSize_t end_tag_size;    // end tag size to account for when committing
+  SmlPcdataExtension_t cur_ext;
+  SmlPcdataExtension_t last_ext;
+} XltPendingEncoding_t, *XltPendingEncodingPtr_t;
+
 
 typedef struct bufferMgmt_s
 {
@@ -296,4 +296,233 @@ Ret_t wbxmlWriteTypeToBuffer(const MemPtr_t pContent, XltElementType_t elType, L
 
 //  return SML_ERR_OK;unreachable
 }
+
+
+/** one distinct inline string of a message, see wbxmlBuildStringTable() */
+typedef struct WbxmlStrTblEntry_s
+{
+  MemPtr_t str;    /**< first occurrence of the string in the message */
+  Long_t   len;    /**< string length without terminator */
+  Long_t   count;  /**< number of STR_I tokens carrying this string */
+  Long_t   offset; /**< offset in the new string table, -1 if kept inline */
+} WbxmlStrTblEntry_t;
+
+/** global token for string table references */
+#define XLT_STR_T 0x83
+
+/**
+ * Returns the number of bytes needed for a mb_u_int32
+ */
+static Long_t wbxmlMBIntSize(Long_t val)
+{
+  Long_t n = 1;
+  while ((val >>= 7) != 0) n++;
+  return n;
+}
+
+/**
+ * Writes a mb_u_int32 and returns the position behind it
+ */
+static MemPtr_t wbxmlPutMBInt(MemPtr_t p, Long_t val)
+{
+  Long_t n = wbxmlMBIntSize(val);
+  while (--n > 0)
+    *p++ = (MemByte_t)(((val >> (7 * n)) & 0x7F) | 0x80);
+  *p++ = (MemByte_t)(val & 0x7F);
+  return p;
+}
+
+/**
+ * Reads a mb_u_int32, returns FALSE if it does not end before pEnd
+ */
+static Boolean_t wbxmlGetMBInt(MemPtr_t *ppPos, const MemPtr_t pEnd, Long_t *pVal)
+{
+  *pVal = 0;
+  while (*ppPos < pEnd) {
+    *pVal = (*pVal << 7) | (**ppPos & 0x7F);
+    if ((*(*ppPos)++ & 0x80) == 0) return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+ * Returns the size of the WBXML body token at p, or 0 if it is
+ * incomplete or of a kind the encoder never generates (attributes,
+ * extensions, entities, literals, PIs)
+ *
+ * @param pStrLen (OUT)
+ *        string length for STR_I tokens, -1 for all others
+ */
+static Long_t wbxmlBodyTokenSize(const MemPtr_t p, const MemPtr_t pEnd, Long_t *pStrLen)
+{
+  MemPtr_t q;
+  Long_t len;
+
+  *pStrLen = -1;
+  switch (*p) {
+    case XLT_SWITCHPAGE:
+      return (p + 2 <= pEnd) ? 2 : 0;
+    case 0x01: // END
+      return 1;
+    case 0x03: // STR_I
+      for (q = p + 1; q < pEnd; q++) {
+        if (*q == XLT_TERMSTR) {
+          *pStrLen = (Long_t)(q - p - 1);
+          return *pStrLen + 2;
+        }
+      }
+      return 0;
+    case XLT_STR_T:
+      q = p + 1;
+      return wbxmlGetMBInt(&q, pEnd, &len) ? (Long_t)(q - p) : 0;
+    case 0xC3: // OPAQUE
+      q = p + 1;
+      if (!wbxmlGetMBInt(&q, pEnd, &len) || len > pEnd - q) return 0;
+      return (Long_t)(q - p) + len;
+    default:
+      // plain tags with or without content, but no attributes
+      if ((*p & 0x3F) < 0x05 || (*p & 0x80)) return 0;
+      return 1;
+  }
+}
+
+/**
+ * Moves strings which occur repeatedly as STR_I content of a complete
+ * WBXML message into the string table of the message and replaces them
+ * by STR_T references. Strings are only moved when this saves space, so
+ * the message never grows. Messages containing tokens this encoder does
+ * not generate are left alone. Opaque data (e.g. DevInf) is not touched.
+ *
+ * @param pMsg (IN/OUT)
+ *        the message, rewritten in place
+ * @param pMsgSize (IN/OUT)
+ *        size of the message
+ * @return shows error codes of function,\n
+ *                  0, if OK (message possibly unchanged)
+ */
+Ret_t wbxmlBuildStringTable(MemPtr_t pMsg, MemSize_t *pMsgSize)
+{
+  MemPtr_t p, pEnd, pBody, pStrTbl, pOut, q;
+  Long_t val, hdrLen, strTblLen, newTblLen, tokSize, strLen, numStr, numEntries, i, k;
+  Long_t hashSize, h, ref, saved, newSize;
+  unsigned long hv;
+  Boolean_t termFPI;
+  WbxmlStrTblEntry_t *pEntries;
+  Long_t *pHash, *pOcc;
+
+  pEnd = pMsg + *pMsgSize;
+  // header: version, public id (index into string table if 0), charset, string table
+  p = pMsg + 1;
+  if (p >= pEnd || !wbxmlGetMBInt(&p, pEnd, &val)) return SML_ERR_OK;
+  if (val == 0 && !wbxmlGetMBInt(&p, pEnd, &val)) return SML_ERR_OK;
+  if (!wbxmlGetMBInt(&p, pEnd, &val)) return SML_ERR_OK;
+  hdrLen = (Long_t)(p - pMsg);
+  if (!wbxmlGetMBInt(&p, pEnd, &strTblLen) || strTblLen > pEnd - p) return SML_ERR_OK;
+  pStrTbl = p;
+  pBody = p + strTblLen;
+  // count the inline strings, bail out on anything unexpected
+  numStr = 0;
+  for (p = pBody; p < pEnd; p += tokSize) {
+    if ((tokSize = wbxmlBodyTokenSize(p, pEnd, &strLen)) == 0) return SML_ERR_OK;
+    if (strLen >= 0) numStr++;
+  }
+  if (numStr < 2) return SML_ERR_OK;
+  // find the distinct strings (open addressing on FNV-1a hashes)
+  for (hashSize = 4; hashSize < 2 * numStr; hashSize <<= 1);
+  pEntries = (WbxmlStrTblEntry_t *)smlLibMalloc(numStr * sizeof(WbxmlStrTblEntry_t));
+  pHash = (Long_t *)smlLibMalloc(hashSize * sizeof(Long_t));
+  pOcc = (Long_t *)smlLibMalloc(numStr * sizeof(Long_t));
+  if (!pEntries || !pHash || !pOcc) {
+    smlLibFree(pEntries);
+    smlLibFree(pHash);
+    smlLibFree(pOcc);
+    return SML_ERR_NOT_ENOUGH_SPACE;
+  }
+  for (i = 0; i < hashSize; i++) pHash[i] = -1;
+  numEntries = 0;
+  k = 0;
+  for (p = pBody; p < pEnd; p += tokSize) {
+    tokSize = wbxmlBodyTokenSize(p, pEnd, &strLen);
+    if (strLen < 0) continue;
+    hv = 2166136261u;
+    for (q = p + 1; q < p + 1 + strLen; q++)
+      hv = (hv ^ *q) * 16777619u;
+    h = (Long_t)(hv & (hashSize - 1));
+    while (pHash[h] >= 0 && (
+      pEntries[pHash[h]].len != strLen ||
+      smlLibMemcmp(pEntries[pHash[h]].str, p + 1, strLen) != 0
+    ))
+      h = (h + 1) & (hashSize - 1);
+    if (pHash[h] < 0) {
+      pHash[h] = numEntries;
+      pEntries[numEntries].str = p + 1;
+      pEntries[numEntries].len = strLen;
+      pEntries[numEntries].count = 0;
+      pEntries[numEntries].offset = -1;
+      numEntries++;
+    }
+    pEntries[pHash[h]].count++;
+    pOcc[k++] = pHash[h];
+  }
+  smlLibFree(pHash);
+  // assign table offsets to the strings which pay for their table entry
+  // - a textual FPI is stored without terminator, add one before appending to it
+  termFPI = strTblLen > 0 && pStrTbl[strTblLen - 1] != XLT_TERMSTR;
+  newTblLen = strTblLen + (termFPI ? 1 : 0);
+  saved = 0;
+  for (i = 0; i < numEntries; i++) {
+    if (pEntries[i].count < 2) continue;
+    ref = 1 + wbxmlMBIntSize(newTblLen);
+    val = pEntries[i].count * (pEntries[i].len + 2 - ref) - (pEntries[i].len + 1);
+    if (val <= 0) continue;
+    pEntries[i].offset = newTblLen;
+    newTblLen += pEntries[i].len + 1;
+    saved += val;
+  }
+  newSize =
+    (Long_t)*pMsgSize - saved + (termFPI ? 1 : 0) +
+    wbxmlMBIntSize(newTblLen) - wbxmlMBIntSize(strTblLen);
+  if (saved == 0 || newSize >= (Long_t)*pMsgSize) {
+    // nothing worth moving
+    smlLibFree(pEntries);
+    smlLibFree(pOcc);
+    return SML_ERR_OK;
+  }
+  if ((pOut = (MemPtr_t)smlLibMalloc(newSize)) == NULL) {
+    smlLibFree(pEntries);
+    smlLibFree(pOcc);
+    return SML_ERR_NOT_ENOUGH_SPACE;
+  }
+  // header with the new string table
+  smlLibMemcpy(pOut, pMsg, hdrLen);
+  q = wbxmlPutMBInt(pOut + hdrLen, newTblLen);
+  smlLibMemcpy(q, pStrTbl, strTblLen);
+  q += strTblLen;
+  if (termFPI) *q++ = XLT_TERMSTR;
+  for (i = 0; i < numEntries; i++) {
+    if (pEntries[i].offset < 0) continue;
+    smlLibMemcpy(q, pEntries[i].str, pEntries[i].len);
+    q += pEntries[i].len;
+    *q++ = XLT_TERMSTR;
+  }
+  // body with references for the moved strings
+  k = 0;
+  for (p = pBody; p < pEnd; p += tokSize) {
+    tokSize = wbxmlBodyTokenSize(p, pEnd, &strLen);
+    if (strLen >= 0 && pEntries[pOcc[k++]].offset >= 0) {
+      *q++ = XLT_STR_T;
+      q = wbxmlPutMBInt(q, pEntries[pOcc[k - 1]].offset);
+    }
+    else {
+      smlLibMemcpy(q, p, tokSize);
+      q += tokSize;
+    }
+  }
+  smlLibMemcpy(pMsg, pOut, q - pOut);
+  *pMsgSize = (MemSize_t)(q - pOut);
+  smlLibFree(pOut);
+  smlLibFree(pEntries);
+  smlLibFree(pOcc);
+  return SML_ERR_OK;
+}
 #endif
@@ -104,6 +104,7 @@ Ret_t wbxmlGenerateTag(XltTagID_t tagId, XltTagType_t tagType, BufferMgmtPtr_t p
 Ret_t wbxmlWriteTypeToBuffer(const MemPtr_t pContent, XltElementType_t elType, Long_t size, BufferMgmtPtr_t pBufMgr);
 Ret_t wbxmlOpaqueSize2Buf(Long_t size, BufferMgmtPtr_t pBufMgr);
 MemByte_t wbxmlGetGlobToken(XltElementType_t elType);
+Ret_t wbxmlBuildStringTable(MemPtr_t pMsg, MemSize_t *pMsgSize);
 
 #ifdef __cplusplus
 }
@@ -556,6 +556,119 @@ Byte_t getCodePage(SmlPcdataExtension_t ext)
     return 0;
 }
 
+/* Perfect hash tables for finding the tag ID of an XML tag name
+ * ==============================================================
+ *
+ * For every code page, the tag name is hashed with
+ *   h = (h*mult + c) & 0xFFFF for each character c, slot = (h>>shift) & mask
+ * and the slot holds the 1-based position of the tag in the code page's
+ * table from getTagTable() (0=unused). mult and shift are the first
+ * collision-free combination found by brute-force search over the table
+ * contents. Names added to the tables later are still found by the linear
+ * scan fallback, but the slot tables must be regenerated when entries are
+ * removed or reordered.
+ */
+typedef struct XltTagHash_s {
+  unsigned int mult;
+  unsigned int shift;
+  unsigned int mask;
+  const Byte_t *slots;
+} XltTagHash_t;
+
+static const Byte_t syncmlTagSlots[256] = {
+      0,  0,  0, 50,  0,  0,  0, 25,  0,  0,  0,  0,  2,  0,  6, 54,
+      0,  0,  0, 26,  5,  0,  0, 49,  0,  0,  0,  0,  0,  0, 48, 42,
+      7,  0, 47,  0,  0,  0, 28,  0,  0,  0,  0,  0,  0,  0, 55,  0,
+      0,  0,  0,  0, 32,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 22,
+      0, 29,  0,  0,  0,  0,  0,  0,  0,  0, 23,  0,  0,  0,  0, 18,
+      0, 17, 13,  0,  0, 14, 43,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0, 34,  0,  0,  0,  0,  0,  0,  0, 30,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0, 10,  0,  0, 38,  0,  0,  0,  0,  0,
+      0, 12,  0, 36,  0,  0,  0, 16,  0,  0,  0,  0,  0, 40,  0,  0,
+     51,  0,  0,  0, 15,  0,  0,  0, 45,  0,  0,  0,  0,  0,  0,  0,
+      0,  9,  0, 19, 35,  0,  0,  0,  0,  0,  4,  0,  0,  0,  0,  0,
+      0,  3,  0, 20,  0,  0,  0,  0,  0,  0,  0, 41,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0, 24,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0, 37,  0, 27,  0, 21,  0,  0,  0,  0,  0,
+      0,  0,  0,  0, 53,  0,  0, 31,  0,  0,  0, 46,  1,  0,  0,  0,
+     33, 39,  0,  0, 44, 11,  0,  0,  8, 52,  0,  0,  0,  0,  0,  0
+};
+static const XltTagHash_t syncmlTagHash = { 153, 1, 0xFF, syncmlTagSlots };
+
+#ifdef __USE_METINF__
+static const Byte_t metinfTagSlots[32] = {
+     16,  8,  6,  0,  0, 10,  0,  0,  0, 17,  9,  4, 18,  0,  0, 11,
+      0,  2,  0, 14, 13,  0,  0,  1,  5,  3, 15,  0,  0,  7,  0, 12
+};
+static const XltTagHash_t metinfTagHash = { 69, 2, 0x1F, metinfTagSlots };
+#endif
+
+#ifdef __USE_DEVINF__
+static const Byte_t devinfTagSlots[256] = {
+      0,  0,  0,  0, 22,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     29,  0,  0,  0,  0,  0,  0, 23,  0,  0,  0,  0,  0, 24,  0,  8,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 32,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 44,  0,  0,  0,  0, 20,
+      0, 39,  0,  0,  0,  0,  0,  0,  0,  4,  0,  0,  0,  0,  0, 19,
+      0,  0,  0,  0, 26,  0,  0,  0,  0,  2, 17,  0, 33,  0,  0,  0,
+     11,  0,  5,  0,  0,  0,  0,  0,  0,  0,  0, 40, 41,  0,  0, 38,
+      0,  0,  0,  0, 30,  0,  0,  0,  0,  0,  0,  0,  0,  3,  0, 18,
+      0,  0,  0, 47,  0,  0,  0, 16,  0,  0,  1,  0,  0,  0,  0,  0,
+      0,  0, 46,  0,  0,  0,  0,  0, 43,  0, 15,  0,  0,  0,  0,  0,
+     13,  0, 27, 34,  0, 37,  0,  0,  0, 28,  0,  0,  0, 48,  0,  0,
+      0,  0,  0, 31,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  9,
+      0,  0, 35,  0, 45,  0,  0,  0, 10,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0, 42,  0,  0,  0,  0,  6, 36,
+      0,  0,  0,  0, 21,  0,  0,  0, 12,  0,  0,  0, 25, 14,  7,  0
+};
+static const XltTagHash_t devinfTagHash = { 14, 0, 0xFF, devinfTagSlots };
+#endif
+
+static const XltTagHash_t *getTagHash(SmlPcdataExtension_t ext)
+{
+  if (ext == SML_EXT_UNDEFINED)
+    return &syncmlTagHash;
+  #ifdef __USE_METINF__
+  if (ext == SML_EXT_METINF)
+    return &metinfTagHash;
+  #endif
+  #ifdef __USE_DEVINF__
+  if (ext == SML_EXT_DEVINF)
+    return &devinfTagHash;
+  #endif
+  return NULL;
+}
+
+
+/* Code page of every tag ID, in XltTagID_t order (SML_EXT_LAST=none).
+ * Tag IDs beyond the end of this table are searched in all tag tables.
+ */
+#define XS SML_EXT_UNDEFINED
+#define XM SML_EXT_METINF
+#define XD SML_EXT_DEVINF
+#define XN SML_EXT_LAST
+static const Byte_t XltTagExt[] = {
+  XN, XS, XS, XS, XS, XN, XS, XS, XS, XS, /* 0 */
+  XS, XS, XS, XS, XS, XS, XS, XS, XS, XS, /* 10 */
+  XS, XS, XS, XS, XS, XS, XS, XS, XS, XS, /* 20 */
+  XS, XS, XS, XS, XN, XS, XS, XS, XS, XS, /* 30 */
+  XS, XS, XS, XS, XN, XS, XS, XS, XS, XM, /* 40 */
+  XM, XM, XM, XM, XM, XM, XM, XM, XM, XM, /* 50 */
+  XM, XM, XM, XM, XM, XD, XD, XD, XD, XD, /* 60 */
+  XD, XD, XD, XD, XD, XD, XD, XD, XD, XD, /* 70 */
+  XD, XD, XD, XD, XD, XD, XD, XD, XD, XD, /* 80 */
+  XD, XD, XD, XD, XD, XD, XD, XD, XD, XD, /* 90 */
+  XS, XS, XM, XD, XD, XD, XS, XS, XS, XS, /* 100 */
+  XS, XS, XS, XS, XM, XD, XD, XD, XD, XD, /* 110 */
+  XD, XD, XD, XD, XD /* 120 */
+};
+#undef XS
+#undef XM
+#undef XD
+#undef XN
+
+
 /**
  * Returns the codepage which belongs to a certain tag ID
  *
@@ -571,6 +684,16 @@ Ret_t getExtById(XltTagID_t tagID,  SmlPcdataExtension_t *pExt)
 {
     int i = 0;
   SmlPcdataExtension_t ext;
+  /* use the index for known tag IDs */
+  if ((unsigned int)tagID < sizeof(XltTagExt)/sizeof(XltTagExt[0])) {
+    ext = (SmlPcdataExtension_t)XltTagExt[tagID];
+    if (ext != SML_EXT_LAST && getTagTable(ext) != NULL) {
+      *pExt = ext;
+      return SML_ERR_OK;
+    }
+    *pExt = (SmlPcdataExtension_t)255;
+    return SML_ERR_XLT_INVAL_PROTO_ELEM;
+  }
   /* Iterate over all defined extensions to find the corresponding TAG.
    * Empty extensions, e.g. not defined numbers will be skipped.
    */
@@ -609,10 +732,25 @@ Ret_t getExtById(XltTagID_t tagID,  SmlPcdataExtension_t *pExt)
 Ret_t getTagIDByStringAndExt(String_t tag, SmlPcdataExtension_t ext, XltTagID_t *pTagID)
 {
     int i = 0;
+    const XltTagHash_t *pHash;
     TagPtr_t pTags = getTagTable(ext);
     if (pTags == NULL) {
       return SML_ERR_NOT_ENOUGH_SPACE;
     }
+    /* try perfect hash first */
+    pHash = getTagHash(ext);
+    if (pHash != NULL) {
+      unsigned int h = 0;
+      const char *p;
+      for (p = tag; *p; p++)
+        h = (h * pHash->mult + (Byte_t)*p) & 0xFFFF;
+      i = pHash->slots[(h >> pHash->shift) & pHash->mask];
+      if (i > 0 && smlLibStrcmp(((pTags+i-1)->xml), tag) == 0) {
+        *pTagID = (pTags+i-1)->id;
+        return SML_ERR_OK;
+      }
+    }
+    /* not in hash, search table */
     for (i=0;((pTags+i)->id) != TN_UNDEF; i++) {
       if (*(pTags+i)->xml != *tag) continue; // if the first char doesn't match we skip the strcmp to speed things up
         if (smlLibStrcmp(((pTags+i)->xml), tag) == 0) {
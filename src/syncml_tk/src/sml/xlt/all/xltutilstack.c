@@ -116,6 +116,30 @@ xltUtilCreateStack(XltUtilStackPtr_t *ppStack, const Long_t size)
     return SML_ERR_OK;
 }
 
+Ret_t
+xltUtilCopyStack(XltUtilStackPtr_t pDst, const XltUtilStackPtr_t pSrc)
+{
+    ArrayStackPtr_t pDstPriv = (ArrayStackPtr_t)pDst;
+    ArrayStackPtr_t pSrcPriv = (ArrayStackPtr_t)pSrc;
+
+    if (pDstPriv->size <= pSrcPriv->topidx) {
+        XltUtilStackItem_t *newarray;
+
+        if ((newarray = (XltUtilStackItem_t*)smlLibRealloc(pDstPriv->array,
+                        pSrcPriv->size * sizeof(XltUtilStackItem_t))) == NULL)
+            return SML_ERR_NOT_ENOUGH_SPACE;
+        pDstPriv->size = pSrcPriv->size;
+        pDstPriv->chunksize = pSrcPriv->chunksize;
+        pDstPriv->array = newarray;
+    }
+    if (pSrcPriv->topidx >= 0)
+        smlLibMemcpy(pDstPriv->array, pSrcPriv->array,
+                (pSrcPriv->topidx + 1) * sizeof(XltUtilStackItem_t));
+    pDstPriv->topidx = pSrcPriv->topidx;
+
+    return SML_ERR_OK;
+}
+
 /*************************************************************************/
 /* Internal Functions                                                    */
 /*************************************************************************/
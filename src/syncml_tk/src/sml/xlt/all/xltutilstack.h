@@ -136,4 +136,19 @@ struct XltUtilStack_s
  */
 Ret_t xltUtilCreateStack(XltUtilStackPtr_t *ppStack, const Long_t size);
 
+/**
+ * Replaces the contents of a stack by a copy of another stack's contents.
+ * The destination stack grows as needed, so it can be used to save and
+ * later restore the state of a stack.
+ *
+ * @post popping both stacks yields the same sequence of elements
+ * @param pDst (IN/OUT)
+ *        the stack to be overwritten
+ * @param pSrc (IN)
+ *        the stack to be copied
+ * @return - SML_ERR_NOT_ENOUGH_SPACE, if memory reallocation failed
+ *         - SML_ERR_OK, else
+ */
+Ret_t xltUtilCopyStack(XltUtilStackPtr_t pDst, const XltUtilStackPtr_t pSrc);
+
 #endif
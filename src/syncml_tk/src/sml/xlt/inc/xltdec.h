@@ -115,6 +115,13 @@ typedef struct XltDecoder_s
      */
     XltUtilStackPtr_t tagstack;
 
+    /**
+     * Copy of the tag stack and final flag saved by xltDecMark, NULL as
+     * long as the decoder has never been marked.
+     */
+    XltUtilStackPtr_t marktagstack;
+    Boolean_t markfinal;
+
 } XltDecoder_t, *XltDecoderPtr_t;
 
 /**
@@ -199,6 +206,34 @@ Ret_t xltDecTerminate(XltDecoderPtr_t pDecoder) XLT_FUNC;
 
 Ret_t xltDecReset(XltDecoderPtr_t pDecoder) XLT_FUNC;
 
+/**
+ * Saves the decoder state at a protocol element boundary, i.e. before a
+ * call to xltDecNext. If that call then fails because the document ends
+ * prematurely, xltDecRewind returns the decoder to the saved state, so
+ * xltDecNext can be retried on the same buffer position once more data
+ * has arrived.
+ *
+ * @pre pDecoder points to a decoder status object initialized by xltDecInit
+ * @param pDecoder (IN/OUT)
+ *        the decoder
+ * @return
+ *         - SML_ERR_OK, if the state could be saved
+ *         - else error code
+ */
+Ret_t xltDecMark(XltDecoderPtr_t pDecoder) XLT_FUNC;
+
+/**
+ * Restores the decoder state saved by the last call to xltDecMark.
+ *
+ * @pre xltDecMark has been called for pDecoder
+ * @param pDecoder (IN/OUT)
+ *        the decoder
+ * @return
+ *         - SML_ERR_OK, if the state could be restored
+ *         - else error code
+ */
+Ret_t xltDecRewind(XltDecoderPtr_t pDecoder) XLT_FUNC;
+
 /* T.K. moved here from xltdec.c for use in sub-DTD parsing */
 #define IS_START(tok) ((tok)->type == TOK_TAG_START)
 #define IS_END(tok) ((tok)->type == TOK_TAG_END)
@@ -70,6 +70,7 @@ typedef struct XltEncoder_s
   Boolean_t final;
   XltSpaceEvaluationPtr_t space_evaluation;
   MemSize_t end_tag_size;
+  XltPendingEncoding_t pending; // tentative encoding of the last evaluation run
 } XltEncoder_t, *XltEncoderPtr_t;
 
 
@@ -77,9 +78,11 @@ Ret_t xltEncInit(SmlEncoding_t enc, const SmlSyncHdrPtr_t pHeader, const MemPtr_
 Ret_t xltEncAppend(const XltEncoderPtr_t pEncoder, SmlProtoElement_t pe, const MemPtr_t pBufEnd, const VoidPtr_t pContent, MemPtr_t *ppBufPos) XLT_FUNC;
 Ret_t xltEncTerminate(const XltEncoderPtr_t pEncoder, const MemPtr_t pBufEnd, MemPtr_t *ppBufPos) XLT_FUNC;
 Ret_t xltEncReset(XltEncoderPtr_t pEncoder) XLT_FUNC;
+Ret_t xltEncStringTable(SmlEncoding_t enc, MemPtr_t pMsg, MemSize_t *pMsgSize) XLT_FUNC;
 Ret_t xltGenerateTag(XltTagID_t, XltTagType_t, SmlEncoding_t, BufferMgmtPtr_t, SmlPcdataExtension_t) XLT_FUNC;
 Ret_t xltStartEvaluation(XltEncoderPtr_t pEncoder) XLT_FUNC;
 Ret_t xltEndEvaluation(InstanceID_t id, XltEncoderPtr_t pEncoder, MemSize_t *freemem) XLT_FUNC;
+Ret_t xltReuseEvaluation(XltEncoderPtr_t pEncoder) XLT_FUNC;
 Ret_t xltEncBlock(XltTagID_t tagId, XltRO_t reqOptFlag, const VoidPtr_t pContent, SmlEncoding_t enc, BufferMgmtPtr_t pBufMgr, SmlPcdataExtension_t attFlag) XLT_FUNC;
 Ret_t xltBuildExtention(SmlPcdataExtension_t extId, XltRO_t reqOptFlag, VoidPtr_t pContent, SmlEncoding_t enc, BufferMgmtPtr_t pBufMgr) XLT_FUNC;
 Ret_t xltEncPcdata(XltTagID_t tagId, XltRO_t reqOptFlag, const VoidPtr_t pContent, SmlEncoding_t enc, BufferMgmtPtr_t pBufMgr, SmlPcdataExtension_t attFlag) XLT_FUNC;
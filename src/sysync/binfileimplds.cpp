@@ -552,6 +552,10 @@ static uInt32 changelogUpdateFunc(uInt32 aOldVersion, uInt32 aNewVersion, void *
       // init new V5 dataCRC; if we are updating from V2 or V3 (which is handled above) we'll assign the previous CRC here, 0 otherwise
       chglogEntryP->dataCRC = crc;
     }
+    if (aOldVersion<6) {
+      // init new V6 dataHash: none yet, next change check will compare dataCRC and then record the hash
+      chglogEntryP->dataHash = 0;
+    }
   }
   else if (aNewRecordData) {
     // update extra header
@@ -695,6 +699,57 @@ lineartime_t TBinfileImplDS::getLastSyncModRefTime(void)
 
 
 
+// index into loaded changelog entries by local ID (used in changeLogPreflight)
+#ifdef NUMERIC_LOCALIDS
+typedef localid_t TLocalIDKey;
+static TLocalIDKey localIDKey(localid_t aLocalID)
+{
+  return aLocalID;
+} // localIDKey
+#else
+typedef string TLocalIDKey;
+static TLocalIDKey localIDKey(localid_t aLocalID)
+{
+  // only the first maxidlen chars are significant (see LOCALID_EQUAL)
+  size_t n=0;
+  if (aLocalID)
+    while (n<maxidlen && aLocalID[n]) n++;
+  return TLocalIDKey(aLocalID ? aLocalID : "",n);
+} // localIDKey
+#endif
+typedef map<TLocalIDKey,uInt32> TChangeLogIndex;
+
+
+#ifndef RECORDHASH_FROM_DBAPI
+
+// get 64 bit hash of item's data for change detection
+static uInt64 itemDataHash(TSyncItem *aItemP)
+{
+  uInt64 hash = aItemP->getDataHash(0,true); // do not include eqm_none fields
+  return hash ? hash : 1; // 0 is reserved for "no hash recorded"
+} // itemDataHash
+
+
+// check if item's data differs from what is recorded in changelog entry
+static bool itemDataChanged(const TChangeLogEntry &aEntry, TSyncItem *aItemP, uInt64 aHash)
+{
+  if (aEntry.dataHash)
+    return aEntry.dataHash!=aHash;
+  // entry recorded before V6, only 16 bit CRC available to compare
+  return aEntry.dataCRC!=aItemP->getDataCRC(0,true);
+} // itemDataChanged
+
+
+// record item's data hash in changelog entry
+static void setEntryDataHash(TChangeLogEntry &aEntry, uInt64 aHash)
+{
+  aEntry.dataHash = aHash;
+  aEntry.dataCRC = 0; // superseded by hash
+} // setEntryDataHash
+
+#endif // not RECORDHASH_FROM_DBAPI
+
+
 // update change log using CRC checksum comparison before syncing
 // Note: Don't call before types are ok (we need TSyncItems)
 localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
@@ -703,6 +758,8 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
   aValidChangelog = false;
   bferr err = BFE_OK;
   TChangeLogEntry *existingentries = NULL; // none yet
+  TChangeLogIndex existingindex; // index by localid into existingentries
+  TChangeLogIndex::iterator ipos;
   uInt32 numexistinglogentries;
   bool foundone;
   uInt32 seen = 0;
@@ -712,7 +769,11 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
   memset(&newentry, 0, sizeof(newentry));
   TSyncItem *itemP = NULL;
   localid_out_t itemLocalID;
+  #ifdef RECORDHASH_FROM_DBAPI
   uInt16 dataCRC = 0;
+  #else
+  uInt64 dataHash = 0;
+  #endif
   bool itemIsModified = false;
 
   // just in case: make sure we don't have a changelog loaded here
@@ -763,6 +824,8 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
       // set as delete candidate if not already marked deleted
       if (!(existingentries[logindex].flags & chgl_deleted))
         existingentries[logindex].flags = existingentries[logindex].flags | chgl_delete_candidate; // mark as delete candidate
+      // index it (first entry wins in case the log contains the same localid more than once)
+      existingindex.insert(TChangeLogIndex::value_type(localIDKey(existingentries[logindex].dbrecordid),logindex));
     }
   }
   // Now update the changelog using CRC checks
@@ -829,36 +892,35 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
     //   (prevent searching those that we have created in this preflight)
     bool chgentryexists=false; // none found yet
     TChangeLogEntry *currentEntryP = NULL; // no entry yet
-    for (logindex=0; logindex<numexistinglogentries; logindex++) {
-      if (LOCALID_EQUAL(existingentries[logindex].dbrecordid,localid)) {
-        // found
-        chgentryexists = true;
-        currentEntryP = &(existingentries[logindex]);
-        // - remove the deletion candidate flag if it was set
-        if (currentEntryP->flags & chgl_delete_candidate) {
-          currentEntryP->flags &= ~chgl_delete_candidate; // remove candidate flag
-        }
-        // found
-        if (CRC_CHANGE_DETECTION) {
-          PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
-            "- found in changelog at index=%ld, flags=0x%02hX, modcount=%ld, modcount_created=%ld, saved CRC=0x%04hX",
-            (long)logindex,
-            (uInt16)currentEntryP->flags,
-            (long)currentEntryP->modcount,
-            (long)currentEntryP->modcount_created,
-            currentEntryP->dataCRC
-          ));
-        }
-        else {
-          PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
-            "- found in changelog at index=%ld, flags=0x%02hX, modcount=%ld, modcount_created=%ld",
-            (long)logindex,
-            (uInt16)currentEntryP->flags,
-            (long)currentEntryP->modcount,
-            (long)currentEntryP->modcount_created
-          ));
-        }
-        break;
+    ipos = existingindex.find(localIDKey(localid));
+    if (ipos!=existingindex.end()) {
+      // found
+      logindex = ipos->second;
+      chgentryexists = true;
+      currentEntryP = &(existingentries[logindex]);
+      // - remove the deletion candidate flag if it was set
+      if (currentEntryP->flags & chgl_delete_candidate) {
+        currentEntryP->flags &= ~chgl_delete_candidate; // remove candidate flag
+      }
+      if (CRC_CHANGE_DETECTION) {
+        PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
+          "- found in changelog at index=%ld, flags=0x%02hX, modcount=%ld, modcount_created=%ld, saved CRC=0x%04hX, saved hash=0x%016llX",
+          (long)logindex,
+          (uInt16)currentEntryP->flags,
+          (long)currentEntryP->modcount,
+          (long)currentEntryP->modcount_created,
+          currentEntryP->dataCRC,
+          (unsigned long long)currentEntryP->dataHash
+        ));
+      }
+      else {
+        PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
+          "- found in changelog at index=%ld, flags=0x%02hX, modcount=%ld, modcount_created=%ld",
+          (long)logindex,
+          (uInt16)currentEntryP->flags,
+          (long)currentEntryP->modcount,
+          (long)currentEntryP->modcount_created
+        ));
       }
     }
     // - create new record
@@ -868,6 +930,7 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
       // - just init these, will be updated with real values below
       newentry.flags = 0;
       newentry.dataCRC = 0;
+      newentry.dataHash = 0;
       newentry.modcount = 0;
       newentry.modcount_created = 0;
       PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,("- does not yet exist in changelog, created new"));
@@ -877,8 +940,8 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
     // now check what to do
     if (CRC_CHANGE_DETECTION) {
       #ifndef RECORDHASH_FROM_DBAPI
-      // we need a CRC but don't have it precalculated from the DB layer
-      dataCRC=itemP->getDataCRC(0,true); // start new CRC, do not include eqm_none fields
+      // we need a checksum but don't have it precalculated from the DB layer
+      dataHash=itemDataHash(itemP);
       #endif // not RECORDHASH_FROM_DBAPI
     }
     // - check if new or changed
@@ -886,25 +949,47 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
       // entry exists (and is not a deleted one), could be changed
       if (CRC_CHANGE_DETECTION) {
         // - check CRC to calculate itemIsModified
+        #ifdef RECORDHASH_FROM_DBAPI
         itemIsModified = existingentries[logindex].dataCRC!=dataCRC;
+        #else
+        itemIsModified = itemDataChanged(existingentries[logindex],itemP,dataHash);
+        #endif
         if (itemIsModified) {
+          #ifdef RECORDHASH_FROM_DBAPI
           PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
             "- item has changed (current CRC=0x%04hX, old CRC=0x%04hX)",
             dataCRC,
             currentEntryP->dataCRC
           ));
+          #else
+          PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
+            "- item has changed (current hash=0x%016llX, old hash=0x%016llX)",
+            (unsigned long long)dataHash,
+            (unsigned long long)currentEntryP->dataHash
+          ));
+          #endif
           // has changed since last time checked by preflight (but only those! There might be more items
           // changed since last sync or resume, but these ALREADY have a modcount in the changelog that
           // flags them such).
           // So this is the place to reset chgl_modbysync (which marks items changed by a sync and not from outside)
           currentEntryP->flags &= ~chgl_modbysync; // detecting a real change here cancels the mod-by-sync flag set for sync-added/changed entries
           // update CRC and modification count
+          #ifdef RECORDHASH_FROM_DBAPI
           currentEntryP->dataCRC=dataCRC;
+          #else
+          setEntryDataHash(*currentEntryP,dataHash);
+          #endif
           currentEntryP->modcount=fCurrentModCount; // update modification count
           // this is a local change for this session
           fNumberOfLocalChanges++; // for suspend: those that detect a change here were modified AFTER last suspend, so always count them
 
         }
+        #ifndef RECORDHASH_FROM_DBAPI
+        else if (currentEntryP->dataHash==0) {
+          // unchanged entry from before V6: record hash from now on
+          setEntryDataHash(*currentEntryP,dataHash);
+        }
+        #endif
       }
       else {
         // - DB has reported change status into itemIsModified already
@@ -946,10 +1031,16 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
       currentEntryP->flags = 0;
       // - update CRC to current value if CRC is in use
       if (CRC_CHANGE_DETECTION) {
+        #ifdef RECORDHASH_FROM_DBAPI
         currentEntryP->dataCRC = dataCRC;
+        currentEntryP->dataHash = 0;
+        #else
+        setEntryDataHash(*currentEntryP,dataHash);
+        #endif
       }
       else {
         currentEntryP->dataCRC = 0; // clean it for cosmetic reasons only
+        currentEntryP->dataHash = 0;
       }
       // create if entry is new
       if (!chgentryexists) {
@@ -1000,6 +1091,7 @@ localstatus TBinfileImplDS::changeLogPreflight(bool &aValidChangelog)
       existingentries[logindex].flags &= ~chgl_delete_candidate; // no candidate...
       existingentries[logindex].flags |= chgl_deleted; // ..but really deleted
       existingentries[logindex].dataCRC=0; // no CRC any more
+      existingentries[logindex].dataHash=0;
       existingentries[logindex].modcount=fCurrentModCount; // deletion detected now
       PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI,("changeLogPreflight: item with logindex=%ld was not found in datastore -> mark deleted",(long)logindex));
       // this is a local change for this session
@@ -1734,12 +1826,22 @@ localstatus TBinfileImplDS::implGetItem(
             //    it would be suppressed). This is a compromise that minimizes pseudochanges normally, but cannot
             //    entirely prevent them. In other words: the first attempt to report a pseudo-change is
             //    suppressed, but in case this sync fails, subsequent syncs will report it.
+            #ifdef RECORDHASH_FROM_DBAPI
             uInt16 newDataCRC = myitemP->getDataCRC(0,true);
             PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
               "CRC comparison for pseudo-change detection: old CRC=0x%hX, new CRC=0x%hX, recordModCount=%u, currentModCount=%u",
               chglogP->dataCRC, newDataCRC, chglogP->modcount, fCurrentModCount
             ));
-            if (chglogP->dataCRC==newDataCRC && !fSlowSync && chglogP->modcount==fCurrentModCount) {
+            bool dataChanged = chglogP->dataCRC!=newDataCRC;
+            #else
+            uInt64 newDataHash = itemDataHash(myitemP);
+            PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI+DBG_EXOTIC,(
+              "Hash comparison for pseudo-change detection: old hash=0x%016llX, new hash=0x%016llX, recordModCount=%u, currentModCount=%u",
+              (unsigned long long)chglogP->dataHash, (unsigned long long)newDataHash, chglogP->modcount, fCurrentModCount
+            ));
+            bool dataChanged = itemDataChanged(*chglogP,myitemP,newDataHash);
+            #endif
+            if (!dataChanged && !fSlowSync && chglogP->modcount==fCurrentModCount) {
               // none of the relevant fields have changed -> don't report the item
               PDEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI,("Not reporting localID='%s' as changed because CRC detected this as a pseudo-change.",myitemP->getLocalID()));
               aChanged = false; // even if it gets reported, it does not count as changed any more
@@ -1755,7 +1857,11 @@ localstatus TBinfileImplDS::implGetItem(
               // Note: the problem with this is that in case the sync does not succeed now, the CRC is already updated and would
               //   trigger pseudo-change detection in the next session. Therefore, pseudo-change detection is only active for
               //   changes newly detected during this sync.
+              #ifdef RECORDHASH_FROM_DBAPI
               chglogP->dataCRC = newDataCRC;
+              #else
+              setEntryDataHash(*chglogP,newDataHash);
+              #endif
             }
           } // CRC_DETECT_PSEUDOCHANGES
           // - report as replace (changed or not)
@@ -1916,6 +2022,7 @@ localstatus TBinfileImplDS::implStartDataWrite(void)
       for (uInt32 k=0; k<fLoadedChangeLogEntries; k++) {
         fLoadedChangeLog[k].modcount=fCurrentModCount;
         fLoadedChangeLog[k].dataCRC=0;
+        fLoadedChangeLog[k].dataHash=0;
         fLoadedChangeLog[k].flags=chgl_deleted;
       }
     }
@@ -2072,7 +2179,11 @@ bool TBinfileImplDS::implProcessItem(
         goto error;
     } // switch(sop)
     // update changelog
+    #ifdef RECORDHASH_FROM_DBAPI
     uInt16 crc=0; // none unless we need it
+    #else
+    uInt64 hash=0; // none unless we need it
+    #endif
     if (CRC_CHANGE_DETECTION || CRC_DETECT_PSEUDOCHANGES) {
       // - calc new data CRC if not deleted record
       if (sop!=sop_delete) {
@@ -2101,12 +2212,12 @@ bool TBinfileImplDS::implProcessItem(
           //   that the item is gone and will send a delete to server, and
           //   will also find a new item (this one under new localid) and add
           //   this to the server.
-          crc=0;
+          hash=0;
           DEBUGPRINTFX(DBG_ADMIN+DBG_DBAPI,("Item has probably changed its localid during replace, CRC gets invalid"));
         }
         else {
           // Note: we don't need to set localID in item as it is not used in the CRC
-          crc = readbackItemP->getDataCRC(0,true); // start new CRC, do not include eqm_none fields
+          hash = itemDataHash(readbackItemP);
         }
         if (readbackItemP) delete readbackItemP;
         #endif // not RECORDHASH_FROM_DBAPI
@@ -2126,7 +2237,11 @@ bool TBinfileImplDS::implProcessItem(
     }
     // now affectedentryP points to where we need to apply the changed crc and modcount
     // if logindex<0 we need to add the entry to the dbfile afterwards
+    #ifdef RECORDHASH_FROM_DBAPI
     affectedentryP->dataCRC=crc;
+    #else
+    setEntryDataHash(*affectedentryP,hash);
+    #endif
     if (reportAsChangedInNextSync) {
       // make sure NEXT sync will catch this again, as stored version is different
       // from what we received (merged with pre-existing duplicate)
@@ -142,7 +142,7 @@ typedef struct {
 #endif
 #define CHANGELOG_DB_ID 4
 #define LOWEST_CHANGELOG_DB_VERSION 2 // note: step from V2 to V3 was only change in header
-#define CHANGELOG_DB_VERSION 5 // dataCRC added as new field (was present for non-changedetection targets before)
+#define CHANGELOG_DB_VERSION 6 // V5: dataCRC added as new field (was present for non-changedetection targets before), V6: 64 bit dataHash added
 
 
 const uInt16 changeIndentifierMaxLen=128;
@@ -190,6 +190,12 @@ typedef struct {
   // CRC of the record's data after the last modification
   uInt16 dataCRC;
 
+  // Version 6 fields start here
+  // ===========================
+  // 64 bit hash of the record's data after the last modification. If 0, only dataCRC
+  // is valid (entry recorded by V5 or earlier, or checksum delivered by the DB API)
+  uInt64 dataHash;
+
 } TChangeLogEntry;
 
 
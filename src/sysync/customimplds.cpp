@@ -1126,6 +1126,141 @@ localstatus TCustomImplDS::dsAfterStateChange(TLocalEngineDSState aOldState,TLoc
 
 #ifndef BINFILE_ALWAYS_ACTIVE
 
+// TMapContainer
+// =============
+
+// clear all entries and indexes
+void TMapContainer::clear(void)
+{
+  fEntries.clear();
+  fLocalIDIndex.clear();
+  fRemoteIDIndex.clear();
+  fFrontSeq=0;
+  fBackSeq=0;
+} // TMapContainer::clear
+
+
+// add entry at end of list
+void TMapContainer::push_back(const TMapEntry &aEntry)
+{
+  iterator pos = fEntries.insert(fEntries.end(),aEntry);
+  addToIndexes(pos,++fBackSeq);
+} // TMapContainer::push_back
+
+
+// add entry at beginning of list
+void TMapContainer::push_front(const TMapEntry &aEntry)
+{
+  iterator pos = fEntries.insert(fEntries.begin(),aEntry);
+  addToIndexes(pos,--fFrontSeq);
+} // TMapContainer::push_front
+
+
+// remove entry
+void TMapContainer::erase(iterator aPos)
+{
+  removeFromIndex(fLocalIDIndex,(*aPos).localid,aPos);
+  removeFromIndex(fRemoteIDIndex,(*aPos).remoteid,aPos);
+  fEntries.erase(aPos);
+} // TMapContainer::erase
+
+
+// find first entry (in list order) with given localid and entry type
+TMapContainer::iterator TMapContainer::findByLocalID(const char *aLocalID, TMapEntryType aEntryType, bool aDeletedAsWell)
+{
+  iterator found = fEntries.end();
+  if (aLocalID) {
+    sInt32 foundSeq = 0;
+    pair<TMapIndex::iterator,TMapIndex::iterator> range = fLocalIDIndex.equal_range(aLocalID);
+    for (TMapIndex::iterator ipos=range.first; ipos!=range.second; ++ipos) {
+      const TMapEntry &entry = *(ipos->second.pos);
+      if (
+        entry.entrytype==aEntryType &&
+        (aDeletedAsWell || !entry.deleted) && // if selected, don't show deleted entries
+        (found==fEntries.end() || ipos->second.seq<foundSeq) // earlier in list than what we found so far
+      ) {
+        found = ipos->second.pos;
+        foundSeq = ipos->second.seq;
+      }
+    }
+  }
+  return found;
+} // TMapContainer::findByLocalID
+
+
+// find first normal, non-deleted entry (in list order) with given remoteid
+TMapContainer::iterator TMapContainer::findByRemoteID(const char *aRemoteID)
+{
+  iterator found = fEntries.end();
+  if (aRemoteID) {
+    sInt32 foundSeq = 0;
+    pair<TMapIndex::iterator,TMapIndex::iterator> range = fRemoteIDIndex.equal_range(aRemoteID);
+    for (TMapIndex::iterator ipos=range.first; ipos!=range.second; ++ipos) {
+      const TMapEntry &entry = *(ipos->second.pos);
+      if (
+        entry.entrytype==mapentry_normal && !entry.deleted && // only plain normal non-deleted maps (no tempid or mapforresume)
+        (found==fEntries.end() || ipos->second.seq<foundSeq) // earlier in list than what we found so far
+      ) {
+        found = ipos->second.pos;
+        foundSeq = ipos->second.seq;
+      }
+    }
+  }
+  return found;
+} // TMapContainer::findByRemoteID
+
+
+// get all entries of given type with given remoteid (deleted ones as well)
+void TMapContainer::findAllByRemoteID(const char *aRemoteID, TMapEntryType aEntryType, list<iterator> &aEntries)
+{
+  aEntries.clear();
+  if (!aRemoteID) return;
+  pair<TMapIndex::iterator,TMapIndex::iterator> range = fRemoteIDIndex.equal_range(aRemoteID);
+  for (TMapIndex::iterator ipos=range.first; ipos!=range.second; ++ipos) {
+    if ((*(ipos->second.pos)).entrytype==aEntryType)
+      aEntries.push_back(ipos->second.pos);
+  }
+} // TMapContainer::findAllByRemoteID
+
+
+// change remoteid of an entry, keeping the index in sync
+void TMapContainer::setRemoteID(iterator aPos, const char *aRemoteID)
+{
+  sInt32 seq = 0;
+  removeFromIndex(fRemoteIDIndex,(*aPos).remoteid,aPos,&seq);
+  AssignString((*aPos).remoteid,aRemoteID); // NULL sets empty remoteid
+  TMapIndexEntry ie;
+  ie.pos = aPos;
+  ie.seq = seq;
+  fRemoteIDIndex.insert(TMapIndex::value_type((*aPos).remoteid,ie));
+} // TMapContainer::setRemoteID
+
+
+// add new list entry to both indexes
+void TMapContainer::addToIndexes(iterator aPos, sInt32 aSeq)
+{
+  TMapIndexEntry ie;
+  ie.pos = aPos;
+  ie.seq = aSeq;
+  fLocalIDIndex.insert(TMapIndex::value_type((*aPos).localid,ie));
+  fRemoteIDIndex.insert(TMapIndex::value_type((*aPos).remoteid,ie));
+} // TMapContainer::addToIndexes
+
+
+// remove list entry from index, optionally returning its seq
+void TMapContainer::removeFromIndex(TMapIndex &aIndex, const string &aKey, iterator aPos, sInt32 *aSeqP)
+{
+  pair<TMapIndex::iterator,TMapIndex::iterator> range = aIndex.equal_range(aKey);
+  for (TMapIndex::iterator ipos=range.first; ipos!=range.second; ++ipos) {
+    if (ipos->second.pos==aPos) {
+      if (aSeqP) *aSeqP = ipos->second.seq;
+      aIndex.erase(ipos);
+      return;
+    }
+  }
+} // TMapContainer::removeFromIndex
+
+
 // mark all map entries as deleted
 bool TCustomImplDS::deleteAllMaps(void)
 {
@@ -1144,38 +1279,16 @@ bool TCustomImplDS::deleteAllMaps(void)
 // find non-deleted map entry by local ID/maptype
 TMapContainer::iterator TCustomImplDS::findMapByLocalID(const char *aLocalID,TMapEntryType aEntryType, bool aDeletedAsWell)
 {
-  TMapContainer::iterator pos;
-  if (aLocalID) {
-    for (pos=fMapTable.begin();pos!=fMapTable.end();pos++) {
-      if (
-        (*pos).localid==aLocalID && (*pos).entrytype==aEntryType
-        // && !(*pos).remoteid.empty() // Note: was ok in old versions, but now we can have map entries from resume with empty localID
-        && (aDeletedAsWell || !(*pos).deleted) // if selected, don't show deleted entries
-      ) {
-        // found
-        return pos;
-      }
-    }
-  }
-  return fMapTable.end();
+  // Note: was restricted to entries with non-empty remoteid in old versions, but now we can have map entries from resume with empty localID
+  return fMapTable.findByLocalID(aLocalID,aEntryType,aDeletedAsWell);
 } // TCustomImplDS::findMapByLocalID
 
 
 // find map entry by remote ID
 TMapContainer::iterator TCustomImplDS::findMapByRemoteID(const char *aRemoteID)
 {
-  TMapContainer::iterator pos;
-  if (aRemoteID) {
-    for (pos=fMapTable.begin();pos!=fMapTable.end();pos++) {
-      if (
-        (*pos).remoteid==aRemoteID && (*pos).entrytype == mapentry_normal && !(*pos).deleted // only plain normal non-deleted maps (no tempid or mapforresume)
-      ) {
-        // found
-        return pos;
-      }
-    }
-  }
-  return fMapTable.end();
+  // only plain normal non-deleted maps (no tempid or mapforresume)
+  return fMapTable.findByRemoteID(aRemoteID);
 } // TCustomImplDS::findMapByRemoteID
 
 
@@ -1229,24 +1342,20 @@ void TCustomImplDS::modifyMap(TMapEntryType aEntryType, const char *aLocalID, co
   ));
   // - if there is a localID, search map entry (even if it is deleted)
   if (aLocalID && *aLocalID!=0) {
-    for (pos=fMapTable.begin();pos!=fMapTable.end();pos++) {
-      if (
-        // localID and entrytype matches
-        (*pos).localid==aLocalID && (*pos).entrytype==aEntryType
-      ) {
-        PDEBUGPRINTFX(DBG_ADMIN+DBG_EXOTIC,(
-          "- found entry by entrytype/localID='%s' - remoteid='%s', mapflags=0x%lX, changed=%d, deleted=%d, added=%d, markforresume=%d, savedmark=%d",
-          aLocalID,
-          (*pos).remoteid.c_str(),
-          (long)(*pos).mapflags,
-          (int)(*pos).changed,
-          (int)(*pos).deleted,
-          (int)(*pos).added,
-          (int)(*pos).markforresume,
-          (int)(*pos).savedmark
-        ));
-        break;
-      }
+    // localID and entrytype matches
+    pos=fMapTable.findByLocalID(aLocalID,aEntryType,true);
+    if (pos!=fMapTable.end()) {
+      PDEBUGPRINTFX(DBG_ADMIN+DBG_EXOTIC,(
+        "- found entry by entrytype/localID='%s' - remoteid='%s', mapflags=0x%lX, changed=%d, deleted=%d, added=%d, markforresume=%d, savedmark=%d",
+        aLocalID,
+        (*pos).remoteid.c_str(),
+        (long)(*pos).mapflags,
+        (int)(*pos).changed,
+        (int)(*pos).deleted,
+        (int)(*pos).added,
+        (int)(*pos).markforresume,
+        (int)(*pos).savedmark
+      ));
     }
   }
   else aLocalID=NULL;
@@ -1323,7 +1432,7 @@ void TCustomImplDS::modifyMap(TMapEntryType aEntryType, const char *aLocalID, co
       ) {
         // new RemoteID (but not NULL = keep existing) or different mapflags were passed -> this is a real change
         if (aRemoteID)
-          (*pos).remoteid=aRemoteID;
+          fMapTable.setRemoteID(pos,aRemoteID);
         (*pos).changed=true; // really changed compared to what is already in DB
       }
     }
@@ -1334,9 +1443,12 @@ void TCustomImplDS::modifyMap(TMapEntryType aEntryType, const char *aLocalID, co
     // now remove all other items with same remoteID (except if we have no or empty remoteID)
     if (aEntryType==mapentry_normal && aRemoteID && *aRemoteID) {
       // %%% note: this is strictly necessary only for add, but cleans up for update
-      TMapContainer::iterator pos2;
-      for (pos2=fMapTable.begin();pos2!=fMapTable.end();pos2++) {
-        if (pos2!=pos && (*pos2).remoteid==aRemoteID && (*pos2).entrytype==aEntryType) {
+      list<TMapContainer::iterator> sameRemoteID;
+      fMapTable.findAllByRemoteID(aRemoteID,aEntryType,sameRemoteID);
+      list<TMapContainer::iterator>::iterator spos;
+      for (spos=sameRemoteID.begin();spos!=sameRemoteID.end();spos++) {
+        TMapContainer::iterator pos2 = *spos;
+        if (pos2!=pos) {
           // found another one with same remoteID/entrytype
           PDEBUGPRINTFX(DBG_ADMIN+DBG_EXOTIC,(
             "- cleanup: removing same remoteID from other entry with localid='%s', mapflags=0x%lX, changed=%d, deleted=%d, added=%d, markforresume=%d, savedmark=%d",
@@ -1349,7 +1461,7 @@ void TCustomImplDS::modifyMap(TMapEntryType aEntryType, const char *aLocalID, co
             (int)(*pos2).savedmark
           ));
           // this remoteID is invalid for sure as we just have assigned it to another item - remove it
-          (*pos2).remoteid.erase();
+          fMapTable.setRemoteID(pos2,NULL);
           (*pos2).changed=true; // make sure it gets saved
         }
       }
@@ -1376,10 +1488,23 @@ void TCustomImplDS::DeleteSyncSet(bool aContentsOnly)
     if (!aContentsOnly)
       delete (*pos); // delete syncsetitem itself
   }
-  if (!aContentsOnly) fSyncSetList.clear();
+  if (!aContentsOnly) {
+    fSyncSetList.clear();
+    fSyncSetIndex.clear();
+  }
 } // TCustomImplDS::DeleteSyncSet
 
 
+// add entry to sync set
+// - syncset takes ownership of the entry
+void TCustomImplDS::addToSyncSet(TSyncSetItem *aSyncSetItemP)
+{
+  TSyncSetList::iterator pos = fSyncSetList.insert(fSyncSetList.end(),aSyncSetItemP);
+  // index it, first entry wins in case of duplicate localids (as with a linear search)
+  fSyncSetIndex.insert(TSyncSetIndex::value_type(aSyncSetItemP->localid,pos));
+} // TCustomImplDS::addToSyncSet
+
+
 // - get container ID for specified localid
 bool TCustomImplDS::getContainerID(const char *aLocalID, string &aContainerID)
 {
@@ -1395,12 +1520,10 @@ bool TCustomImplDS::getContainerID(const char *aLocalID, string &aContainerID)
 // find entry in sync set by localid
 TSyncSetList::iterator TCustomImplDS::findInSyncSet(const char *aLocalID)
 {
-  TSyncSetList::iterator pos;
-  for (pos=fSyncSetList.begin();pos!=fSyncSetList.end();pos++) {
-    if ((*pos)->localid==aLocalID) {
-      // found
-      return pos;
-    }
+  TSyncSetIndex::iterator pos = fSyncSetIndex.find(aLocalID);
+  if (pos!=fSyncSetIndex.end()) {
+    // found
+    return pos->second;
   }
   return fSyncSetList.end();
 } // TCustomImplDS::findInSyncSet
@@ -1878,7 +2001,7 @@ void TCustomImplDS::implMarkOnlyUngeneratedForResume(void)
           // add flag to existing map item
           if ((*pos).deleted) {
             // undelete (re-use existing, but currently invalid entry)
-            (*pos).remoteid.erase();
+            fMapTable.setRemoteID(pos,NULL);
             (*pos).changed=true;
             (*pos).deleted=false;
             (*pos).mapflags=0;
@@ -2022,7 +2145,7 @@ void TCustomImplDS::implMarkItemForResume(cAppCharP aLocalID, cAppCharP aRemoteI
     // we have an entry for this item, mark it for resume
     if ((*pos).deleted) {
       // undelete (re-use existing, but currently invalid entry)
-      (*pos).remoteid.erase();
+      fMapTable.setRemoteID(pos,NULL);
       (*pos).changed=true;
       (*pos).deleted=false;
       (*pos).mapflags=0;
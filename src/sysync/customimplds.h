@@ -310,7 +310,48 @@ typedef struct {
 
 
 // container for map entries
-typedef list<TMapEntry> TMapContainer;
+// - behaves like a list<TMapEntry>, but keeps an index by localid and another one by remoteid
+//   to allow finding entries without scanning the entire map table.
+// - localid of entries in the container must not be modified, and remoteid must only
+//   be modified via setRemoteID(), otherwise the index gets out of sync.
+class TMapContainer {
+public:
+  typedef list<TMapEntry> TMapEntryList;
+  typedef TMapEntryList::iterator iterator;
+  TMapContainer() : fFrontSeq(0), fBackSeq(0) {};
+  // list-like access
+  iterator begin(void) { return fEntries.begin(); };
+  iterator end(void) { return fEntries.end(); };
+  size_t size(void) const { return fEntries.size(); };
+  bool empty(void) const { return fEntries.empty(); };
+  void clear(void);
+  void push_back(const TMapEntry &aEntry);
+  void push_front(const TMapEntry &aEntry);
+  void erase(iterator aPos);
+  // indexed access
+  // - find first entry (in list order) with given localid and entry type, possibly skipping deleted ones
+  iterator findByLocalID(const char *aLocalID, TMapEntryType aEntryType, bool aDeletedAsWell);
+  // - find first normal, non-deleted entry (in list order) with given remoteid
+  iterator findByRemoteID(const char *aRemoteID);
+  // - get all entries of given type with given remoteid (deleted ones as well)
+  void findAllByRemoteID(const char *aRemoteID, TMapEntryType aEntryType, list<iterator> &aEntries);
+  // - change remoteid of an entry
+  void setRemoteID(iterator aPos, const char *aRemoteID);
+private:
+  // index entries refer to list entries, seq represents list order
+  typedef struct {
+    iterator pos;
+    sInt32 seq;
+  } TMapIndexEntry;
+  typedef multimap<string,TMapIndexEntry> TMapIndex;
+  void addToIndexes(iterator aPos, sInt32 aSeq);
+  static void removeFromIndex(TMapIndex &aIndex, const string &aKey, iterator aPos, sInt32 *aSeqP=NULL);
+  TMapEntryList fEntries; ///< the map entries
+  TMapIndex fLocalIDIndex; ///< index by localid
+  TMapIndex fRemoteIDIndex; ///< index by remoteid
+  sInt32 fFrontSeq; ///< seq of first entry (decremented by push_front)
+  sInt32 fBackSeq; ///< seq of last entry (incremented by push_back)
+}; // TMapContainer
 
 #endif // BINFILE_ALWAYS_ACTIVE
 
@@ -329,6 +370,9 @@ typedef struct {
 // container for sync set information
 typedef list<TSyncSetItem *> TSyncSetList;
 
+// index into sync set by localid
+typedef map<string,TSyncSetList::iterator> TSyncSetIndex;
+
 // container for finalisation
 typedef list<TMultiFieldItem *> TMultiFieldItemList;
 
@@ -773,6 +817,8 @@ protected:
   bool getContainerID(const char *aLocalID, string &aContainerID);
   // - delete sync set one by one
   localstatus zapSyncSetOneByOne(void);
+  // - add entry to sync set (takes ownership of the entry, keeps localid index up to date)
+  void addToSyncSet(TSyncSetItem *aSyncSetItemP);
   // - Queue the data needed for finalisation (usually - relational link updates)
   //   as a item copy with only finalisation-required fields
   void queueForFinalisation(TMultiFieldItem *aItemP);
@@ -804,6 +850,8 @@ protected:
   string fFolderKey;
   // local list of local IDs/mod timestamps of current sync set for speedup and avoiding LEFT OUTER JOIN
   TSyncSetList fSyncSetList;
+  // - index by localid into fSyncSetList (maintained by addToSyncSet() and DeleteSyncSet())
+  TSyncSetIndex fSyncSetIndex;
   // - iterator for reporting new and added items in GetItem
   TSyncSetList::iterator fSyncSetPos;
   // - list of items that must be processed in finalisation at end of sync
@@ -337,6 +337,15 @@ uInt16 TArrayField::getDataCRC(uInt16 crc)
   }
   return crc;
 } // TArrayField::getDataCRC
+
+// calc 64 bit hash over all fields
+uInt64 TArrayField::getDataHash(uInt64 hash)
+{
+  for (sInt16 idx=0; idx<arraySize(); idx++) {
+    hash=getArrayField(idx)->getDataHash(hash);
+  }
+  return hash;
+} // TArrayField::getDataHash
 #endif
 
 
@@ -531,6 +540,14 @@ uInt16 TStringField::getDataCRC(uInt16 crc)
   return sysync_crc16_block(getCStr(),getStringSize(),crc);
 } // TStringField::getDataCRC
 
+
+// changelog support: calculate 64 bit hash over contents
+uInt64 TStringField::getDataHash(uInt64 hash)
+{
+  // hash over string buffer as a whole
+  return sysync_hash64_block(getCStr(),getStringSize(),hash);
+} // TStringField::getDataHash
+
 #endif
 
 
@@ -1109,6 +1126,23 @@ uInt16 TTimestampField::getDataCRC(uInt16 crc)
   return sysync_crc16_block(&crcctx,sizeof(crcctx),crc);
 } // TTimestampField::getDataCRC
 
+
+// changelog support: calculate 64 bit hash over contents
+uInt64 TTimestampField::getDataHash(uInt64 hash)
+{
+  // same normalisation as for CRC (system time zone changes must not change the hash)
+  lineartime_t hts = fTimestamp;
+  timecontext_t hctx = fTimecontext;
+  if (TCTX_IS_SYSTEM(hctx)) {
+    if (TzConvertTimestamp(hts,hctx,TCTX_UTC,fGZonesP))
+      hctx=TCTX_UTC;
+  }
+  if (TCTX_IS_UTC(hctx)) hctx=0;
+  // hash over timestamp itself and zone offset
+  hash=sysync_hash64_block(&hts,sizeof(hts),hash);
+  return sysync_hash64_block(&hctx,sizeof(hctx),hash);
+} // TTimestampField::getDataHash
+
 #endif
 
 
@@ -1695,6 +1729,14 @@ uInt16 TIntegerField::getDataCRC(uInt16 crc)
   return sysync_crc16_block(&fInteger,sizeof(fInteger),crc);
 } // TIntegerField::getDataCRC
 
+
+// changelog support: calculate 64 bit hash over contents
+uInt64 TIntegerField::getDataHash(uInt64 hash)
+{
+  // hash over integer number
+  return sysync_hash64_block(&fInteger,sizeof(fInteger),hash);
+} // TIntegerField::getDataHash
+
 #endif
 
 
@@ -70,6 +70,7 @@ public:
   // changelog support
   #if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
   virtual uInt16 getDataCRC(uInt16 crc=0) { return crc; }; // base class is always empty
+  virtual uInt64 getDataHash(uInt64 hash=0) { return hash; }; // base class is always empty
   #endif
   // access to type
   virtual TItemFieldTypes getType(void) const { return fty_none; } // no real type
@@ -175,6 +176,7 @@ public:
   // changelog support
   #if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
   virtual uInt16 getDataCRC(uInt16 crc=0);
+  virtual uInt64 getDataHash(uInt64 hash=0);
   #endif
   // access to type
   virtual TItemFieldTypes getType(void) const { return fty_none; } // array has no type
@@ -270,6 +272,7 @@ public:
   // changelog support
   #if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
   virtual uInt16 getDataCRC(uInt16 crc=0);
+  virtual uInt64 getDataHash(uInt64 hash=0);
   #endif
   // assignment
   virtual TItemField& operator=(TItemField &aItemField);
@@ -450,6 +453,7 @@ public:
   // changelog support
   #if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
   virtual uInt16 getDataCRC(uInt16 crc=0);
+  virtual uInt64 getDataHash(uInt64 hash=0);
   #endif
   // access to field contents
   virtual void setAsString(cAppCharP aString);
@@ -587,6 +591,7 @@ public:
   // changelog support
   #if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
   virtual uInt16 getDataCRC(uInt16 crc=0);
+  virtual uInt64 getDataHash(uInt64 hash=0);
   #endif
   // access to field contents
   // - as string
@@ -1182,6 +1182,9 @@ void TLocalEngineDS::InternalResetDataStore(void)
   fLocalAbortCause=true; // assume local cause
   fRemoteAddingStopped=false;
   fAlertCode=0; // not yet alerted
+  #ifdef MULTI_THREAD_SUPPORT
+  discardPreparedItems(); // no items converted ahead
+  #endif
 
   /// Init Sync mode @ref dsSyncMode
   fSyncMode=smo_twoway; // default to twoway
@@ -4173,6 +4176,23 @@ void TLocalEngineDS::engServerStartOfSyncMessage(void)
 } // TLocalEngineDS::engServerStartOfSyncMessage
 
 
+#ifdef MULTI_THREAD_SUPPORT
+
+// server only: true if datastore is generating sync commands and can convert items ahead
+bool TLocalEngineDS::engCanPrepareSyncCommands(void)
+{
+  return
+    !isAborted() &&
+    !isSubDatastore() && // subdatastores' items get a prefix from their superdatastore
+    fRemoteDatastoreP &&
+    getRemoteReceiveType() &&
+    testState(dssta_serversyncgenstarted) &&
+    !testState(dssta_syncgendone);
+} // TLocalEngineDS::engCanPrepareSyncCommands
+
+#endif
+
+
 #endif // server only
 
 
@@ -4731,7 +4751,62 @@ TSyncOpCommand *TLocalEngineDS::newSyncOpCommand(
   SmlPcdataPtr_t metaP = newMetaType(aSyncItemTypeP->getTypeName());
   // create command
   TSyncOpCommand *syncopcmdP = new TSyncOpCommand(fSessionP,this,syncop,metaP);
-  // make sure item does not have stuff it is not allowed to have
+  SmlItemPtr_t itemP = NULL;
+  #ifdef MULTI_THREAD_SUPPORT
+  // use item already converted by engPrepareSyncCommands(), if any (this also adjusts the item's IDs)
+  if (!aLocalIDPrefix || !*aLocalIDPrefix)
+    itemP = takePreparedItem(aSyncItemP);
+  if (!itemP)
+  #endif
+  {
+    // make sure item does not have stuff it is not allowed to have
+    adjustItemIDsForRemote(aSyncItemP,aLocalIDPrefix);
+    #ifdef SYSYNC_TARGET_OPTIONS
+    // init item generation variables
+    fItemSizeLimit=fSizeLimit;
+    #else
+    fItemSizeLimit=-1; // no limit
+    #endif
+    // now add item
+    itemP = aSyncItemTypeP->newSmlItem(aSyncItemP,this);
+  }
+  // check if data size is ok
+  if (itemP && fSessionP->fMaxOutgoingObjSize) {
+    if (itemP->data && itemP->data->content && itemP->data->length) {
+      // there is data, check if size is ok
+      if (itemP->data->length > (MemSize_t)fSessionP->fMaxOutgoingObjSize) {
+        // too large, suppress it
+        PDEBUGPRINTFX(DBG_ERROR,(
+          "WARNING: outgoing item is larger (%ld) than MaxObjSize (%ld) of remote -> suppress now/mark for resend",
+          (long)itemP->data->length,
+          (long)fSessionP->fMaxOutgoingObjSize
+        ));
+        smlFreeItemPtr(itemP);
+        itemP=NULL;
+        // mark item for resend
+        // For datastores without resume support, this will just have no effect at all
+        engMarkItemForResend(aSyncItemP->getLocalID(),aSyncItemP->getRemoteID());
+      }
+    }
+  }
+  if (itemP) {
+    // add it to the command
+    syncopcmdP->addItem(itemP);
+  }
+  else {
+    // no item - command is invalid, delete it
+    delete syncopcmdP;
+    syncopcmdP=NULL;
+  }
+  // return command
+  return syncopcmdP;
+} // TLocalEngineDS::newSyncOpCommand
+
+
+// adjust IDs of item to what must be sent to remote
+void TLocalEngineDS::adjustItemIDsForRemote(TSyncItem *aSyncItemP, cAppCharP aLocalIDPrefix)
+{
+  TSyncOperation syncop=aSyncItemP->getSyncOp();
   // %%% SCTS does not like SourceURI in Replace and Delete commands sent to Client
   // there are the only ones allowed to carry a GUID
   if (IS_SERVER) {
@@ -4782,45 +4857,78 @@ TSyncOpCommand *TLocalEngineDS::newSyncOpCommand(
     if (aLocalIDPrefix && *aLocalIDPrefix)
       aSyncItemP->fLocalID.insert(0,aLocalIDPrefix);
   }
+} // TLocalEngineDS::adjustItemIDsForRemote
+
+
+#ifdef MULTI_THREAD_SUPPORT
+
+// convert item for sending ahead of creating its sync op command
+bool TLocalEngineDS::prepareItemForRemote(TSyncItem *aSyncItemP, TSyncItemType *aSyncItemTypeP)
+{
+  if (isPreparedItem(aSyncItemP)) return true; // already done
+  TPreparedItem prepared;
+  prepared.fItemP = NULL;
+  // convert with IDs as they will be sent, but leave the item itself unchanged until it is actually sent
+  // (resume marks need the original IDs)
+  string localID = aSyncItemP->fLocalID;
+  string remoteID = aSyncItemP->fRemoteID;
+  adjustItemIDsForRemote(aSyncItemP,NULL);
+  prepared.fLocalID = aSyncItemP->fLocalID;
+  prepared.fRemoteID = aSyncItemP->fRemoteID;
   #ifdef SYSYNC_TARGET_OPTIONS
-  // init item generation variables
   fItemSizeLimit=fSizeLimit;
   #else
   fItemSizeLimit=-1; // no limit
   #endif
-  // now add item
-  SmlItemPtr_t itemP = aSyncItemTypeP->newSmlItem(aSyncItemP,this);
-  // check if data size is ok
-  if (itemP && fSessionP->fMaxOutgoingObjSize) {
-    if (itemP->data && itemP->data->content && itemP->data->length) {
-      // there is data, check if size is ok
-      if (itemP->data->length > (MemSize_t)fSessionP->fMaxOutgoingObjSize) {
-        // too large, suppress it
-        PDEBUGPRINTFX(DBG_ERROR,(
-          "WARNING: outgoing item is larger (%ld) than MaxObjSize (%ld) of remote -> suppress now/mark for resend",
-          (long)itemP->data->length,
-          (long)fSessionP->fMaxOutgoingObjSize
-        ));
-        smlFreeItemPtr(itemP);
-        itemP=NULL;
-        // mark item for resend
-        // For datastores without resume support, this will just have no effect at all
-        engMarkItemForResend(aSyncItemP->getLocalID(),aSyncItemP->getRemoteID());
-      }
-    }
-  }
-  if (itemP) {
-    // add it to the command
-    syncopcmdP->addItem(itemP);
-  }
-  else {
-    // no item - command is invalid, delete it
-    delete syncopcmdP;
-    syncopcmdP=NULL;
+  SYSYNC_TRY {
+    prepared.fItemP = aSyncItemTypeP->newSmlItem(aSyncItemP,this);
   }
-  // return command
-  return syncopcmdP;
-} // TLocalEngineDS::newSyncOpCommand
+  SYSYNC_CATCH (...)
+    // leave it to newSyncOpCommand() to convert it again and report the problem
+    prepared.fItemP = NULL;
+  SYSYNC_ENDCATCH
+  aSyncItemP->fLocalID = localID;
+  aSyncItemP->fRemoteID = remoteID;
+  if (!prepared.fItemP) return false;
+  fPreparedItems[aSyncItemP] = prepared;
+  return true;
+} // TLocalEngineDS::prepareItemForRemote
+
+
+// get converted item (and remove it from the prepared items), NULL if none
+SmlItemPtr_t TLocalEngineDS::takePreparedItem(TSyncItem *aSyncItemP)
+{
+  TPreparedItemsMap::iterator pos = fPreparedItems.find(aSyncItemP);
+  if (pos==fPreparedItems.end()) return NULL;
+  SmlItemPtr_t itemP = pos->second.fItemP;
+  // item now gets the IDs it was converted with
+  aSyncItemP->fLocalID = pos->second.fLocalID;
+  aSyncItemP->fRemoteID = pos->second.fRemoteID;
+  fPreparedItems.erase(pos);
+  return itemP;
+} // TLocalEngineDS::takePreparedItem
+
+
+// forget converted item
+void TLocalEngineDS::discardPreparedItem(TSyncItem *aSyncItemP)
+{
+  TPreparedItemsMap::iterator pos = fPreparedItems.find(aSyncItemP);
+  if (pos==fPreparedItems.end()) return;
+  smlFreeItemPtr(pos->second.fItemP);
+  fPreparedItems.erase(pos);
+} // TLocalEngineDS::discardPreparedItem
+
+
+// forget all converted items
+void TLocalEngineDS::discardPreparedItems(void)
+{
+  TPreparedItemsMap::iterator pos;
+  for (pos=fPreparedItems.begin(); pos!=fPreparedItems.end(); ++pos)
+    smlFreeItemPtr(pos->second.fItemP);
+  fPreparedItems.clear();
+} // TLocalEngineDS::discardPreparedItems
+
+#endif // MULTI_THREAD_SUPPORT
 
 
 // create SyncItem suitable for being sent from local to remote
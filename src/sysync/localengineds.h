@@ -441,6 +441,15 @@ protected:
   /// @note can be modified by datastoreinitscript
   TConflictResolution fSessionConflictStrategy;
   fieldinteger_t fItemSizeLimit; ///< size limit for item being processed or generated (initally=fSizeLimit) but can be changed by scripts
+  #ifdef MULTI_THREAD_SUPPORT
+  typedef struct {
+    SmlItemPtr_t fItemP; ///< the converted item
+    string fLocalID; ///< localID as sent
+    string fRemoteID; ///< remoteID as sent
+  } TPreparedItem;
+  typedef std::map<TSyncItem *, TPreparedItem> TPreparedItemsMap;
+  TPreparedItemsMap fPreparedItems; ///< items already converted for sending, by the TSyncItem they were converted from
+  #endif
   TSyncOperation fEchoItemOp; ///< if not sop_none, processed item will be echoed back to remote
   TSyncOperation fCurrentSyncOp; ///< current sync-operation
   TConflictResolution fItemConflictStrategy; ///< conflict strategy for currently processed item
@@ -760,6 +769,14 @@ public:
   /// called to process map commands from client to server
   /// @note aLocalID or aRemoteID can be NULL - which signifies deletion of a map entry
   SUPERDS_VIRTUAL localstatus engProcessMap(cAppCharP aRemoteID, cAppCharP aLocalID);
+  #ifdef MULTI_THREAD_SUPPORT
+  /// server only: true if datastore is generating sync commands and can convert items ahead
+  bool engCanPrepareSyncCommands(void);
+  /// server only: convert up to aMaxItems of the items to be sent next into SyncML items ahead
+  /// of generating sync commands
+  /// @note called from a worker thread while the session waits, see TSyncSession::prepareSyncCommands()
+  void engPrepareSyncCommands(uInt32 aMaxItems) { logicPrepareSyncCommandsAsServer(aMaxItems); };
+  #endif
   #endif // SYSYNC_SERVER
   /// check is datastore is completely started.
   /// @param[in] aWait if set, call will not return until either started state is reached
@@ -1070,6 +1087,10 @@ protected:
     TSmlCommand * &aInterruptedCommandP,
     const char *aLocalIDPrefix=NULL
   ) = 0;
+  #ifdef MULTI_THREAD_SUPPORT
+  /// server: called to convert items ahead of logicGenerateSyncCommandsAsServer(), see engPrepareSyncCommands()
+  virtual void logicPrepareSyncCommandsAsServer(uInt32 aMaxItems) {};
+  #endif
   #endif
   /// called to have all non-yet-generated sync commands as "to-be-resumed"
   virtual void logicMarkOnlyUngeneratedForResume(void) = 0;
@@ -1150,6 +1171,25 @@ protected:
     TSyncItemType *aSyncItemTypeP, // the sync item type
     cAppCharP aLocalIDPrefix // prefix for localID (can be NULL for none)
   );
+  /// adjust IDs of item to what must be sent to remote
+  void adjustItemIDsForRemote(TSyncItem *aSyncItemP, cAppCharP aLocalIDPrefix);
+  #ifdef MULTI_THREAD_SUPPORT
+  /// @name outgoing items converted ahead of generating their sync op commands (see engPrepareSyncCommands())
+  /// @{
+  /// convert item ahead, returns false if item could not be converted
+  /// @note aSyncItemP itself remains unchanged (IDs are adjusted again by newSyncOpCommand())
+  bool prepareItemForRemote(TSyncItem *aSyncItemP, TSyncItemType *aSyncItemTypeP);
+  /// check if item was already converted
+  bool isPreparedItem(TSyncItem *aSyncItemP) { return fPreparedItems.find(aSyncItemP)!=fPreparedItems.end(); };
+  /// get converted item (and remove it from the prepared items), NULL if none
+  /// @note sets IDs of aSyncItemP to those the item was converted with
+  SmlItemPtr_t takePreparedItem(TSyncItem *aSyncItemP);
+  /// forget converted item, must be called before deleting a TSyncItem that might have been prepared
+  void discardPreparedItem(TSyncItem *aSyncItemP);
+  /// forget all converted items
+  void discardPreparedItems(void);
+  /// @}
+  #endif
   /// return pure relative (item) URI (removes absolute part or ./ prefix)
   /// @note this one is virtual because it is defined in TSyncDataStore
   virtual cAppCharP DatastoreRelativeURI(cAppCharP aURI);
@@ -1930,6 +1930,18 @@ static void decodeValue(
       // decode standard content
       c=*p;
       if (isEndOfLineOrText(c) || (!escaped && aStructSep!=0 && (c==aStructSep || c==aAltSep))) break; // EOLN and struct separators terminate value
+      if (aCharset==chs_utf8 && c!='=' && c!='\\') {
+        // UTF-8 needs no conversion: copy the run of plain chars up to the next escape,
+        // line end or separator directly from the input (as in the unencoded case below)
+        q=p+1;
+        while (!isEndOfLineOrText(*q) && *q!='=' && *q!='\\' && (aStructSep==0 || (*q!=aStructSep && *q!=aAltSep)))
+          q++;
+        aVal.append(p,q-p);
+        escaped=false;
+        lastWasQPCR=false;
+        p=skipfolded(q,aMimeMode,true); // same as nextunfolded() from last char of the run
+        continue;
+      }
       // test if escape char (but do not filter it out, as actual de-escaping is done in parseValue() later
       escaped=(!escaped) && (c=='\\'); // escape next only if we are not escaped already
       // char found
@@ -2019,10 +2031,7 @@ static void decodeValue(
         q++;
     }
     // - decode base 64
-    uInt32 binsz=0;
-    uInt8 *binP = b64::decode(p, q-p, &binsz);
-    aVal.append((const char *)binP,binsz);
-    b64::free(binP);
+    b64::appendDecoded(aVal, p, q-p);
     // - continue at next char after b64 value
     p=q;
   }
@@ -2032,6 +2041,17 @@ static void decodeValue(
     do {
       c=*p;
       if (isEndOfLineOrText(c) || (!escaped && aStructSep!=0 && (c==aStructSep || c==aAltSep))) break; // EOLN and structure-sep (usually ;) terminate value
+      if (aCharset==chs_utf8 && c!='\\') {
+        // UTF-8 needs no conversion, and folding can only occur at line ends: copy the run of
+        // plain chars up to the next line end, escape or separator directly from the input
+        q=p+1;
+        while (!isEndOfLineOrText(*q) && *q!='\\' && (aStructSep==0 || (*q!=aStructSep && *q!=aAltSep)))
+          q++;
+        aVal.append(p,q-p);
+        escaped=false;
+        p=skipfolded(q,aMimeMode,false); // same as nextunfolded() from last char of the run
+        continue;
+      }
       // test if escape char (but do not filter it out, as actual de-escaping is done in parseValue() later
       escaped=(!escaped) && (c=='\\'); // escape next only if we are not escaped already
       // process char
@@ -3707,7 +3727,9 @@ bool TMimeDirProfileHandler::parseValue(
 {
   string val,val2;
   char c;
-  const char *p;
+  const char *p,*q;
+  const char *valP; // value to be stored, either in place in aText or in val
+  size_t valSz;
 
   // determine field ID
   sInt16 fid=aConvDefP->fieldid;
@@ -3737,32 +3759,43 @@ bool TMimeDirProfileHandler::parseValue(
       while (*p) {
         // value list loop
         // - get next value
-        val.erase();
-        while ((c=*p)!=0) {
-          // check for field list separator (if field allows list at all)
-          if (c==aSeparator && aConvDefP->combineSep) {
-            p++; // skip separator
-            break;
-          }
-          // check for escaped chars
-          if (!aParamValue && c=='\\') {
+        for (q=p; *q && !(!aParamValue && *q=='\\') && !(*q==aSeparator && aConvDefP->combineSep); q++) {}
+        if (*q==0) {
+          // rest of text is a single value that needs no de-escaping, use it in place
+          valP=p; valSz=q-p;
+          p=q;
+        }
+        else {
+          // - copy what needs no de-escaping, then process char by char
+          val.assign(p,q-p);
+          p=q;
+          while ((c=*p)!=0) {
+            // check for field list separator (if field allows list at all)
+            if (c==aSeparator && aConvDefP->combineSep) {
+              p++; // skip separator
+              break;
+            }
+            // check for escaped chars
+            if (!aParamValue && c=='\\') {
+              p++;
+              c=*p;
+              if (!c) break; // half escape sequence, ignore
+              else if (c=='n' || c=='N') c='\n';
+              else if (aOnlyDeEscLF) val+='\\'; // if deescaping only for \n, transfer this non-LF escape into output
+              // other escaped chars are shown as themselves
+            }
+            // add char
+            val+=c;
+            // next
             p++;
-            c=*p;
-            if (!c) break; // half escape sequence, ignore
-            else if (c=='n' || c=='N') c='\n';
-            else if (aOnlyDeEscLF) val+='\\'; // if deescaping only for \n, transfer this non-LF escape into output
-            // other escaped chars are shown as themselves
           }
-          // add char
-          val+=c;
-          // next
-          p++;
+          valP=val.c_str(); valSz=val.size();
         }
         // find first non-space and number of chars excluding leading and trailing spaces
-        const char* valnospc = val.c_str();
-        size_t numnospc=val.size();
-        while (*valnospc && *valnospc==' ') { valnospc++; numnospc--; }
-        while (*(valnospc+numnospc-1)==' ') { numnospc--; }
+        const char* valnospc = valP;
+        size_t numnospc=valSz;
+        while (numnospc>0 && *valnospc==' ') { valnospc++; numnospc--; }
+        while (numnospc>0 && *(valnospc+numnospc-1)==' ') { numnospc--; }
         // - counts as non-empty if there is a non-empty (and not space-only) value string (even if
         //   it might be converted to empty-value in enum conversion)
         if (*valnospc) aNotEmpty=true;
@@ -3783,11 +3816,12 @@ bool TMimeDirProfileHandler::parseValue(
             else {
               val=enumP->enumval; // just use translated value
             }
+            valP=val.c_str();
           }
         }
         // assign (or add) value to field
         if (!MIMEStringToField(
-          val.c_str(),            // the value text to assign or add to the field
+          valP,                   // the value text to assign or add to the field
           aConvDefP,              // the conversion definition
           aItem,
           fid,                    // field ID, can be -1
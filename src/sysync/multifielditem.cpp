@@ -18,6 +18,10 @@
 #include "multifielditem.h"
 #include "multifielditemtype.h"
 
+#if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
+#include "sysync_crc16.h"
+#endif
+
 
 using namespace sysync;
 
@@ -505,6 +509,28 @@ uInt16 TMultiFieldItem::getDataCRC(uInt16 crc, bool aEQRelevantOnly)
   return crc;
 } // TMultiFieldItem::getDataCRC
 
+
+// changelog support: calculate 64 bit hash over contents
+// - every field included adds its index and its contents (or an empty block), so
+//   moving a value to another field or between empty fields changes the hash
+uInt64 TMultiFieldItem::getDataHash(uInt64 hash, bool aEQRelevantOnly)
+{
+  // iterate over all fields
+  if (fFieldDefinitionsP) {
+    for (sInt16 i=0; i<fFieldDefinitionsP->numFields(); i++) {
+      if (!aEQRelevantOnly || fFieldDefinitionsP->fFields[i].eqRelevant!=eqm_none) {
+        uInt32 fidx = i;
+        hash=sysync_hash64_block(&fidx,sizeof(fidx),hash);
+        if (fFieldsP[i] && !fFieldsP[i]->isEmpty())
+          hash=fFieldsP[i]->getDataHash(hash);
+        else
+          hash=sysync_hash64_block(NULL,0,hash); // unassigned and empty fields hash the same
+      }
+    }
+  }
+  return hash;
+} // TMultiFieldItem::getDataHash
+
 #endif
 
 
@@ -1266,6 +1292,71 @@ exit:
   return result;
 } // TMultiFieldItem::standardCompareWith
 
+
+// get key for pre-selecting content matching candidates
+// - key is a digest of all fields which standardCompareWith() compares exactly
+//   (plain strings without possible cutoff), so items with different keys can
+//   never be equal. Fields compared in a less strict way are not part of the
+//   key and are left to the actual compareWith() of the candidates.
+bool TMultiFieldItem::getMatchKey(
+  TSyncItemType *aOtherTypeP,
+  TEqualityMode aEqMode,
+  string &aKey
+)
+{
+  // only standard comparison with items of the same field list can be predicted
+  if (aEqMode==eqm_nocompare || !fItemTypeP || !aOtherTypeP || !aOtherTypeP->isBasedOn(ity_multifield))
+    return false;
+  TMultiFieldItemType *othertypeP = static_cast<TMultiFieldItemType *>(aOtherTypeP);
+  if (othertypeP->getFieldDefinitions()!=fFieldDefinitionsP)
+    return false;
+  if (!fItemTypeP->hasStandardCompare() || !othertypeP->hasStandardCompare())
+    return false;
+  // digest key fields
+  md5::SYSYNC_MD5_CTX context;
+  uInt8 digest[16];
+  uInt32 n;
+  string s;
+  sInt16 keyfields=0;
+  md5::Init(&context);
+  for (sInt16 i=0; i<fFieldDefinitionsP->numFields(); i++) {
+    const TFieldDefinition &fd = fFieldDefinitionsP->fFields[i];
+    // - same field selection as in standardCompareWith()
+    if (fd.eqRelevant<aEqMode) continue;
+    TFieldOptions *o1 = fItemTypeP->getFieldOptions(i);
+    TFieldOptions *o2 = othertypeP->getFieldOptions(i);
+    if (!o1->available || !o2->available) continue;
+    // - only plain strings that cannot be cut off are compared exactly
+    if (fd.type!=fty_string) continue;
+    #ifdef ARRAYFIELD_SUPPORT
+    if (fd.array) continue;
+    #endif
+    if (o1->maxsize!=FIELD_OPT_MAXSIZE_NONE || o2->maxsize!=FIELD_OPT_MAXSIZE_NONE) continue;
+    TItemField *fldP = getField(i);
+    if (!fldP || fldP->getType()!=fty_string) continue;
+    // - unassigned fields are not compared in slowsync modes, so they cannot be part of a key
+    if (aEqMode>=eqm_slowsync && fldP->isUnassigned())
+      return false;
+    // - add field index, empty flag and value
+    keyfields++;
+    md5::Update(&context, (const uInt8 *)&i, sizeof(i));
+    if (fldP->isEmpty()) {
+      n = 0;
+      md5::Update(&context, (const uInt8 *)&n, sizeof(n));
+    }
+    else {
+      fldP->getAsString(s);
+      n = s.size()+1;
+      md5::Update(&context, (const uInt8 *)&n, sizeof(n));
+      md5::Update(&context, (const uInt8 *)s.c_str(), s.size());
+    }
+  }
+  if (keyfields==0) return false; // no field to base a key on
+  md5::Final(digest, &context);
+  aKey.assign((const char *)digest, sizeof(digest));
+  return true;
+} // TMultiFieldItem::getMatchKey
+
 #endif // server only
 
 
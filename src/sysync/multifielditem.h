@@ -271,6 +271,7 @@ public:
   // changelog support
   #if defined(CHECKSUM_CHANGELOG) && !defined(RECORDHASH_FROM_DBAPI)
   virtual uInt16 getDataCRC(uInt16 crc=0, bool aEQRelevantOnly=false);
+  virtual uInt64 getDataHash(uInt64 hash=0, bool aEQRelevantOnly=false);
   #endif
   // update dependencies of fields (such as BLOB proxies) on localID
   virtual void updateLocalIDDependencies(void);
@@ -344,6 +345,12 @@ public:
     TEqualityMode aEqMode,
     bool aDebugShow
   );
+  // get key for pre-selecting content matching candidates (digest of exactly compared fields)
+  virtual bool getMatchKey(
+    TSyncItemType *aOtherTypeP,
+    TEqualityMode aEqMode,
+    string &aKey
+  );
   #endif
   #ifdef SYDEBUG
   // show item contents for debug
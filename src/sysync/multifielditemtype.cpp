@@ -948,6 +948,17 @@ sInt16 TMultiFieldItemType::compareItems(
 } // TMultiFieldItemType::compareItems
 
 
+// check if items are compared by standard comparison
+bool TMultiFieldItemType::hasStandardCompare(void)
+{
+  #ifdef SCRIPT_SUPPORT
+  return static_cast<TMultiFieldTypeConfig *>(fTypeConfigP)->fCompareScript.empty();
+  #else
+  return true;
+  #endif
+} // TMultiFieldItemType::hasStandardCompare
+
+
 // merge two items
 void TMultiFieldItemType::mergeItems(
   TMultiFieldItem &aWinningItem,
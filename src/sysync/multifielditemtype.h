@@ -165,6 +165,7 @@ public:
   #endif
   // comparing and merging
   sInt16 compareItems(TMultiFieldItem &aFirstItem, TMultiFieldItem &aSecondItem, TEqualityMode aEqMode, bool aDebugShow, TLocalEngineDS *aDatastoreP);
+  bool hasStandardCompare(void); // set if compareItems() uses standard comparison (no compare script)
   void mergeItems(
     TMultiFieldItem &aWinningItem,
     TMultiFieldItem &aLoosingItem,
@@ -119,6 +119,224 @@ TScriptErrorException::TScriptErrorException(cAppCharP aMsg1, uInt16 aLine, cApp
 } // TScriptErrorException::TScriptErrorException
 
 
+#ifdef REGEX_SUPPORT
+
+/*
+ * Implementation of TRegexCache
+ */
+
+#ifndef REGEX_CACHE_SIZE
+  #define REGEX_CACHE_SIZE 64 // max number of compiled regular expressions kept
+#endif
+
+// compiled regular expression
+class TCompiledRegex
+{
+public:
+  TCompiledRegex(const string &aKey, pcre *aRegex, pcre_extra *aExtra) :
+    fKey(aKey), fRegex(aRegex), fExtra(aExtra), fUseCount(0), fCached(true) {};
+  ~TCompiledRegex()
+  {
+    #ifdef PCRE_CONFIG_JIT
+    if (fExtra) pcre_free_study(fExtra);
+    #else
+    if (fExtra) pcre_free(fExtra);
+    #endif
+    pcre_free(fRegex);
+  };
+  string fKey; // pattern as passed to the script function (including /.../opts)
+  pcre *fRegex; // compiled pattern
+  pcre_extra *fExtra; // study data, NULL if none
+  sInt32 fUseCount; // number of callers currently using this regex
+  bool fCached; // set as long as regex is in the cache (otherwise deleted when no longer used)
+}; // TCompiledRegex
+
+
+// bounded cache of compiled regular expressions, least recently used ones are dropped first
+class TRegexCache : noncopyable
+{
+public:
+  TRegexCache(uInt32 aMaxEntries);
+  ~TRegexCache();
+  // get compiled version of aRegEx, returns NULL if aRegEx does not compile
+  // (must be released with releaseRegex() after use)
+  TCompiledRegex *getRegex(cAppCharP aRegEx, TDebugLogger *aDbgLogger);
+  void releaseRegex(TCompiledRegex *aRegexP);
+private:
+  static TCompiledRegex *compileRegex(cAppCharP aRegEx, TDebugLogger *aDbgLogger);
+  typedef std::list<TCompiledRegex *> TRegexList;
+  typedef std::map<string,TRegexList::iterator> TRegexIndex;
+  TRegexList fRegexes; // most recently used first
+  TRegexIndex fIndex; // by pattern
+  uInt32 fMaxEntries;
+  uInt32 fHits;
+  uInt32 fMisses;
+  #ifdef MULTI_THREAD_SUPPORT
+  MutexPtr_t fMutex;
+  #endif
+}; // TRegexCache
+
+
+TRegexCache::TRegexCache(uInt32 aMaxEntries) :
+  fMaxEntries(aMaxEntries),
+  fHits(0),
+  fMisses(0)
+{
+  #ifdef MULTI_THREAD_SUPPORT
+  fMutex = newMutex();
+  #endif
+} // TRegexCache::TRegexCache
+
+
+TRegexCache::~TRegexCache()
+{
+  // Note: no regex can be in use any more when the config is deleted
+  TRegexList::iterator pos;
+  for (pos=fRegexes.begin(); pos!=fRegexes.end(); ++pos) {
+    delete *pos;
+  }
+  #ifdef MULTI_THREAD_SUPPORT
+  freeMutex(fMutex);
+  #endif
+} // TRegexCache::~TRegexCache
+
+
+// compile regex, which can be plain regex or in /xxx/opt form
+TCompiledRegex *TRegexCache::compileRegex(cAppCharP aRegEx, TDebugLogger *aDbgLogger)
+{
+  string regexpat;
+  cAppCharP key = aRegEx;
+  // set default options
+  int options=0;
+  // scan input pattern. If it starts with /, we assume /xxx/opt form
+  cAppCharP p = aRegEx;
+  char c=*p;
+  if (c=='/') {
+    // delimiter found
+    p++;
+    // - now search end
+    while (*p) {
+      if (*p=='\\') {
+        // escaped char
+        p++;
+        if (*p) p++;
+      }
+      else {
+        if (*p==c) {
+          // found end of regex
+          size_t n=p-aRegEx-1; // size of plain regExp
+          // - scan options
+          cAppCharP o = p++;
+          while (*o) {
+            switch (*o) {
+              case 'i' : options |= PCRE_CASELESS; break;
+              case 'm' : options |= PCRE_MULTILINE; break;
+              case 's' : options |= PCRE_DOTALL; break;
+              case 'x' : options |= PCRE_EXTENDED; break;
+              case 'U' : options |= PCRE_UNGREEDY; break;
+            }
+            o++;
+          }
+          // - extract regex itself
+          regexpat.assign(aRegEx+1,n);
+          aRegEx = regexpat.c_str();
+          break; // done
+        }
+        p++;
+      }
+    } // while chars in regex
+  } // if regex with delimiter
+  // - compile regex
+  pcre *regex;
+  cAppCharP errMsg=NULL;
+  int errOffs=0;
+  regex = pcre_compile(aRegEx, options | PCRE_UTF8, &errMsg, &errOffs, NULL);
+  if (regex==NULL) {
+    // error, display it in log if script logging is on
+    PLOGDEBUGPRINTFX(aDbgLogger,DBG_SCRIPTS+DBG_ERROR,(
+      "RegEx error at pattern pos %d: %s ",
+      errOffs,
+      errMsg ? errMsg : "<unknown>"
+    ));
+    return NULL;
+  }
+  // - study it, as it will probably be executed many times (failing is not an error, just no extra data)
+  errMsg=NULL;
+  pcre_extra *extra = pcre_study(regex, 0, &errMsg);
+  return new TCompiledRegex(key, regex, extra);
+} // TRegexCache::compileRegex
+
+
+// get compiled version of aRegEx, returns NULL if aRegEx does not compile
+TCompiledRegex *TRegexCache::getRegex(cAppCharP aRegEx, TDebugLogger *aDbgLogger)
+{
+  TCompiledRegex *regexP = NULL;
+  #ifdef MULTI_THREAD_SUPPORT
+  lockMutex(fMutex);
+  #endif
+  TRegexIndex::iterator ipos = fIndex.find(aRegEx);
+  bool hit = ipos!=fIndex.end();
+  if (hit) {
+    // cached, make it most recently used
+    fHits++;
+    regexP = *(ipos->second);
+    if (ipos->second!=fRegexes.begin()) {
+      fRegexes.erase(ipos->second);
+      ipos->second = fRegexes.insert(fRegexes.begin(),regexP);
+    }
+  }
+  else {
+    fMisses++;
+    regexP = compileRegex(aRegEx,aDbgLogger);
+    if (regexP && fMaxEntries>0) {
+      // add to cache
+      fIndex[regexP->fKey] = fRegexes.insert(fRegexes.begin(),regexP);
+      // drop least recently used entries if cache is full
+      while (fRegexes.size()>fMaxEntries) {
+        TCompiledRegex *oldP = fRegexes.back();
+        fRegexes.pop_back();
+        fIndex.erase(oldP->fKey);
+        oldP->fCached = false;
+        if (oldP->fUseCount==0) delete oldP; // otherwise, deleted by releaseRegex()
+      }
+    }
+    else if (regexP) {
+      regexP->fCached = false; // caching disabled
+    }
+  }
+  if (regexP) regexP->fUseCount++;
+  PLOGDEBUGPRINTFX(aDbgLogger,DBG_SCRIPTS+DBG_EXOTIC,(
+    "RegEx cache %s: hits=%ld, misses=%ld, cached=%ld",
+    hit ? "hit" : "miss",
+    (long)fHits,
+    (long)fMisses,
+    (long)fRegexes.size()
+  ));
+  #ifdef MULTI_THREAD_SUPPORT
+  unlockMutex(fMutex);
+  #endif
+  return regexP;
+} // TRegexCache::getRegex
+
+
+// release regex obtained with getRegex()
+void TRegexCache::releaseRegex(TCompiledRegex *aRegexP)
+{
+  if (!aRegexP) return;
+  #ifdef MULTI_THREAD_SUPPORT
+  lockMutex(fMutex);
+  #endif
+  aRegexP->fUseCount--;
+  bool obsolete = aRegexP->fUseCount==0 && !aRegexP->fCached;
+  #ifdef MULTI_THREAD_SUPPORT
+  unlockMutex(fMutex);
+  #endif
+  if (obsolete) delete aRegexP;
+} // TRegexCache::releaseRegex
+
+#endif // REGEX_SUPPORT
+
+
 
 /*
  * Implementation of TScriptConfig
@@ -129,6 +347,9 @@ TScriptErrorException::TScriptErrorException(cAppCharP aMsg1, uInt16 aLine, cApp
 TScriptConfig::TScriptConfig(TConfigElement *aParentElementP) :
   TConfigElement("scripting",aParentElementP)
 {
+  #ifdef REGEX_SUPPORT
+  fRegexCacheP = new TRegexCache(REGEX_CACHE_SIZE);
+  #endif
   clear();
 } // TScriptConfig::TScriptConfig
 
@@ -137,6 +358,9 @@ TScriptConfig::TScriptConfig(TConfigElement *aParentElementP) :
 TScriptConfig::~TScriptConfig()
 {
   clear();
+  #ifdef REGEX_SUPPORT
+  delete fRegexCacheP;
+  #endif
 } // TScriptConfig::~TScriptConfig
 
 
@@ -1323,71 +1547,19 @@ public:
   // Returns:          > 0 => success; value is the number of elements filled in
   //                   = 0 => success, but offsets is not big enough
   //                    -1 => failed to match
-  //                    -2 => PCRE_ERROR_NULL => did not compile, error reported to aDbgLogger
+  //                    -2 => PCRE_ERROR_NULL => did not compile, error reported to debug log
   //                  < -2 => some kind of unexpected problem
-  static int run_pcre(cAppCharP aRegEx, cAppCharP aSubject, stringSize aSubjLen, stringSize aSubjStart, int *aOutVec, int aOVSize, TDebugLogger *aDbgLogger)
+  static int run_pcre(cAppCharP aRegEx, cAppCharP aSubject, stringSize aSubjLen, stringSize aSubjStart, int *aOutVec, int aOVSize, TScriptContext *aFuncContextP)
   {
-    string regexpat;
-    // set default options
-    int options=0;
-    // scan input pattern. If it starts with /, we assume /xxx/opt form
-    cAppCharP p = aRegEx;
-    char c=*p;
-    if (c=='/') {
-      // delimiter found
-      p++;
-      // - now search end
-      while (*p) {
-        if (*p=='\\') {
-          // escaped char
-          p++;
-          if (*p) p++;
-        }
-        else {
-          if (*p==c) {
-            // found end of regex
-            size_t n=p-aRegEx-1; // size of plain regExp
-            // - scan options
-            cAppCharP o = p++;
-            while (*o) {
-              switch (*o) {
-                case 'i' : options |= PCRE_CASELESS; break;
-                case 'm' : options |= PCRE_MULTILINE; break;
-                case 's' : options |= PCRE_DOTALL; break;
-                case 'x' : options |= PCRE_EXTENDED; break;
-                case 'U' : options |= PCRE_UNGREEDY; break;
-              }
-              o++;
-            }
-            // - extract regex itself
-            regexpat.assign(aRegEx+1,n);
-            aRegEx = regexpat.c_str();
-            break; // done
-          }
-          p++;
-        }
-      } // while chars in regex
-    } // if regex with delimiter
-    // - compile regex
-    pcre *regex;
-    cAppCharP errMsg=NULL;
-    int errOffs=0;
-    regex = pcre_compile(aRegEx, options | PCRE_UTF8, &errMsg, &errOffs, NULL);
-    if (regex==NULL) {
-      // error, display it in log if script logging is on
-      PLOGDEBUGPRINTFX(aDbgLogger,DBG_SCRIPTS+DBG_ERROR,(
-        "RegEx error at pattern pos %d: %s ",
-        errOffs,
-        errMsg ? errMsg : "<unknown>"
-      ));
+    // get compiled regex from cache (compiles it if not cached yet)
+    TRegexCache *cacheP = aFuncContextP->getSyncAppBase()->getRootConfig()->fScriptConfigP->fRegexCacheP;
+    TCompiledRegex *regexP = cacheP->getRegex(aRegEx,aFuncContextP->getDbgLogger());
+    if (regexP==NULL)
       return PCRE_ERROR_NULL; // -2, regexp did not compile
-    }
-    else {
-      // regExp is ok and can be executed against subject
-      int r = pcre_exec(regex, NULL, aSubject, aSubjLen, aSubjStart, 0, aOutVec, aOVSize);
-      pcre_free(regex);
-      return r;
-    }
+    // regExp is ok and can be executed against subject
+    int r = pcre_exec(regexP->fRegex, regexP->fExtra, aSubject, aSubjLen, aSubjStart, 0, aOutVec, aOVSize);
+    cacheP->releaseRegex(regexP);
+    return r;
   } // run_pcre
 
 
@@ -1403,7 +1575,7 @@ public:
     // use PCRE to find
     const int ovsize=3; // we need no matches
     int ov[ovsize];
-    int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP->getDbgLogger());
+    int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP);
     if (rc>=0) {
       // return start position
       aTermP->setAsInteger(ov[0]);
@@ -1428,7 +1600,7 @@ public:
     // use PCRE to find
     const int ovsize=54; // max matches (they say this must be a multiple of 3, no idea why; I'd say 2...)
     int ov[ovsize];
-    int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP->getDbgLogger());
+    int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP);
     if (rc>0) {
       // return start position
       aTermP->setAsInteger(ov[0]);
@@ -1481,7 +1653,7 @@ public:
       // use PCRE to find
       const int ovsize=3; // we need no matches
       int ov[ovsize];
-      int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP->getDbgLogger());
+      int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP);
       if (rc<=0) {
         // no further match found
         // - simulate match at end of string
@@ -1522,7 +1694,7 @@ public:
     int ov[ovsize];
     res.assign(s.c_str(),i); // part of string not searched at all
     do {
-      int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP->getDbgLogger());
+      int rc = run_pcre(pat.c_str(),s.c_str(),s.size(),i,ov,ovsize,aFuncContextP);
       if (rc<0)
         break; // error or no more matches found
       // found an occurrence
@@ -1818,9 +1990,14 @@ public:
     // get name
     aFuncContextP->getLocalVar(0)->getAsString(varname);
     // get variable from session
-    if (aFuncContextP->getSession())
-      sessionContextP=aFuncContextP->getSession()->getSessionScriptContext();
+    TSyncSession *sessionP = aFuncContextP->getSession();
+    if (sessionP)
+      sessionContextP=sessionP->getSessionScriptContext();
     if (sessionContextP) {
+      #ifdef MULTI_THREAD_SUPPORT
+      // outgoing scripts of several datastores may run in parallel
+      lockMutex(sessionP->getSessionVarMutex());
+      #endif
       // get definition
       sessionVarDefP = sessionContextP->getVarDef(
         varname.c_str(),varname.size()
@@ -1835,6 +2012,9 @@ public:
           (*aTermP) = (*sessionVarP);
         }
       }
+      #ifdef MULTI_THREAD_SUPPORT
+      unlockMutex(sessionP->getSessionVarMutex());
+      #endif
     }
     if (!aTermP) {
       // if no such variable found, return unassigned (but not no-value, which would abort script)
@@ -1855,8 +2035,13 @@ public:
     // get name
     aFuncContextP->getLocalVar(0)->getAsString(varname);
     // get variable from session
-    if (aFuncContextP->getSession()) sessionContextP=aFuncContextP->getSession()->getSessionScriptContext();
+    TSyncSession *sessionP = aFuncContextP->getSession();
+    if (sessionP) sessionContextP=sessionP->getSessionScriptContext();
     if (sessionContextP) {
+      #ifdef MULTI_THREAD_SUPPORT
+      // outgoing scripts of several datastores may run in parallel
+      lockMutex(sessionP->getSessionVarMutex());
+      #endif
       // get definition
       sessionVarDefP = sessionContextP->getVarDef(
         varname.c_str(),varname.size()
@@ -1869,6 +2054,9 @@ public:
           (*sessionVarP) = (*(aFuncContextP->getLocalVar(1)));
         }
       }
+      #ifdef MULTI_THREAD_SUPPORT
+      unlockMutex(sessionP->getSessionVarMutex());
+      #endif
     }
   }; // func_SetSessionVar
 
@@ -3897,6 +4085,8 @@ TItemField *TScriptContext::evalTerm(TItemFieldTypes aResultType)
   TItemField *termP=NULL;
   uInt8 tk;
   TScriptContext *funccontextP;
+  TScriptContextPool *ctxpoolP;
+  sInt16 funcidx;
   string *funcscript;
   const char *funcname;
   uInt16 funcnamelen;
@@ -4016,10 +4206,17 @@ TItemField *TScriptContext::evalTerm(TItemFieldTypes aResultType)
       funcscript=getSyncAppBase()->getRootConfig()->fScriptConfigP->getFunctionScript(*(p+2));
       if (!funcscript)
         SYSYNC_THROW(TSyncException(DEBUGTEXT("invalid user function index","scri7")));
-      // %%% possibly add caching of function contexts here.
-      //     Now we rebuild a context for every function call. Not extremely efficient...
-      funccontextP=NULL;
-      rebuildContext(fAppBaseP,*funcscript,funccontextP,fSessionP,true);
+      // - get context: re-use an idle one of the session (only locals need to be re-instantiated),
+      //   rebuild a new one otherwise (also when this function is already executing, i.e. recursion)
+      funcidx=*(p+2);
+      ctxpoolP = fSessionP ? fSessionP->getFunctionContextPool() : NULL;
+      funccontextP = ctxpoolP ? ctxpoolP->getContext(funcidx) : NULL;
+      if (funccontextP && !funccontextP->PrepareLocals()) {
+        delete funccontextP;
+        funccontextP=NULL;
+      }
+      if (!funccontextP)
+        rebuildContext(fAppBaseP,*funcscript,funccontextP,fSessionP,true);
       if (!funccontextP)
         SYSYNC_THROW(TSyncException(DEBUGTEXT("no context for user-defined function call","scri5")));
       SYSYNC_TRY {
@@ -4042,8 +4239,12 @@ TItemField *TScriptContext::evalTerm(TItemFieldTypes aResultType)
           SCRIPTDBGMSG(("- User-defined function failed to execute"));
           SYSYNC_THROW(TSyncException("User-defined function failed to execute properly"));
         }
-        // done
-        if (funccontextP) delete funccontextP;
+        // done, keep context for next call if possible
+        if (ctxpoolP)
+          ctxpoolP->putContext(funcidx,funccontextP);
+        else
+          delete funccontextP;
+        funccontextP=NULL;
       }
       SYSYNC_CATCH (...)
         if (funccontextP) delete funccontextP;
@@ -4873,6 +5074,90 @@ void TScriptContext::setLocalVar(sInt16 aVarIdx, TItemField *aFieldP)
 /* end of TScriptContext implementation */
 
 
+/*
+ * Implementation of TScriptContextPool
+ */
+
+
+TScriptContextPool::TScriptContextPool()
+{
+  #ifdef MULTI_THREAD_SUPPORT
+  fMutex = newMutex();
+  #endif
+} // TScriptContextPool::TScriptContextPool
+
+
+TScriptContextPool::~TScriptContextPool()
+{
+  clear();
+  #ifdef MULTI_THREAD_SUPPORT
+  freeMutex(fMutex);
+  #endif
+} // TScriptContextPool::~TScriptContextPool
+
+
+// get idle context for function (NULL if none)
+TScriptContext *TScriptContextPool::getContext(sInt16 aFuncIndex)
+{
+  TScriptContext *ctxP = NULL;
+  #ifdef MULTI_THREAD_SUPPORT
+  lockMutex(fMutex);
+  #endif
+  if (aFuncIndex>=0 && (size_t)aFuncIndex<fIdleContexts.size() && !fIdleContexts[aFuncIndex].empty()) {
+    ctxP = fIdleContexts[aFuncIndex].back();
+    fIdleContexts[aFuncIndex].pop_back();
+  }
+  #ifdef MULTI_THREAD_SUPPORT
+  unlockMutex(fMutex);
+  #endif
+  return ctxP;
+} // TScriptContextPool::getContext
+
+
+// put context no longer in use back into the pool (pool takes ownership)
+void TScriptContextPool::putContext(sInt16 aFuncIndex, TScriptContext *aCtxP)
+{
+  if (!aCtxP) return;
+  if (aFuncIndex<0) {
+    delete aCtxP;
+    return;
+  }
+  // free the locals now, they are re-instantiated when the context is used again
+  aCtxP->clearFields();
+  aCtxP->fParentContextP = NULL;
+  #ifdef MULTI_THREAD_SUPPORT
+  lockMutex(fMutex);
+  #endif
+  if ((size_t)aFuncIndex>=fIdleContexts.size())
+    fIdleContexts.resize(aFuncIndex+1);
+  fIdleContexts[aFuncIndex].push_back(aCtxP);
+  #ifdef MULTI_THREAD_SUPPORT
+  unlockMutex(fMutex);
+  #endif
+} // TScriptContextPool::putContext
+
+
+// delete all idle contexts
+void TScriptContextPool::clear(void)
+{
+  #ifdef MULTI_THREAD_SUPPORT
+  lockMutex(fMutex);
+  #endif
+  for (size_t i=0; i<fIdleContexts.size(); i++) {
+    TScriptContextList::iterator pos;
+    for (pos=fIdleContexts[i].begin(); pos!=fIdleContexts[i].end(); ++pos) {
+      delete *pos;
+    }
+  }
+  fIdleContexts.clear();
+  #ifdef MULTI_THREAD_SUPPORT
+  unlockMutex(fMutex);
+  #endif
+} // TScriptContextPool::clear
+
+/* end of TScriptContextPool implementation */
+
+
 #ifdef ENGINEINTERFACE_SUPPORT
 
 // TScriptVarKey
@@ -24,6 +24,9 @@
 
 #include "itemfield.h"
 #include "multifielditem.h"
+#ifdef MULTI_THREAD_SUPPORT
+  #include "platform_mutex.h"
+#endif
 
 
 using namespace sysync;
@@ -192,6 +195,10 @@ public:
 
 typedef std::vector<TUserScriptFunction *> TUserScriptList;
 
+#ifdef REGEX_SUPPORT
+class TRegexCache;
+#endif
+
 // global script config (such as user-defined functions)
 class TScriptConfig : public TConfigElement
 {
@@ -206,6 +213,10 @@ public:
   TUserScriptList fFunctionScripts;
   // macros (pure texts used while parsing)
   TStringToStringMap fScriptMacros;
+  #ifdef REGEX_SUPPORT
+  // compiled regular expressions (shared by all sessions)
+  TRegexCache *fRegexCacheP;
+  #endif
   // accessing user defined functions
   string *getFunctionScript(sInt16 aFuncIndex);
   sInt16 getFunctionIndex(cAppCharP aName, size_t aLen);
@@ -449,6 +460,29 @@ private:
 }; // TScriptContext
 
 
+// pool of idle user-defined function contexts
+// - avoids rebuilding the context of a user-defined function for every call. A context
+//   is taken out of the pool while executing, so recursive calls get their own context
+class TScriptContextPool : noncopyable
+{
+public:
+  TScriptContextPool();
+  ~TScriptContextPool();
+  // get idle context for function (NULL if none)
+  TScriptContext *getContext(sInt16 aFuncIndex);
+  // put context no longer in use back into the pool (pool takes ownership)
+  void putContext(sInt16 aFuncIndex, TScriptContext *aCtxP);
+  // delete all idle contexts
+  void clear(void);
+private:
+  typedef std::list<TScriptContext *> TScriptContextList;
+  std::vector<TScriptContextList> fIdleContexts; // idle contexts by function index
+  #ifdef MULTI_THREAD_SUPPORT
+  MutexPtr_t fMutex; // session scripts might run in background threads, too
+  #endif
+}; // TScriptContextPool
+
+
 #ifdef ENGINEINTERFACE_SUPPORT
 
 
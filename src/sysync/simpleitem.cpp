@@ -52,6 +52,14 @@ uInt16 TSimpleItem::getDataCRC(uInt16 crc, bool aEQRelevantOnly)
   return sysync_crc16_block(fContents.c_str(),fContents.size(),crc);
 } // TSimpleItem::getDataCRC
 
+
+// changelog support: calculate 64 bit hash over contents
+uInt64 TSimpleItem::getDataHash(uInt64 hash, bool aEQRelevantOnly)
+{
+  // hash of contents string (no change if nothing in it)
+  return sysync_hash64_block(fContents.c_str(),fContents.size(),hash);
+} // TSimpleItem::getDataHash
+
 #endif
 
 
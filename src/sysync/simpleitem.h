@@ -46,6 +46,7 @@ public:
   // - changelog support
   #ifdef CHECKSUM_CHANGELOG
   virtual uInt16 getDataCRC(uInt16 crc=0, bool aEQRelevantOnly=false);
+  virtual uInt64 getDataHash(uInt64 hash=0, bool aEQRelevantOnly=false);
   #endif
   // replace data contents from specified item
   // - aAvailable only: only replace contents actually available in aItem, leave rest untouched
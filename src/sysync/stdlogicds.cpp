@@ -84,6 +84,9 @@ void TStdLogicDS::InternalResetDataStore(void)
   if(HAS_SERVER_DB) {
     #ifdef USES_SERVER_DB
     // remove all items
+    #ifdef MULTI_THREAD_SUPPORT
+    discardPreparedItems();
+    #endif
     TSyncItemPContainer::iterator pos;
     for (pos=fItems.begin(); pos!=fItems.end(); ++pos) {
       delete *pos;
@@ -96,6 +99,9 @@ void TStdLogicDS::InternalResetDataStore(void)
     fNumRefOnlyItems=0;
     #endif
   }
+  #ifdef SYSYNC_SERVER
+  invalidateMatchIndex();
+  #endif
 } // TStdLogicDS::InternalResetDataStore
 
 
@@ -404,6 +410,7 @@ localstatus TStdLogicDS::performStartSync(void)
           }
           // - now add it to my local list
           fItems.push_back(myitemP);
+          invalidateMatchIndex();
           if (sop==sop_reference_only)
             fNumRefOnlyItems++; // count these to avoid them being shown in NOC
         }
@@ -667,44 +674,202 @@ TSyncItem *TStdLogicDS::getConflictingItemByLocalID(TSyncItem *syncitemP)
 
 
 
-// called to check if content-matching item from server exists for slow sync
-TSyncItem *TStdLogicDS::getMatchingItem(TSyncItem *syncitemP, TEqualityMode aEqMode)
+// invalidate content match indexes (must be called when contents of fItems change otherwise
+// than through SendItemAsServer()/dontSendItemAsServer())
+void TStdLogicDS::invalidateMatchIndex(void)
+{
+  for (int m=0; m<numEQmodes; m++) {
+    TMatchIndex &idx = fMatchIndex[m];
+    idx.valid=false;
+    idx.buckets.clear();
+    idx.others.clear();
+    idx.positions.clear();
+  }
+} // TStdLogicDS::invalidateMatchIndex
+
+
+// add item to content match index
+void TStdLogicDS::addToMatchIndex(TMatchIndex &aIndex, TEqualityMode aEqMode, TSyncItem *aSyncItemP, bool aWithKey)
+{
+  string key;
+  TMatchCandidate cand(aIndex.nextSeq++,aSyncItemP);
+  TMatchItemPos ipos;
+  if (aWithKey) {
+    // first item determines the local type, items of other types are always compared
+    if (!aIndex.localTypeP)
+      aIndex.localTypeP = aSyncItemP->getSyncItemType();
+    aWithKey =
+      aSyncItemP->getSyncItemType()==aIndex.localTypeP &&
+      aSyncItemP->getMatchKey(aIndex.remoteTypeP,aEqMode,key);
+  }
+  if (aWithKey) {
+    ipos.first = aIndex.buckets.insert(TMatchBuckets::value_type(key,TMatchCandidateList())).first;
+    ipos.second = ipos.first->second.insert(ipos.first->second.end(),cand);
+  }
+  else {
+    ipos.first = aIndex.buckets.end();
+    ipos.second = aIndex.others.insert(aIndex.others.end(),cand);
+  }
+  aIndex.positions[aSyncItemP] = ipos;
+} // TStdLogicDS::addToMatchIndex
+
+
+// build content match index of fItems for comparing with incoming items of given type
+void TStdLogicDS::buildMatchIndex(TEqualityMode aEqMode, TSyncItemType *aRemoteTypeP)
 {
-  // search for content matching item
+  TMatchIndex &idx = fMatchIndex[aEqMode];
+  idx.buckets.clear();
+  idx.others.clear();
+  idx.positions.clear();
+  idx.remoteTypeP = aRemoteTypeP;
+  idx.localTypeP = NULL;
+  idx.nextSeq = 0;
   TSyncItemPContainer::iterator pos;
   for (pos=fItems.begin(); pos!=fItems.end(); ++pos) {
-    DEBUGPRINTFX(DBG_DATA+DBG_MATCH+DBG_EXOTIC,(
-      "comparing (this) local item localID='%s' with incoming (other) item remoteID='%s'",
-      (*pos)->getLocalID(),
-      syncitemP->getRemoteID()
-    ));
-    if ((*pos)->compareWith(
-      *syncitemP,aEqMode,this
-      #ifdef SYDEBUG
-      ,PDEBUGTEST(DBG_DATA+DBG_MATCH+DBG_EXOTIC) // only show comparison if exotic AND match is enabled
-      #endif
-    )==0) {
-      // items match in content
-      // - check if item is not already matched
-      if ((*pos)->getSyncOp()!=sop_wants_add && (*pos)->getSyncOp()!=sop_reference_only) {
-        // item has already been matched before, so don't match it again
-        DEBUGPRINTFX(DBG_DATA,(
-          "TStdLogicDS::getMatchingItem, match but already used -> skip it: remoteID='%s' = localID='%s'",
-          syncitemP->getRemoteID(),
-          (*pos)->getLocalID()
-        ));
+    addToMatchIndex(idx,aEqMode,*pos,true);
+  }
+  idx.valid = true;
+  PDEBUGPRINTFX(DBG_DATA+DBG_MATCH+DBG_EXOTIC,(
+    "TStdLogicDS::buildMatchIndex: eqMode=%hd, %ld items, %ld distinct keys, %ld items always compared",
+    (sInt16)aEqMode,
+    (long)fItems.size(),
+    (long)idx.buckets.size(),
+    (long)idx.others.size()
+  ));
+} // TStdLogicDS::buildMatchIndex
+
+
+// remove item from content match indexes
+// - if aKeepUnkeyed is set, item remains in the indexes, but will be compared with every
+//   incoming item from now on (used for items whose content might change)
+void TStdLogicDS::removeFromMatchIndex(TSyncItem *aSyncItemP, bool aKeepUnkeyed)
+{
+  for (int m=0; m<numEQmodes; m++) {
+    TMatchIndex &idx = fMatchIndex[m];
+    if (!idx.valid) continue;
+    TMatchItemPositions::iterator ppos = idx.positions.find(aSyncItemP);
+    if (ppos==idx.positions.end()) continue;
+    TMatchItemPos &ipos = ppos->second;
+    if (ipos.first==idx.buckets.end()) {
+      // already unkeyed
+      if (aKeepUnkeyed) continue;
+      idx.others.erase(ipos.second);
+      idx.positions.erase(ppos);
+      continue;
+    }
+    sInt32 seq = ipos.second->first;
+    ipos.first->second.erase(ipos.second);
+    if (ipos.first->second.empty())
+      idx.buckets.erase(ipos.first);
+    if (aKeepUnkeyed) {
+      // insert into others, keeping fItems order
+      TMatchCandidateList::iterator opos = idx.others.end();
+      while (opos!=idx.others.begin()) {
+        --opos;
+        if (opos->first<seq) { ++opos; break; }
       }
-      else {
-        // item has not been matched yet (wannabe add or reference-only), return it now
-        PDEBUGPRINTFX(DBG_DATA+DBG_MATCH+DBG_HOT,(
-          "TStdLogicDS::getMatchingItem, found remoteID='%s' is equal in content with localID='%s'",
-          syncitemP->getRemoteID(),
-          (*pos)->getLocalID()
-        ));
-        return (*pos); // return pointer to item in question
+      ipos.first = idx.buckets.end();
+      ipos.second = idx.others.insert(opos,TMatchCandidate(seq,aSyncItemP));
+    }
+    else {
+      idx.positions.erase(ppos);
+    }
+  }
+} // TStdLogicDS::removeFromMatchIndex
+
+
+// check if local item matches incoming item in content and can be returned by getMatchingItem()
+bool TStdLogicDS::checkMatchingItem(TSyncItem *aLocalItemP, TSyncItem *aSyncItemP, TEqualityMode aEqMode)
+{
+  DEBUGPRINTFX(DBG_DATA+DBG_MATCH+DBG_EXOTIC,(
+    "comparing (this) local item localID='%s' with incoming (other) item remoteID='%s'",
+    aLocalItemP->getLocalID(),
+    aSyncItemP->getRemoteID()
+  ));
+  if (aLocalItemP->compareWith(
+    *aSyncItemP,aEqMode,this
+    #ifdef SYDEBUG
+    ,PDEBUGTEST(DBG_DATA+DBG_MATCH+DBG_EXOTIC) // only show comparison if exotic AND match is enabled
+    #endif
+  )==0) {
+    // items match in content
+    // - check if item is not already matched
+    if (aLocalItemP->getSyncOp()!=sop_wants_add && aLocalItemP->getSyncOp()!=sop_reference_only) {
+      // item has already been matched before, so don't match it again
+      DEBUGPRINTFX(DBG_DATA,(
+        "TStdLogicDS::getMatchingItem, match but already used -> skip it: remoteID='%s' = localID='%s'",
+        aSyncItemP->getRemoteID(),
+        aLocalItemP->getLocalID()
+      ));
+    }
+    else {
+      // item has not been matched yet (wannabe add or reference-only), return it now
+      PDEBUGPRINTFX(DBG_DATA+DBG_MATCH+DBG_HOT,(
+        "TStdLogicDS::getMatchingItem, found remoteID='%s' is equal in content with localID='%s'",
+        aSyncItemP->getRemoteID(),
+        aLocalItemP->getLocalID()
+      ));
+      return true;
+    }
+  }
+  return false;
+} // TStdLogicDS::checkMatchingItem
+
+
+// called to check if content-matching item from server exists for slow sync
+TSyncItem *TStdLogicDS::getMatchingItem(TSyncItem *syncitemP, TEqualityMode aEqMode)
+{
+  TSyncItem *matchP = NULL;
+  string key;
+  // make sure we have an index for this mode and type of incoming item
+  TMatchIndex &idx = fMatchIndex[aEqMode];
+  if (!idx.valid || idx.remoteTypeP!=syncitemP->getSyncItemType())
+    buildMatchIndex(aEqMode,syncitemP->getSyncItemType());
+  if (idx.localTypeP && syncitemP->getMatchKey(idx.localTypeP,aEqMode,key)) {
+    // only local items with same key or without key can match, search these in fItems order
+    TMatchBuckets::iterator bpos = idx.buckets.find(key);
+    TMatchCandidateList::iterator kpos, opos = idx.others.begin();
+    if (bpos!=idx.buckets.end()) kpos = bpos->second.begin();
+    while (true) {
+      bool keyed = bpos!=idx.buckets.end() && kpos!=bpos->second.end();
+      bool other = opos!=idx.others.end();
+      TSyncItem *candP;
+      if (keyed && (!other || kpos->first<opos->first)) {
+        candP = (kpos++)->second;
+      }
+      else if (other) {
+        candP = opos->second;
+        if (candP->getSyncOp()!=sop_wants_add && candP->getSyncOp()!=sop_reference_only) {
+          // already matched, no need to compare this one again
+          idx.positions.erase(candP);
+          opos = idx.others.erase(opos);
+          continue;
+        }
+        ++opos;
+      }
+      else
+        break; // no more candidates
+      if (checkMatchingItem(candP,syncitemP,aEqMode)) {
+        matchP = candP;
+        break;
+      }
+    }
+  }
+  else {
+    // no key, search content matching item in all items
+    TSyncItemPContainer::iterator pos;
+    for (pos=fItems.begin(); pos!=fItems.end(); ++pos) {
+      if (checkMatchingItem(*pos,syncitemP,aEqMode)) {
+        matchP = *pos;
+        break;
       }
     }
   }
+  if (matchP) {
+    // caller will usually merge into the item, so its key is no longer reliable
+    removeFromMatchIndex(matchP,true);
+    return matchP; // return pointer to item in question
+  }
   PDEBUGPRINTFX(DBG_DATA+DBG_MATCH,("TStdLogicDS::getMatchingItem, no matching item"));
   return NULL;
 } // TStdLogicDS::getMatchingItem
@@ -716,12 +881,16 @@ void TStdLogicDS::dontSendItemAsServer(TSyncItem *syncitemP)
 {
   PDEBUGPRINTFX(DBG_DATA+DBG_EXOTIC,("Preventing localID='%s' to be sent to client",syncitemP->getLocalID()));
   syncitemP->setSyncOp(sop_none); // anyway, set to none
+  removeFromMatchIndex(syncitemP,false);
   // delete from list as we don't need it any more
   TSyncItemPContainer::iterator pos;
   for (pos=fItems.begin(); pos!=fItems.end(); ++pos) {
     if (*pos == syncitemP) {
       // it is in our list
       PDEBUGPRINTFX(DBG_DATA+DBG_HOT,("Item with localID='%s' will NOT be sent to client (slowsync match / duplicate prevention)",syncitemP->getLocalID()));
+      #ifdef MULTI_THREAD_SUPPORT
+      discardPreparedItem(syncitemP);
+      #endif
       delete *pos; // delete item itself
       fItems.erase(pos); // remove from list
       break;
@@ -759,6 +928,11 @@ void TStdLogicDS::SendItemAsServer(TSyncItem *aSyncitemP)
 {
   // add to list of changes
   fItems.push_back(aSyncitemP);
+  // add to valid match indexes (without key, as item might still be modified by caller)
+  for (int m=0; m<numEQmodes; m++) {
+    if (fMatchIndex[m].valid)
+      addToMatchIndex(fMatchIndex[m],(TEqualityMode)m,aSyncitemP,false);
+  }
 } // TStdLogicDS::SendItemAsServer
 
 
@@ -873,6 +1047,10 @@ bool TStdLogicDS::logicGenerateSyncCommandsAsServer(
       // remove item from list
       TSyncItemPContainer::iterator temp_pos = pos++; // make copy and set iterator to next
       fItems.erase(temp_pos); // now entry can be deleted (N.M. Josuttis, pg204)
+      removeFromMatchIndex(syncitemP,false);
+      #ifdef MULTI_THREAD_SUPPORT
+      discardPreparedItem(syncitemP);
+      #endif
       // delete item itself
       delete syncitemP;
       // test next
@@ -881,6 +1059,7 @@ bool TStdLogicDS::logicGenerateSyncCommandsAsServer(
     // create sync op command (may return NULL in case command cannot be created, e.g. for MaxObjSize limitations)
     TSyncOpCommand *syncopcmdP = newSyncOpCommand(syncitemP,itemtypeP,aLocalIDPrefix);
     // erase item from list
+    removeFromMatchIndex(syncitemP,false);
     delete syncitemP;
     pos = fItems.erase(pos);
     // issue command now
@@ -915,6 +1094,34 @@ bool TStdLogicDS::logicGenerateSyncCommandsAsServer(
 } // TStdLogicDS::logicGenerateSyncCommandsAsServer
 
 
+#ifdef MULTI_THREAD_SUPPORT
+
+// Convert up to aMaxItems of the items logicGenerateSyncCommandsAsServer() will send next.
+// Runs in a worker thread in parallel with other datastores of the session, so it must
+// only touch this datastore (and its item types, which the session does not share between
+// datastores converting at the same time)
+void TStdLogicDS::logicPrepareSyncCommandsAsServer(uInt32 aMaxItems)
+{
+  TSyncItemType *itemtypeP = getRemoteReceiveType();
+  if (!itemtypeP || !testState(dssta_serverseenclientmods)) return;
+  uInt32 n=0;
+  TSyncItemPContainer::iterator pos;
+  for (pos=fItems.begin(); pos!=fItems.end() && n<aMaxItems && !isAborted(); ++pos) {
+    TSyncItem *syncitemP = (*pos);
+    TSyncOperation syncop=syncitemP->getSyncOp();
+    // skip what logicGenerateSyncCommandsAsServer() will not send
+    if (syncop==sop_reference_only) continue;
+    if (fRemoteAddingStopped && (syncop==sop_wants_add || syncop==sop_add)) continue;
+    // convert (items already converted count as well)
+    if (prepareItemForRemote(syncitemP,itemtypeP))
+      n++;
+  }
+  PDEBUGPRINTFX(DBG_DATA,("%s: %ld items converted ahead of generating sync commands",getName(),(long)n));
+} // TStdLogicDS::logicPrepareSyncCommandsAsServer
+
+#endif // MULTI_THREAD_SUPPORT
+
+
 // called for servers when receiving map from client
 localstatus TStdLogicDS::logicProcessMap(cAppCharP aRemoteID, cAppCharP aLocalID)
 {
@@ -1636,6 +1843,10 @@ localstatus TStdLogicDS::dsBeforeStateChange(TLocalEngineDSState aOldState,TLoca
           } else {
             TSyncItemPContainer::iterator next = pos;
             ++next;
+            removeFromMatchIndex(syncitemP,false);
+            #ifdef MULTI_THREAD_SUPPORT
+            discardPreparedItem(syncitemP);
+            #endif
             delete syncitemP;
             fItems.erase(pos);
             pos = next;
@@ -63,6 +63,29 @@ private:
   #ifdef SYSYNC_SERVER
   TSyncItemPContainer fItems; ///< list of data items
   uInt32 fNumRefOnlyItems;
+  /// @name content match index, avoids comparing every incoming item with all of fItems in slow sync
+  /// @{
+  typedef std::pair<sInt32,TSyncItem *> TMatchCandidate; ///< order in fItems, item
+  typedef std::list<TMatchCandidate> TMatchCandidateList;
+  typedef std::map<string,TMatchCandidateList> TMatchBuckets;
+  typedef std::pair<TMatchBuckets::iterator,TMatchCandidateList::iterator> TMatchItemPos;
+  typedef std::map<TSyncItem *,TMatchItemPos> TMatchItemPositions;
+  typedef struct {
+    bool valid;
+    TSyncItemType *remoteTypeP; ///< type of incoming items the keys are calculated for
+    TSyncItemType *localTypeP; ///< type of local items that have a key
+    sInt32 nextSeq; ///< order number for next item added
+    TMatchBuckets buckets; ///< local items by match key
+    TMatchCandidateList others; ///< local items without match key, compared with every incoming item
+    TMatchItemPositions positions; ///< position of every indexed item (bucket is buckets.end() for others)
+  } TMatchIndex;
+  TMatchIndex fMatchIndex[numEQmodes]; ///< one index per equality mode, built on first use
+  void invalidateMatchIndex(void);
+  void buildMatchIndex(TEqualityMode aEqMode, TSyncItemType *aRemoteTypeP);
+  void addToMatchIndex(TMatchIndex &aIndex, TEqualityMode aEqMode, TSyncItem *aSyncItemP, bool aWithKey);
+  void removeFromMatchIndex(TSyncItem *aSyncItemP, bool aKeepUnkeyed);
+  bool checkMatchingItem(TSyncItem *aLocalItemP, TSyncItem *aSyncItemP, TEqualityMode aEqMode);
+  /// @}
   #endif
   // startSync/threading privates
   bool fInitializing;
@@ -305,6 +328,10 @@ private:
     TSmlCommand * &aInterruptedCommandP,
     cAppCharP aLocalIDPrefix
   );
+  #ifdef MULTI_THREAD_SUPPORT
+  /// called to convert items to be sent next ahead of logicGenerateSyncCommandsAsServer()
+  virtual void logicPrepareSyncCommandsAsServer(uInt32 aMaxItems);
+  #endif
   /// called for servers when receiving map from client
   /// @note aLocalID or aRemoteID can be NULL - which signifies deletion of a map entry
   virtual localstatus logicProcessMap(cAppCharP aLocalID, cAppCharP aRemoteID);
@@ -34,6 +34,9 @@
 
 #ifdef SYSYNC_TOOL
 #include <errno.h>
+#ifdef LINUX
+#include <sys/resource.h>
+#endif
 #endif
 
 
@@ -262,6 +265,373 @@ int convertData(int argc, const char *argv[])
   return EXIT_SUCCESS;
 } // convertData
 
+
+// headroom kept free in benchmark messages for closing the SyncML document
+#define BENCH_MSGEND_RESERVE 64
+
+// get elapsed milliseconds since aStart
+static double benchElapsedMS(TSyncSession *aSessionP, lineartime_t aStart)
+{
+  lineartime_t t = aSessionP->getSystemNowAs(TCTX_UTC)-aStart;
+  return (double)t*1000.0/secondToLinearTimeFactor;
+} // benchElapsedMS
+
+
+// get items/sec rate for a phase
+static double benchRate(sInt32 aItems, double aMS)
+{
+  return aMS>0 ? aItems*1000.0/aMS : 0;
+} // benchRate
+
+
+// start a new benchmark message in aInstance
+static Ret_t benchStartMessage(InstanceID_t aInstance, uInt32 aMsgID)
+{
+  SmlSyncHdrPtr_t headerP = SML_NEW(SmlSyncHdr_t);
+  headerP->elementType=SML_PE_HEADER;
+  headerP->version=newPCDataString(SyncMLVerDTDNames[syncml_vers_1_2]);
+  headerP->proto=newPCDataString(SyncMLVerProtoNames[syncml_vers_1_2]);
+  headerP->sessionID=newPCDataString("sysytool_bench");
+  headerP->msgID=newPCDataLong(aMsgID);
+  headerP->flags=0;
+  headerP->target=newLocation("sysytool_bench_client",NULL);
+  headerP->source=newLocation("sysytool_bench_server",NULL);
+  headerP->respURI=NULL;
+  headerP->cred=NULL;
+  headerP->meta=NULL;
+  Ret_t rc = smlStartMessageExt(aInstance,headerP,SmlVersionCodes[syncml_vers_1_2]);
+  smlFreeProtoElement(headerP);
+  return rc;
+} // benchStartMessage
+
+
+// close current benchmark message in aInstance and take its bytes out of the workspace
+static Ret_t benchEndMessage(InstanceID_t aInstance, string &aMsg)
+{
+  MemPtr_t bufP;
+  MemSize_t bufSiz;
+  Ret_t rc = smlEndMessage(aInstance,true);
+  if (rc!=SML_ERR_OK) return rc;
+  rc = smlLockReadBuffer(aInstance,&bufP,&bufSiz);
+  if (rc!=SML_ERR_OK) return rc;
+  aMsg.assign((const char *)bufP,bufSiz);
+  return smlUnlockReadBuffer(aInstance,bufSiz);
+} // benchEndMessage
+
+
+typedef std::vector<SmlAddPtr_t> TBenchCmdsVector;
+
+// encode the commands into messages of the instance's max message size
+static Ret_t benchEncode(InstanceID_t aInstance, sInt32 aMaxMsgSize, TBenchCmdsVector &aCmds, TStringList &aMessages, sInt64 &aTotalBytes)
+{
+  uInt32 msgID = 0;
+  bool msgopen = false;
+  Ret_t rc = SML_ERR_OK;
+  aTotalBytes = 0;
+  for (TBenchCmdsVector::iterator pos=aCmds.begin(); pos!=aCmds.end() && rc==SML_ERR_OK; pos++) {
+    for (int attempt=0; attempt<2; attempt++) {
+      if (!msgopen) {
+        rc = benchStartMessage(aInstance,++msgID);
+        if (rc!=SML_ERR_OK) break;
+        msgopen=true;
+      }
+      // check if command fits into current message
+      MemSize_t freemem;
+      smlStartEvaluation(aInstance);
+      Ret_t evalrc = smlAddCmd(aInstance,*pos);
+      smlEndEvaluation(aInstance,&freemem);
+      if (evalrc==SML_ERR_OK && (sInt32)freemem>=BENCH_MSGEND_RESERVE) {
+        // fits, commit the evaluated encoding
+        smlReuseEvaluation(aInstance);
+        rc = smlAddCmd(aInstance,*pos);
+        break;
+      }
+      if (attempt>0) {
+        // does not even fit into an empty message
+        CONSOLEPRINTF(("Item does not fit into a message of %ld bytes",(long)aMaxMsgSize));
+        rc = SML_ERR_XLT_BUF_ERR;
+        break;
+      }
+      // close this message and retry in a new one
+      aMessages.push_back("");
+      rc = benchEndMessage(aInstance,aMessages.back());
+      aTotalBytes += aMessages.back().size();
+      msgopen=false;
+      if (rc!=SML_ERR_OK) break;
+    }
+  }
+  if (msgopen && rc==SML_ERR_OK) {
+    aMessages.push_back("");
+    rc = benchEndMessage(aInstance,aMessages.back());
+    aTotalBytes += aMessages.back().size();
+  }
+  return rc;
+} // benchEncode
+
+
+// decode the messages (transcoded to XML by the sysytool callbacks)
+static Ret_t benchDecode(SmlEncoding_t aEncoding, sInt32 aMaxMsgSize, TStringList &aMessages)
+{
+  InstanceID_t decInstance, xmlOutInstance;
+  if (
+    !getSyncAppBase()->newSmlInstance(aEncoding, aMaxMsgSize, decInstance) ||
+    !getSyncAppBase()->newSmlInstance(SML_XML, 4*aMaxMsgSize+500*1024, xmlOutInstance)
+  ) {
+    CONSOLEPRINTF(("Error creating SyncML decoder"));
+    return SML_ERR_NOT_ENOUGH_SPACE;
+  }
+  smlSetCallbacks(decInstance, sysytoolCallbacks());
+  getSyncAppBase()->setSmlInstanceUserData(decInstance, xmlOutInstance);
+  Ret_t rc = SML_ERR_OK;
+  for (TStringList::iterator pos=aMessages.begin(); pos!=aMessages.end() && rc==SML_ERR_OK; pos++) {
+    MemPtr_t bufP;
+    MemSize_t bufSiz;
+    rc = smlLockWriteBuffer(decInstance,&bufP,&bufSiz);
+    if (rc!=SML_ERR_OK) break;
+    memcpy(bufP,pos->c_str(),pos->size());
+    smlUnlockWriteBuffer(decInstance,pos->size());
+    do {
+      rc = smlProcessData(decInstance, SML_NEXT_COMMAND);
+    } while (rc==SML_ERR_CONTINUE);
+    // discard the XML translation
+    if (smlLockReadBuffer(xmlOutInstance,&bufP,&bufSiz)==SML_ERR_OK)
+      smlUnlockReadBuffer(xmlOutInstance,bufSiz);
+  }
+  getSyncAppBase()->freeSmlInstance(decInstance);
+  getSyncAppBase()->freeSmlInstance(xmlOutInstance);
+  return rc;
+} // benchDecode
+
+
+// benchmark the sync pipeline phases of a datastore
+int syncBench(int argc, const char *argv[])
+{
+  if (argc<0) {
+    // help requested
+    CONSOLEPRINTF(("  bench <datastore name> <data file> [<item count>] [<max message size>] [xml|wbxml]"));
+    CONSOLEPRINTF(("    Measures parsing, generating, encoding and decoding of <item count> copies of the"));
+    CONSOLEPRINTF(("    data item for the specified datastore, results are printed as JSON. For WBXML,"));
+    CONSOLEPRINTF(("    size and speed are also measured with the WBXML string table enabled"));
+    return EXIT_SUCCESS;
+  }
+
+  TSyncSession *sessionP = NULL;
+  const char *datastore = NULL;
+  const char *rawfilename = NULL;
+  sInt32 numitems = 1000;
+  sInt32 maxmsgsize = 20000;
+  SmlEncoding_t encoding = SML_WBXML;
+
+  // check for argument
+  if (argc<2) {
+    CONSOLEPRINTF(("required datatype name and raw file name arguments"));
+    return EXIT_FAILURE;
+  }
+  datastore = argv[0];
+  rawfilename = argv[1];
+  if (argc>=3 && (StrToLong(argv[2],numitems)==0 || numitems<=0)) {
+    CONSOLEPRINTF(("invalid item count '%s'",argv[2]));
+    return EXIT_FAILURE;
+  }
+  if (argc>=4 && (StrToLong(argv[3],maxmsgsize)==0 || maxmsgsize<=BENCH_MSGEND_RESERVE)) {
+    CONSOLEPRINTF(("invalid max message size '%s'",argv[3]));
+    return EXIT_FAILURE;
+  }
+  if (argc>=5) {
+    if (strucmp(argv[4],"xml")==0)
+      encoding = SML_XML;
+    else if (strucmp(argv[4],"wbxml")!=0) {
+      CONSOLEPRINTF(("encoding must be xml or wbxml"));
+      return EXIT_FAILURE;
+    }
+  }
+
+  // get session to work with
+  sessionP =
+    static_cast<TSyncSessionDispatch *>(getSyncAppBase())->getSySyToolSession();
+  // configure session
+  sessionP->fRemoteCanHandleUTC = true; // run generator and parser in UTC enabled mode
+
+  // find datastore and its preferred types
+  TLocalEngineDS *datastoreP = sessionP->findLocalDataStore(datastore);
+  if (!datastoreP) {
+    CONSOLEPRINTF(("datastore type '%s' not found",datastore));
+    return EXIT_FAILURE;
+  }
+  TSyncItemType *inputtypeP = datastoreP->getPreferredRxItemType();
+  TSyncItemType *outputtypeP = datastoreP->getPreferredTxItemType();
+  if (!inputtypeP || !outputtypeP) {
+    CONSOLEPRINTF(("datastore has no preferred rx/tx types"));
+    return EXIT_FAILURE;
+  }
+  // prepare type usage
+  if (inputtypeP==outputtypeP)
+    inputtypeP->initDataTypeUse(datastoreP, true, true);
+  else {
+    inputtypeP->initDataTypeUse(datastoreP, false, true);
+    outputtypeP->initDataTypeUse(datastoreP, true, false);
+  }
+
+  // read data item
+  FILE *infile = fopen(rawfilename,"rb");
+  if (!infile) {
+    CONSOLEPRINTF(("Cannot open input file '%s' (%d)",rawfilename,errno));
+    return EXIT_FAILURE;
+  }
+  string rawdata;
+  char chunk[4096];
+  size_t n;
+  while ((n=fread(chunk,1,sizeof(chunk),infile))>0)
+    rawdata.append(chunk,n);
+  fclose(infile);
+
+  lineartime_t starttime;
+  double parseMS, generateMS, encodeMS, decodeMS;
+  sInt32 i;
+
+  // phase 1: parse transport format into internal items
+  TStatusCommand statusCmd(sessionP);
+  typedef std::vector<TSyncItem *> TBenchItemsVector;
+  TBenchItemsVector syncitems;
+  syncitems.reserve(numitems);
+  starttime = sessionP->getSystemNowAs(TCTX_UTC);
+  for (i=0; i<numitems; i++) {
+    SmlItemPtr_t smlitemP = newItem();
+    smlitemP->data=newPCDataStringX((const uInt8 *)rawdata.c_str(),true,rawdata.size());
+    TSyncItem *syncitemP = inputtypeP->newSyncItem(
+      smlitemP, sop_replace, fmt_chr, inputtypeP, datastoreP, statusCmd
+    );
+    smlFreeItemPtr(smlitemP);
+    if (!syncitemP) {
+      CONSOLEPRINTF(("Error converting input file to internal format (SyncML status code=%hd)",statusCmd.getStatusCode()));
+      for (TBenchItemsVector::iterator pos=syncitems.begin(); pos!=syncitems.end(); ++pos)
+        delete *pos;
+      return EXIT_FAILURE;
+    }
+    syncitems.push_back(syncitemP);
+  }
+  parseMS = benchElapsedMS(sessionP,starttime);
+
+  // phase 2: generate transport format from internal items
+  typedef std::vector<SmlItemPtr_t> TBenchSmlItemsVector;
+  TBenchSmlItemsVector smlitems;
+  smlitems.reserve(numitems);
+  starttime = sessionP->getSystemNowAs(TCTX_UTC);
+  for (i=0; i<numitems; i++) {
+    TSyncItem *outsyncitemP = outputtypeP->newSyncItem(outputtypeP, datastoreP);
+    outsyncitemP->replaceDataFrom(*syncitems[i]);
+    delete syncitems[i];
+    SmlItemPtr_t smlitemP = outputtypeP->newSmlItem(outsyncitemP, datastoreP);
+    delete outsyncitemP;
+    if (!smlitemP) {
+      CONSOLEPRINTF(("Could not convert back item data"));
+      // items after i were not converted yet, i itself is already deleted
+      while (++i<numitems)
+        delete syncitems[i];
+      for (TBenchSmlItemsVector::iterator pos=smlitems.begin(); pos!=smlitems.end(); ++pos)
+        smlFreeItemPtr(*pos);
+      return EXIT_FAILURE;
+    }
+    smlitems.push_back(smlitemP);
+  }
+  syncitems.clear();
+  generateMS = benchElapsedMS(sessionP,starttime);
+
+  // phase 3: encode the items as Add commands into messages of max message size
+  TBenchCmdsVector cmds;
+  cmds.reserve(numitems);
+  for (i=0; i<numitems; i++) {
+    SmlAddPtr_t addP = SML_NEW(SmlGenericCmd_t);
+    addP->elementType=SML_PE_ADD;
+    addP->cmdID=newPCDataLong(i+1);
+    addP->flags=0;
+    addP->cred=NULL;
+    addP->meta=NULL;
+    addP->itemList=SML_NEW(SmlItemList_t);
+    addP->itemList->next=NULL;
+    addP->itemList->item=smlitems[i];
+    smlitems[i]=NULL; // now owned by command
+    cmds.push_back(addP);
+  }
+  smlitems.clear();
+  InstanceID_t encInstance;
+  if (!getSyncAppBase()->newSmlInstance(encoding, maxmsgsize, encInstance)) {
+    CONSOLEPRINTF(("Error creating SyncML encoder"));
+    for (i=0; i<numitems; i++)
+      smlFreeProtoElement(cmds[i]);
+    return EXIT_FAILURE;
+  }
+  TStringList messages;
+  sInt64 totalbytes;
+  starttime = sessionP->getSystemNowAs(TCTX_UTC);
+  Ret_t rc = benchEncode(encInstance,maxmsgsize,cmds,messages,totalbytes);
+  encodeMS = benchElapsedMS(sessionP,starttime);
+  // - for WBXML, encode again with string table to compare size against CPU cost
+  TStringList stmessages;
+  sInt64 sttotalbytes = 0;
+  double stEncodeMS = 0, stDecodeMS = 0;
+  if (encoding==SML_WBXML && rc==SML_ERR_OK) {
+    smlSetWBXMLStringTable(encInstance,true);
+    starttime = sessionP->getSystemNowAs(TCTX_UTC);
+    rc = benchEncode(encInstance,maxmsgsize,cmds,stmessages,sttotalbytes);
+    stEncodeMS = benchElapsedMS(sessionP,starttime);
+  }
+  getSyncAppBase()->freeSmlInstance(encInstance);
+  for (i=0; i<numitems; i++)
+    smlFreeProtoElement(cmds[i]);
+  cmds.clear();
+  if (rc!=SML_ERR_OK) {
+    CONSOLEPRINTF(("Error encoding messages, rc=%d",(int)rc));
+    return EXIT_FAILURE;
+  }
+
+  // phase 4: decode the messages again (transcoded to XML by the sysytool callbacks)
+  starttime = sessionP->getSystemNowAs(TCTX_UTC);
+  rc = benchDecode(encoding,maxmsgsize,messages);
+  decodeMS = benchElapsedMS(sessionP,starttime);
+  if (rc==SML_ERR_OK && !stmessages.empty()) {
+    // - string table messages must decode as well
+    starttime = sessionP->getSystemNowAs(TCTX_UTC);
+    rc = benchDecode(encoding,maxmsgsize,stmessages);
+    stDecodeMS = benchElapsedMS(sessionP,starttime);
+  }
+  if (rc!=SML_ERR_OK) {
+    CONSOLEPRINTF(("Error decoding messages, rc=%d",(int)rc));
+    return EXIT_FAILURE;
+  }
+
+  // peak memory
+  long peakRSSkB = -1;
+  #ifdef LINUX
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)==0)
+    peakRSSkB = usage.ru_maxrss;
+  #endif
+
+  // report
+  CONSOLEPRINTF(("{"));
+  CONSOLEPRINTF(("  \"datastore\": \"%s\",",datastore));
+  CONSOLEPRINTF(("  \"encoding\": \"%s\",",encoding==SML_XML ? "xml" : "wbxml"));
+  CONSOLEPRINTF(("  \"items\": %ld,",(long)numitems));
+  CONSOLEPRINTF(("  \"maxmsgsize\": %ld,",(long)maxmsgsize));
+  CONSOLEPRINTF(("  \"messages\": %ld,",(long)messages.size()));
+  CONSOLEPRINTF(("  \"bytes_per_message\": %.1f,",(double)totalbytes/messages.size()));
+  CONSOLEPRINTF(("  \"parse_items_per_sec\": %.1f,",benchRate(numitems,parseMS)));
+  CONSOLEPRINTF(("  \"generate_items_per_sec\": %.1f,",benchRate(numitems,generateMS)));
+  CONSOLEPRINTF(("  \"encode_items_per_sec\": %.1f,",benchRate(numitems,encodeMS)));
+  CONSOLEPRINTF(("  \"decode_items_per_sec\": %.1f,",benchRate(numitems,decodeMS)));
+  if (!stmessages.empty()) {
+    CONSOLEPRINTF(("  \"strtbl_bytes_per_message\": %.1f,",(double)sttotalbytes/stmessages.size()));
+    CONSOLEPRINTF(("  \"strtbl_size_percent\": %.1f,",totalbytes>0 ? sttotalbytes*100.0/totalbytes : 0));
+    CONSOLEPRINTF(("  \"strtbl_encode_items_per_sec\": %.1f,",benchRate(numitems,stEncodeMS)));
+    CONSOLEPRINTF(("  \"strtbl_decode_items_per_sec\": %.1f,",benchRate(numitems,stDecodeMS)));
+  }
+  CONSOLEPRINTF(("  \"peak_rss_kb\": %ld",peakRSSkB));
+  CONSOLEPRINTF(("}"));
+
+  return EXIT_SUCCESS;
+} // syncBench
+
 #endif // SYSYNC_TOOL
 
 
@@ -3188,11 +3558,27 @@ TSyError TSyncAgent::ServerSessionStep(uInt16 &aStepCmd, TEngineProgressInfo *aI
     // Waiting for SyncML request data
     case ses_needdata:
       switch (stepCmdIn) {
+        case STEPCMD_GOTPARTIALDATA :
         case STEPCMD_GOTDATA : {
           // got data, check content type
+          bool partial = stepCmdIn==STEPCMD_GOTPARTIALDATA;
           MemPtr_t data = NULL;
           smlPeekMessageBuffer(getSmlWorkspaceID(), false, &data, &fRequestSize); // get request size
+          if (isIncomingPartial()) {
+            // next part of a message we are already processing, content type was checked with the first part
+            setIncomingPartial(partial);
+            fServerEngineState = ses_processing;
+            aStepCmd = STEPCMD_OK;
+            sta = LOCERR_OK;
+            break;
+          }
           SmlEncoding_t enc = TSyncAppBase::encodingFromData(data, fRequestSize);
+          if (partial && enc==SML_UNDEF) {
+            // first part too short to tell, wait for more
+            aStepCmd = STEPCMD_NEEDDATA;
+            sta = LOCERR_OK;
+            break;
+          }
           if (getEncoding()==SML_UNDEF) {
             // no encoding known so far - use what we found from looking at data
             PDEBUGPRINTFX(DBG_ERROR,(
@@ -3219,6 +3605,7 @@ TSyError TSyncAgent::ServerSessionStep(uInt16 &aStepCmd, TEngineProgressInfo *aI
             break;
           }
           // content type ok - switch to processing mode
+          setIncomingPartial(partial);
           fServerEngineState = ses_processing;
           aStepCmd = STEPCMD_OK;
           sta = LOCERR_OK;
@@ -3279,8 +3666,9 @@ TSyError TSyncAgent::ServerProcessingStep(uInt16 &aStepCmd, TEngineProgressInfo
   InstanceID_t myInstance = getSmlWorkspaceID();
   Ret_t rc;
 
-  // now process next command
-  PDEBUGPRINTFX(DBG_EXOTIC,("Calling smlProcessData(NEXT_COMMAND)"));
+  // now process next command, or all complete ones of a partially received message
+  bool partial = isIncomingPartial();
+  PDEBUGPRINTFX(DBG_EXOTIC,("Calling smlProcessData(%s)",partial ? "AVAILABLE_COMMANDS" : "NEXT_COMMAND"));
   #ifdef SYDEBUG
   MemPtr_t data = NULL;
   MemSize_t datasize;
@@ -3288,9 +3676,16 @@ TSyError TSyncAgent::ServerProcessingStep(uInt16 &aStepCmd, TEngineProgressInfo
   #endif
   rc=smlProcessData(
     myInstance,
-    SML_NEXT_COMMAND
+    partial ? SML_AVAILABLE_COMMANDS : SML_NEXT_COMMAND
   );
-  if (rc==SML_ERR_CONTINUE) {
+  if (rc==SML_ERR_NEED_MORE_DATA) {
+    // processed everything that is complete, need next part of the message
+    // - engine state goes back to waiting for data
+    aStepCmd = STEPCMD_NEEDDATA;
+    fServerEngineState = ses_needdata;
+    sta = LOCERR_OK;
+  }
+  else if (rc==SML_ERR_CONTINUE) {
     // processed ok, but message not completely processed yet
     // - engine state remains as is
     aStepCmd = STEPCMD_OK; // ok w/o progress %%% for now, progress is delivered via queue in next step
@@ -3465,9 +3860,20 @@ TSyError TSyncAgent::ClientSessionStep(uInt16 &aStepCmd, TEngineProgressInfo *aI
     // Waiting for SyncML data
     case ces_needdata: {
       switch (stepCmdIn) {
+        case STEPCMD_GOTPARTIALDATA :
         case STEPCMD_GOTDATA : {
+          bool partial = stepCmdIn==STEPCMD_GOTPARTIALDATA;
+          if (isIncomingPartial()) {
+            // next part of a message we are already processing, content type was checked with the first part
+            if (!partial) SESSION_PROGRESS_EVENT(this,pev_recvend,NULL,0,0,0);
+            setIncomingPartial(partial);
+            fClientEngineState = ces_processing;
+            aStepCmd = STEPCMD_OK;
+            sta = LOCERR_OK;
+            break;
+          }
           // got data, now start processing it
-          SESSION_PROGRESS_EVENT(this,pev_recvend,NULL,0,0,0);
+          if (!partial) SESSION_PROGRESS_EVENT(this,pev_recvend,NULL,0,0,0);
           // check content type now
           MemPtr_t data = NULL;
           MemSize_t datasize;
@@ -3484,6 +3890,12 @@ TSyError TSyncAgent::ClientSessionStep(uInt16 &aStepCmd, TEngineProgressInfo *aI
 
           // check content type
           SmlEncoding_t enc = TSyncAppBase::encodingFromData(data, datasize);
+          if (partial && enc==SML_UNDEF) {
+            // first part too short to tell, wait for more
+            aStepCmd = STEPCMD_NEEDDATA;
+            sta = LOCERR_OK;
+            break;
+          }
           if (enc!=getEncoding()) {
             PDEBUGPRINTFX(DBG_ERROR,("Incoming data is not SyncML"));
             sta = LOCERR_BADCONTENT; // bad content type
@@ -3499,6 +3911,7 @@ TSyError TSyncAgent::ClientSessionStep(uInt16 &aStepCmd, TEngineProgressInfo *aI
           }
           // content type ok - switch to processing mode
           fIgnoreMsgErrs=false; // do not ignore errors by default
+          setIncomingPartial(partial);
           fClientEngineState = ces_processing;
           aStepCmd = STEPCMD_OK;
           sta = LOCERR_OK;
@@ -3588,8 +4001,9 @@ TSyError TSyncAgent::ClientProcessingStep(uInt16 &aStepCmd, TEngineProgressInfo
   Ret_t rc;
   localstatus sta = LOCERR_WRONGUSAGE;
 
-  // now process next command
-  PDEBUGPRINTFX(DBG_EXOTIC,("Calling smlProcessData(NEXT_COMMAND)"));
+  // now process next command, or all complete ones of a partially received message
+  bool partial = isIncomingPartial();
+  PDEBUGPRINTFX(DBG_EXOTIC,("Calling smlProcessData(%s)",partial ? "AVAILABLE_COMMANDS" : "NEXT_COMMAND"));
   #ifdef SYDEBUG
   MemPtr_t data = NULL;
   MemSize_t datasize;
@@ -3597,9 +4011,16 @@ TSyError TSyncAgent::ClientProcessingStep(uInt16 &aStepCmd, TEngineProgressInfo
   #endif
   rc=smlProcessData(
     myInstance,
-    SML_NEXT_COMMAND
+    partial ? SML_AVAILABLE_COMMANDS : SML_NEXT_COMMAND
   );
-  if (rc==SML_ERR_CONTINUE) {
+  if (rc==SML_ERR_NEED_MORE_DATA) {
+    // processed everything that is complete, need next part of the message
+    // - engine state goes back to waiting for data
+    aStepCmd = STEPCMD_NEEDDATA;
+    fClientEngineState = ces_needdata;
+    sta = LOCERR_OK;
+  }
+  else if (rc==SML_ERR_CONTINUE) {
     // processed ok, but message not completely processed yet
     // - engine state remains as is
     aStepCmd = STEPCMD_OK; // ok w/o progress %%% for now, progress is delivered via queue in next step
@@ -3634,7 +4055,7 @@ TSyError TSyncAgent::ClientProcessingStep(uInt16 &aStepCmd, TEngineProgressInfo
     sta = LOCERR_OK;
   }
   // now check if this is a session restart
-  if (sta==LOCERR_OK && isStarting()) {
+  if (sta==LOCERR_OK && aStepCmd!=STEPCMD_NEEDDATA && isStarting()) {
     // this is still the beginning of a session, which means
     // that we are restarting the session and caller should close
     // possibly open communication with the server before sending the next message
@@ -52,6 +52,7 @@ class TSyncSessionHandle {
 #ifdef SYSYNC_TOOL
 int testLogin(int argc, const char *argv[]);
 int convertData(int argc, const char *argv[]);
+int syncBench(int argc, const char *argv[]);
 #endif
 
 
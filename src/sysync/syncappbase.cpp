@@ -286,6 +286,10 @@ void TRootConfig::clear(void)
   // - init message size
   fLocalMaxMsgSize=DEFAULT_MAXMSGSIZE;
   fLocalMaxObjSize=DEFAULT_MAXOBJSIZE;
+  #ifdef MULTI_THREAD_SUPPORT
+  // - no worker pool by default
+  fWorkerThreads=0;
+  #endif
   // - system time zone
   fSystemTimeContext=TCTX_SYSTEM; // default to automatic detection
   #ifdef ENGINEINTERFACE_SUPPORT
@@ -403,6 +407,13 @@ bool TRootConfig::localStartElement(const char *aElementName, const char **aAttr
     expectUInt32(fLocalMaxMsgSize);
   else if (strucmp(aElementName,"maxobjsize")==0)
     expectUInt32(fLocalMaxObjSize);
+  else if (strucmp(aElementName,"workerthreads")==0) {
+    #ifdef MULTI_THREAD_SUPPORT
+    expectUInt16(fWorkerThreads);
+    #else
+    expectAll(); // no threads, simply ignore contents
+    #endif
+  }
   else if (strucmp(aElementName,"maxconcurrentsessions")==0) {
     #ifdef CUSTOMIZABLE_DEVICES_LIMIT
     expectInt32(fConcurrentDeviceLimit);
@@ -1238,6 +1249,13 @@ TSyncAppBase::TSyncAppBase() :
   #endif
   #endif
 
+  #ifdef MULTI_THREAD_SUPPORT
+  // worker pool is created on first use
+  fWorkerPoolP = NULL;
+  fWorkerPoolMutex = newMutex();
+  fWorkerPoolStopped = false;
+  #endif
+
   // TODO: put this somewhere where the return code can be checked and reported to the user of TSyncAppBase
   fAppZones.initialize();
 } // TSyncAppBase::TSyncAppBase
@@ -1274,6 +1292,12 @@ TSyncAppBase::~TSyncAppBase()
     ));
   }
   #endif
+  #ifdef MULTI_THREAD_SUPPORT
+  // complete pending work and stop worker threads before config goes away
+  // (usually, derived classes have done this already)
+  stopWorkerPool();
+  freeMutex(fWorkerPoolMutex);
+  #endif
   // delete the config now
   #ifdef SYDEBUG
   // - but first make sure applogger does not refer to it any more
@@ -1285,6 +1309,41 @@ TSyncAppBase::~TSyncAppBase()
 
 
 
+#ifdef MULTI_THREAD_SUPPORT
+
+// get the shared worker pool, create it on first use
+TWorkerPool *TSyncAppBase::getWorkerPool(void)
+{
+  lockMutex(fWorkerPoolMutex);
+  if (!fWorkerPoolP && !fWorkerPoolStopped && fConfigP && fConfigP->fWorkerThreads>0) {
+    PDEBUGPRINTFX(DBG_HOT,("Starting worker pool with %hd threads",fConfigP->fWorkerThreads));
+    fWorkerPoolP = new TWorkerPool(fConfigP->fWorkerThreads);
+  }
+  unlockMutex(fWorkerPoolMutex);
+  return fWorkerPoolP;
+} // TSyncAppBase::getWorkerPool
+
+
+// complete all posted work and stop the worker pool
+void TSyncAppBase::stopWorkerPool(void)
+{
+  lockMutex(fWorkerPoolMutex);
+  fWorkerPoolStopped = true;
+  TWorkerPool *poolP = fWorkerPoolP;
+  unlockMutex(fWorkerPoolMutex);
+  // Note: not deleted under the mutex, as work still running might call getWorkerPool()
+  //   to post follow-up work (which the pool completes as well before it terminates)
+  if (poolP) {
+    delete poolP;
+    lockMutex(fWorkerPoolMutex);
+    fWorkerPoolP = NULL;
+    unlockMutex(fWorkerPoolMutex);
+  }
+} // TSyncAppBase::stopWorkerPool
+
+#endif // MULTI_THREAD_SUPPORT
+
+
 #ifndef HARDCODED_CONFIG
 
 // get config variables
@@ -3418,6 +3477,7 @@ bool TRootConfig::parseAgentConfig(const char **aAttributes, sInt32 aLine)
 // SyncML toolkit callback implementations for sysytool debug decoder
 
 // userData must be instance_id of XML instance to generate XML message into
+// decoded content is freed after being transcoded
 
 static Ret_t sysytoolStartMessageCallback(InstanceID_t id, VoidPtr_t userData, SmlSyncHdrPtr_t pContent)
 {
@@ -3425,6 +3485,7 @@ static Ret_t sysytoolStartMessageCallback(InstanceID_t id, VoidPtr_t userData, S
   sInt16 hdrVers;
   StrToEnum(SyncMLVerDTDNames,numSyncMLVersions,hdrVers,smlPCDataToCharP(pContent->version));
   smlStartMessageExt(GET_XMLOUTINSTANCE(userData),pContent,SmlVersionCodes[hdrVers]);
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3437,6 +3498,7 @@ static Ret_t sysytoolEndMessageCallback(InstanceID_t id, VoidPtr_t userData, Boo
 static Ret_t sysytoolStartSyncCallback(InstanceID_t id, VoidPtr_t userData, SmlSyncPtr_t pContent)
 {
   ERRCHK("<Sync>",smlStartSync(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3452,6 +3514,7 @@ static Ret_t sysytoolEndSyncCallback(InstanceID_t id, VoidPtr_t userData)
 static Ret_t sysytoolStartAtomicCallback(InstanceID_t id, VoidPtr_t userData, SmlAtomicPtr_t pContent)
 {
   ERRCHK("<Atomic>",smlStartAtomic(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3468,6 +3531,7 @@ static Ret_t sysytoolEndAtomicCallback(InstanceID_t id, VoidPtr_t userData)
 static Ret_t sysytoolStartSequenceCallback(InstanceID_t id, VoidPtr_t userData, SmlSequencePtr_t pContent)
 {
   ERRCHK("<Sequence>",smlStartSequence(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3482,12 +3546,14 @@ static Ret_t sysytoolEndSequenceCallback(InstanceID_t id, VoidPtr_t userData)
 static Ret_t sysytoolAddCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlAddPtr_t pContent)
 {
   ERRCHK("<Add>",smlAddCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
 static Ret_t sysytoolAlertCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlAlertPtr_t pContent)
 {
   ERRCHK("<Alert>",smlAlertCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3495,18 +3561,21 @@ static Ret_t sysytoolAlertCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlAl
 static Ret_t sysytoolDeleteCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlDeletePtr_t pContent)
 {
   ERRCHK("<Delete>",smlDeleteCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
 static Ret_t sysytoolGetCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlGetPtr_t pContent)
 {
   ERRCHK("<Get>",smlGetCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
 static Ret_t sysytoolPutCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlPutPtr_t pContent)
 {
   ERRCHK("<Put>",smlPutCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3514,6 +3583,7 @@ static Ret_t sysytoolPutCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlPutP
 static Ret_t sysytoolMapCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlMapPtr_t pContent)
 {
   ERRCHK("<Map>",smlMapCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 #endif
@@ -3522,6 +3592,7 @@ static Ret_t sysytoolMapCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlMapP
 static Ret_t sysytoolResultsCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlResultsPtr_t pContent)
 {
   ERRCHK("<Results>",smlResultsCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 #endif
@@ -3529,12 +3600,14 @@ static Ret_t sysytoolResultsCmdCallback(InstanceID_t id, VoidPtr_t userData, Sml
 static Ret_t sysytoolStatusCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlStatusPtr_t pContent)
 {
   ERRCHK("<Status>",smlStatusCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
 static Ret_t sysytoolReplaceCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlReplacePtr_t pContent)
 {
   ERRCHK("<Replace>",smlReplaceCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3542,6 +3615,7 @@ static Ret_t sysytoolReplaceCmdCallback(InstanceID_t id, VoidPtr_t userData, Sml
 static Ret_t sysytoolCopyCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlCopyPtr_t pContent)
 {
   ERRCHK("<Copy>",smlCopyCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 #endif
@@ -3549,6 +3623,7 @@ static Ret_t sysytoolCopyCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlCop
 static Ret_t sysytoolMoveCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlMovePtr_t pContent)
 {
   ERRCHK("<Move>",smlMoveCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 
@@ -3556,6 +3631,7 @@ static Ret_t sysytoolMoveCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlMov
 static Ret_t sysytoolExecCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlExecPtr_t pContent)
 {
   ERRCHK("<Exec>",smlExecCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 #endif
@@ -3565,6 +3641,7 @@ static Ret_t sysytoolExecCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlExe
 static Ret_t sysytoolSearchCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlSearchPtr_t pContent)
 {
   ERRCHK("<Search>",smlSearchCmd(GET_XMLOUTINSTANCE(userData),pContent));
+  smlFreeProtoElement(pContent);
   return SML_ERR_OK;
 }
 #endif
@@ -3628,6 +3705,13 @@ static const SmlCallbacks_t sysyncToolCallbacks = {
 }; /* sml_callbacks struct */
 
 
+// get the sysytool callbacks (for other tool commands transcoding messages to XML)
+const SmlCallbacks_t *sysytoolCallbacks(void)
+{
+  return &sysyncToolCallbacks;
+} // sysytoolCallbacks
+
+
 // WBXML to XML conversion
 int wbxmlConv(int argc, const char *argv[])
 {
@@ -3735,6 +3819,222 @@ int wbxmlConv(int argc, const char *argv[])
   return EXIT_SUCCESS;
 } // wbxmlConv
 
+
+// SyncML message decoding benchmark
+int decodeBench(int argc, const char *argv[])
+{
+  if (argc<0) {
+    // help requested
+    CONSOLEPRINTF(("  decodebench <xml or wbxml message file> [<repeat count>]"));
+    CONSOLEPRINTF(("    Decodes a recorded SyncML message repeatedly using SyncML-Toolkit (including"));
+    CONSOLEPRINTF(("    transcoding to XML like wbxml2xml) and prints the throughput as JSON"));
+    return EXIT_SUCCESS;
+  }
+
+  // check for argument
+  if (argc<1 || argc>2) {
+    CONSOLEPRINTF(("1 or 2 arguments required"));
+    return EXIT_FAILURE;
+  }
+  sInt32 repeat = 100;
+  if (argc>1 && (StrToLong(argv[1],repeat)==0 || repeat<=0)) {
+    CONSOLEPRINTF(("invalid repeat count '%s'",argv[1]));
+    return EXIT_FAILURE;
+  }
+
+  // read message
+  FILE *inFile = fopen(argv[0],"rb");
+  if (!inFile) {
+    CONSOLEPRINTF(("Error opening input file '%s', error=%d",argv[0],errno));
+    return EXIT_FAILURE;
+  }
+  string msg;
+  char chunk[4096];
+  size_t n;
+  while ((n=fread(chunk,1,sizeof(chunk),inFile))>0)
+    msg.append(chunk,n);
+  fclose(inFile);
+  if (msg.empty()) {
+    CONSOLEPRINTF(("No data in input file"));
+    return EXIT_FAILURE;
+  }
+  // XML messages start with a tag, everything else is assumed to be WBXML
+  size_t i = msg.find_first_not_of(" \t\r\n");
+  SmlEncoding_t encoding = (i!=string::npos && msg[i]=='<') ? SML_XML : SML_WBXML;
+
+  // prepare instances for decoding and for the XML translation
+  InstanceID_t decInstance, xmlOutInstance;
+  if (
+    !getSyncAppBase()->newSmlInstance(encoding, msg.size()+1024, decInstance) ||
+    !getSyncAppBase()->newSmlInstance(SML_XML, 4*msg.size()+500*1024, xmlOutInstance)
+  ) {
+    CONSOLEPRINTF(("Error creating SyncML decoder"));
+    return EXIT_FAILURE;
+  }
+  smlSetCallbacks(decInstance, &sysyncToolCallbacks);
+  getSyncAppBase()->setSmlInstanceUserData(decInstance, xmlOutInstance);
+
+  // decode
+  Ret_t rc = SML_ERR_OK;
+  sInt32 round;
+  lineartime_t starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (round=0; round<repeat && rc==SML_ERR_OK; round++) {
+    MemPtr_t bufP;
+    MemSize_t bufSiz;
+    rc = smlLockWriteBuffer(decInstance,&bufP,&bufSiz);
+    if (rc!=SML_ERR_OK) break;
+    memcpy(bufP,msg.c_str(),msg.size());
+    smlUnlockWriteBuffer(decInstance,msg.size());
+    do {
+      rc = smlProcessData(decInstance, SML_NEXT_COMMAND);
+    } while (rc==SML_ERR_CONTINUE);
+    // discard the XML translation
+    if (smlLockReadBuffer(xmlOutInstance,&bufP,&bufSiz)==SML_ERR_OK)
+      smlUnlockReadBuffer(xmlOutInstance,bufSiz);
+  }
+  double ms = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+  getSyncAppBase()->freeSmlInstance(decInstance);
+  getSyncAppBase()->freeSmlInstance(xmlOutInstance);
+  if (rc!=SML_ERR_OK) {
+    CONSOLEPRINTF(("Error while decoding message in round %ld, rc=%d",(long)round,(int)rc));
+    return EXIT_FAILURE;
+  }
+
+  // report
+  CONSOLEPRINTF(("{"));
+  CONSOLEPRINTF(("  \"encoding\": \"%s\",",encoding==SML_XML ? "xml" : "wbxml"));
+  CONSOLEPRINTF(("  \"message_bytes\": %ld,",(long)msg.size()));
+  CONSOLEPRINTF(("  \"rounds\": %ld,",(long)repeat));
+  CONSOLEPRINTF(("  \"ms_per_message\": %.3f,",ms/repeat));
+  CONSOLEPRINTF(("  \"mb_per_sec\": %.2f",ms>0 ? (double)msg.size()*repeat/1024/1024*1000/ms : 0));
+  CONSOLEPRINTF(("}"));
+  return EXIT_SUCCESS;
+} // decodeBench
+
+
+// base64 and quoted-printable codec benchmark
+int codecBench(int argc, const char *argv[])
+{
+  if (argc<0) {
+    // help requested
+    CONSOLEPRINTF(("  codecbench [<data file> [<repeat count>]]"));
+    CONSOLEPRINTF(("    Encodes and decodes the data (default: 256k of generated text with some 8-bit"));
+    CONSOLEPRINTF(("    chars) with base64 and quoted-printable and prints the throughput as JSON"));
+    return EXIT_SUCCESS;
+  }
+
+  // check for argument
+  if (argc>2) {
+    CONSOLEPRINTF(("0 to 2 arguments required"));
+    return EXIT_FAILURE;
+  }
+  sInt32 repeat = 100;
+  if (argc>1 && (StrToLong(argv[1],repeat)==0 || repeat<=0)) {
+    CONSOLEPRINTF(("invalid repeat count '%s'",argv[1]));
+    return EXIT_FAILURE;
+  }
+
+  // get data
+  string data;
+  if (argc>0) {
+    FILE *inFile = fopen(argv[0],"rb");
+    if (!inFile) {
+      CONSOLEPRINTF(("Error opening input file '%s', error=%d",argv[0],errno));
+      return EXIT_FAILURE;
+    }
+    char chunk[4096];
+    size_t n;
+    while ((n=fread(chunk,1,sizeof(chunk),inFile))>0)
+      data.append(chunk,n);
+    fclose(inFile);
+  }
+  else {
+    // text with line ends and an occasional 8-bit char, like a contact note
+    uInt32 r = 4711;
+    for (sInt32 k=0; k<256*1024; k++) {
+      r = r*1103515245+12345;
+      uInt32 v = (r>>16) % 100;
+      data += v<2 ? '\n' : (v<4 ? (char)(0xC0+v) : (char)('a'+v%26));
+    }
+  }
+  if (data.empty()) {
+    CONSOLEPRINTF(("No data in input file"));
+    return EXIT_FAILURE;
+  }
+  const uInt8 *bin = (const uInt8 *)data.c_str();
+  uInt32 binsz = data.size();
+
+  // encoded versions for the decoders
+  string b64text, qptext, out;
+  appendEncoded(bin,binsz,b64text,enc_base64,MIME_MAXLINESIZE-1,0,false);
+  appendEncoded(bin,binsz,qptext,enc_quoted_printable,MIME_MAXLINESIZE-1,0,false,true);
+
+  // measure
+  // - malloc-ed buffer, appended to the string afterwards
+  lineartime_t starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (sInt32 round=0; round<repeat; round++) {
+    uInt32 l;
+    char *b = b64::encode(bin,binsz,&l,MIME_MAXLINESIZE-1);
+    out.assign(b,l);
+    b64::free(b);
+  }
+  double encBufMs = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+  starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (sInt32 round=0; round<repeat; round++) {
+    uInt32 l;
+    uInt8 *b = b64::decode(b64text.c_str(),b64text.size(),&l);
+    out.assign((const char *)b,l);
+    b64::free(b);
+  }
+  double decBufMs = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+  // - appending directly into a preallocated string
+  out.reserve(b64text.size()+qptext.size());
+  starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (sInt32 round=0; round<repeat; round++) {
+    out.erase();
+    b64::appendEncoded(out,bin,binsz,MIME_MAXLINESIZE-1);
+  }
+  double encMs = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+  starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (sInt32 round=0; round<repeat; round++) {
+    out.erase();
+    b64::appendDecoded(out,b64text.c_str(),b64text.size());
+  }
+  double decMs = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+  if (out!=data) {
+    CONSOLEPRINTF(("base64 round trip failed"));
+    return EXIT_FAILURE;
+  }
+  // - quoted printable
+  starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (sInt32 round=0; round<repeat; round++) {
+    out.erase();
+    appendEncoded(bin,binsz,out,enc_quoted_printable,MIME_MAXLINESIZE-1,0,false,true);
+  }
+  double qpEncMs = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+  starttime = getSyncAppBase()->getSystemNowAs(TCTX_UTC);
+  for (sInt32 round=0; round<repeat; round++) {
+    out.erase();
+    appendDecoded(qptext.c_str(),qptext.size(),out,enc_quoted_printable);
+  }
+  double qpDecMs = (double)(getSyncAppBase()->getSystemNowAs(TCTX_UTC)-starttime)*1000.0/secondToLinearTimeFactor;
+
+  // report (MB of unencoded data per second)
+  double mb = (double)binsz*repeat/1024/1024;
+  CONSOLEPRINTF(("{"));
+  CONSOLEPRINTF(("  \"data_bytes\": %ld,",(long)binsz));
+  CONSOLEPRINTF(("  \"rounds\": %ld,",(long)repeat));
+  CONSOLEPRINTF(("  \"b64_encode_buffer_mb_per_sec\": %.2f,",encBufMs>0 ? mb*1000/encBufMs : 0));
+  CONSOLEPRINTF(("  \"b64_encode_append_mb_per_sec\": %.2f,",encMs>0 ? mb*1000/encMs : 0));
+  CONSOLEPRINTF(("  \"b64_decode_buffer_mb_per_sec\": %.2f,",decBufMs>0 ? mb*1000/decBufMs : 0));
+  CONSOLEPRINTF(("  \"b64_decode_append_mb_per_sec\": %.2f,",decMs>0 ? mb*1000/decMs : 0));
+  CONSOLEPRINTF(("  \"qp_bytes\": %ld,",(long)qptext.size()));
+  CONSOLEPRINTF(("  \"qp_encode_mb_per_sec\": %.2f,",qpEncMs>0 ? mb*1000/qpEncMs : 0));
+  CONSOLEPRINTF(("  \"qp_decode_mb_per_sec\": %.2f",qpDecMs>0 ? mb*1000/qpDecMs : 0));
+  CONSOLEPRINTF(("}"));
+  return EXIT_SUCCESS;
+} // codecBench
+
 #endif // SYSYNC_TOOL
 
 
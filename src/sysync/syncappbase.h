@@ -18,6 +18,10 @@
 
 #include "global_progress.h"
 
+#ifdef MULTI_THREAD_SUPPORT
+#include "workerpool.h"
+#endif
+
 // expat if not hardcoded config
 #ifndef HARDCODED_CONFIG
 # ifdef HAVE_EXPAT
@@ -36,6 +40,12 @@ namespace sysync {
 #ifdef SYSYNC_TOOL
 // WBXML to XML conversion
 int wbxmlConv(int argc, const char *argv[]);
+// SyncML message decoding benchmark
+int decodeBench(int argc, const char *argv[]);
+// base64 and quoted-printable codec benchmark
+int codecBench(int argc, const char *argv[]);
+// callbacks transcoding a decoded message into the XML instance set as userdata
+const SmlCallbacks_t *sysytoolCallbacks(void);
 #endif
 
 // XML config doc name (can be overridden in target_options if needed)
@@ -401,6 +411,10 @@ public:
   // SyncML encoder/decoder parameters
   uInt32 fLocalMaxMsgSize; // my own maxmsgsize
   uInt32 fLocalMaxObjSize; // my own maxobjsize, if 0, large object support is disabled
+  #ifdef MULTI_THREAD_SUPPORT
+  // number of threads in the shared worker pool, 0 = no worker pool
+  uInt16 fWorkerThreads;
+  #endif
   // - System time context (usually TCTX_SYSTEM, but might be explicitly set if system TZ info is not available)
   timecontext_t fSystemTimeContext;
 protected:
@@ -659,6 +673,13 @@ public:
   #endif
   // - check for Feature enabled
   virtual bool isFeatureEnabled(uInt16 aFeatureNo) { return false; /* none enabled by default */ };
+  #ifdef MULTI_THREAD_SUPPORT
+  // - shared worker thread pool, created on first use. NULL if no <workerthreads> are configured
+  TWorkerPool *getWorkerPool(void);
+  // - complete all work posted to the worker pool and stop it (no new pool will be created afterwards)
+  //   Must be called by derived classes before they tear down anything posted work might access
+  void stopWorkerPool(void);
+  #endif
   #ifdef CONCURRENT_DEVICES_LIMIT
   // check if session count is exceeded
   void checkSessionCount(sInt32 aSessionCount, TSyncSession *aSessionP);
@@ -677,6 +698,12 @@ private:
   #ifdef SYDEBUG
   TDebugLogger fAppLogger; // the logger
   #endif
+  #ifdef MULTI_THREAD_SUPPORT
+  // shared worker pool
+  TWorkerPool *fWorkerPoolP;
+  MutexPtr_t fWorkerPoolMutex;
+  bool fWorkerPoolStopped;
+  #endif
 }; // TSyncAppBase
 
 
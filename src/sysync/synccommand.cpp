@@ -1014,6 +1014,10 @@ void TSyncCommand::generateCommandsAndClose(void)
     // check for unassigned fLocalDataStoreP as this seems to happen sometimes in the cmdline client
     PPOINTERTEST(fLocalDataStoreP,("Warning: fLocalDataStoreP==NULL, cannot generate commands -> empty <sync> command"));
     if (fLocalDataStoreP) {
+      #if defined(MULTI_THREAD_SUPPORT) && defined(SYSYNC_SERVER)
+      // possibly convert items of all datastores in parallel first
+      if (IS_SERVER) fSessionP->prepareSyncCommands();
+      #endif
       fInProgress = !(
         fLocalDataStoreP->engGenerateSyncCommands
         (
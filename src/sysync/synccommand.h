@@ -710,6 +710,9 @@ public:
   // properties
   // - get status code
   TSyError getStatusCode(void) { return fStatusCode; };
+  // - get IDs of the command this status refers to
+  uInt32 getRefMsgID(void) { return fRefMsgID; };
+  uInt32 getRefCmdID(void) { return fRefCmdID; };
   // - get status Sml Element
   const SmlStatusPtr_t getStatusElement(void) { return fStatusElementP; }
 protected:
@@ -78,6 +78,8 @@ public:
   virtual bool isBasedOn(uInt16 aItemTypeID) const { return aItemTypeID==ity_syncitem; };
   // get session pointer
   TSyncSession *getSession(void) { return fSyncItemTypeP ? fSyncItemTypeP->getSession() : NULL; };
+  // get type of this item
+  TSyncItemType *getSyncItemType(void) { return fSyncItemTypeP; };
   // get session zones pointer
   GZones *getSessionZones(void);
   // assignment (IDs and contents)
@@ -97,6 +99,7 @@ public:
   // - changelog support
   #ifdef CHECKSUM_CHANGELOG
   virtual uInt16 getDataCRC(uInt16 crc=0, bool /* aEQRelevantOnly */=false) { return crc; /* always empty */ };
+  virtual uInt64 getDataHash(uInt64 hash=0, bool /* aEQRelevantOnly */=false) { return hash; /* always empty */ };
   #endif
   // access to operation
   TSyncOperation getSyncOp(void) { return fSyncOp; };
@@ -158,6 +161,14 @@ public:
     ,bool /* aDebugShow */=false
     #endif
   ) { return SYSYNC_NOT_COMPARABLE; };
+  // get key for pre-selecting content matching candidates without comparing every item:
+  // items which compareWith() an item of aOtherTypeP as equal in aEqMode must return the same key.
+  // Returns false if no key can be given (item must then be compared with every candidate)
+  virtual bool getMatchKey(
+    TSyncItemType * /* aOtherTypeP */,
+    TEqualityMode /* aEqMode */,
+    string & /* aKey */
+  ) { return false; };
   #ifdef SYDEBUG
   // show item contents for debug
   virtual void debugShowItem(uInt32 aDbgMask=DBG_DATA) { /* nop */ };
@@ -641,6 +641,10 @@ void TSessionConfig::clear(void)
   #else
     fMultiThread= true;
   #endif
+  #ifdef MULTI_THREAD_SUPPORT
+  // - items are converted one by one while generating sync commands
+  fParallelConvertItems=0;
+  #endif
   // - do not wait for status of interrupted command by default (note: before 2.1.0.2, this was always true)
   fWaitForStatusOfInterrupted=false;
   // - accept delete commands for already deleted items with 200 (rather that 404 or 211)
@@ -684,6 +688,7 @@ void TSessionConfig::clear(void)
   fDebugChunkMaxSize=0; // disabled
   #endif
   fRelyOnEarlyMaps=true; // we rely on early maps sent by clients for adds from the previous session
+  fWBXMLStringTable=false; // plain inline strings, as not every peer may handle string table references
   // clear inherited
   inherited::clear();
 } // TSessionConfig::clear
@@ -751,6 +756,13 @@ bool TSessionConfig::localStartElement(const char *aElementName, const char **aA
     expectBool(fAllowMessageRetries);
   else if (strucmp(aElementName,"multithread")==0)
     expectBool(fMultiThread);
+  else if (strucmp(aElementName,"parallelconvertitems")==0) {
+    #ifdef MULTI_THREAD_SUPPORT
+    expectUInt32(fParallelConvertItems);
+    #else
+    expectAll(); // no threads, simply ignore contents
+    #endif
+  }
   else if (strucmp(aElementName,"waitforstatusofinterrupted")==0)
     expectBool(fWaitForStatusOfInterrupted);
   else if (strucmp(aElementName,"deletinggoneok")==0)
@@ -804,6 +816,8 @@ bool TSessionConfig::localStartElement(const char *aElementName, const char **aA
   #endif
   else if (strucmp(aElementName,"relyonearlymaps")==0)
     expectBool(fRelyOnEarlyMaps);
+  else if (strucmp(aElementName,"wbxmlstringtable")==0)
+    expectBool(fWBXMLStringTable);
   // - local datastores
   else if (strucmp(aElementName,"datastore")==0) {
     // definition of a new datastore
@@ -1015,6 +1029,10 @@ TSyncSession::TSyncSession(
   // other pointers
   #ifdef SCRIPT_SUPPORT
   fSessionScriptContextP = NULL;
+  fFunctionContextPoolP = new TScriptContextPool;
+  #ifdef MULTI_THREAD_SUPPORT
+  fSessionVarMutex = newMutex();
+  #endif
   #endif
   fInterruptedCommandP = NULL;
   fIncompleteDataCommandP = NULL;
@@ -1215,6 +1233,12 @@ TSyncSession::~TSyncSession()
   }
   fSessionLogger.DebugThreadOutputDone();
   #endif
+  #ifdef SCRIPT_SUPPORT
+  delete fFunctionContextPoolP;
+  #ifdef MULTI_THREAD_SUPPORT
+  freeMutex(fSessionVarMutex);
+  #endif
+  #endif
 } // TSyncSession::~TSyncSession
 
 
@@ -1237,6 +1261,8 @@ void TSyncSession::TerminateSession(void)
       delete fSessionScriptContextP;
       fSessionScriptContextP = NULL;
     }
+    // remove idle function contexts
+    fFunctionContextPoolP->clear();
     #endif
     // remove all local datastores
     TLocalDataStorePContainer::iterator pos1;
@@ -1477,6 +1503,9 @@ void TSyncSession::InternalResetSessionEx(bool terminationCall)
         DEBUGPRINTF(("- prevented deleting because command is interrupted"));
     }
     fStatusWaitCommands.clear(); // clear list
+    fStatusWaitIndex.clear();
+    fStatusWaitIndexOf.clear();
+    fStatusWaitSeq=0;
     // - commands waiting for outgoing message to begin
     forgetHeaderWaitCommands();
     // - commands to be issued only after all commands in this message have
@@ -1588,6 +1617,9 @@ void TSyncSession::InternalResetSessionEx(bool terminationCall)
   fErrorItemDatastores=0; // none generated or detected error items
   fInProgress=false; // not yet in progress
   fOutgoingStarted=false; // no outgoing message started yet
+  fIncomingPartial=false; // no partial incoming message
+  fHeaderDeferred=false; // no outgoing header deferred
+  fDeferredHeaderNoResp=false;
   fSequenceNesting=0; // no sequence command open
   fMaxOutgoingMsgSize=0; // no limit for outgoing messages so far
   fMaxOutgoingObjSize=0; // SyncML 1.1: no limit for outgoing objects so far
@@ -1996,6 +2028,7 @@ bool TSyncSession::issuePtr(
       // check if message size restrictions or local buffer size
       // will prevent command from being sent now
       TSmlCommand *splitCmdP = NULL;
+      bool reuseEvaluation = false;
       if (!fOutgoingMessageFull) {
         #ifndef USE_SML_EVALUATION
           #error "This Implementation does not work any more without USE_SML_EVALUATION"
@@ -2036,6 +2069,9 @@ bool TSyncSession::issuePtr(
           }
         }
         #endif
+        // - if command fits as-is, it will be issued unchanged, so the encoding
+        //   made during evaluation can be committed instead of encoding it again
+        reuseEvaluation = freeaftersend>getNotUsableBufferBytes();
         // - check if we can send this
         if (freeaftersend<=getNotUsableBufferBytes()) {
           // not enough space in this message
@@ -2129,6 +2165,7 @@ bool TSyncSession::issuePtr(
         // issue the command
         if (splitCmdP) fOutgoingMessageFull=true; // if we are sending a split command, message IS full after that!
         bool dodelete=true;
+        if (reuseEvaluation) smlReuseEvaluation(getSmlWorkspaceID());
         if (aSyncCommandP->issue(getNextOutgoingCmdID(),fOutgoingMsgID,aNoResp)) {
           // command expects status and must be kept in list
           PDEBUGPRINTFX(DBG_HOT,("%s: issued as (outgoing MsgID=%ld, CmdID=%ld), now queueing for &html;<a name=\"IO_%ld_%ld\" href=\"#SO_%ld_%ld\">&html;status&html;</a>&html;",
@@ -2142,7 +2179,7 @@ bool TSyncSession::issuePtr(
           ));
           // - queue for status
           aSyncCommandP->setWaitingForStatus(true); // increment waiting for status count of this command
-          fStatusWaitCommands.push_back(aSyncCommandP);
+          queueStatusWaitCommand(aSyncCommandP);
           dodelete=false;
         }
         else {
@@ -2368,12 +2405,14 @@ void TSyncSession::ContinuePackage(
           // - queue for status (note that every SyncML 1.1 chunk wants to see a status 213 in any case!)
           if (!cmdP->isWaitingForStatus()) {
             // only put to the queue again if not already waiting there
-            fStatusWaitCommands.push_back(cmdP);
+            queueStatusWaitCommand(cmdP);
             cmdP->setWaitingForStatus(true);
           }
           else {
             // already waiting, so it's already in the queue - do not push it again
             PDEBUGPRINTFX(DBG_SESSION,("%s: continued command was already waiting for status, do not push again", cmdP->getName()));
+            // but continuing has assigned new IDs, so status will refer to these
+            reindexStatusWaitCommand(cmdP);
           }
           dodelete=false;
         }
@@ -2424,6 +2463,15 @@ void TSyncSession::ContinuePackage(
 // create, send and delete SyncHeader "command"
 void TSyncSession::issueHeader(bool aNoResp)
 {
+  if (fIncomingPartial) {
+    // the outgoing message would be written behind the incoming data in the
+    // workspace, where the rest of the incoming message must go. Commands
+    // issued meanwhile wait in fHeaderWaitCommands as usual.
+    PDEBUGPRINTFX(DBG_SESSION,("Incoming message not complete yet, outgoing header deferred"));
+    fHeaderDeferred=true;
+    fDeferredHeaderNoResp=aNoResp;
+    return;
+  }
   #ifdef SYDEBUG
   // Start output translation before issuing outgoing header
   XMLTranslationOutgoingStart();
@@ -2450,7 +2498,7 @@ void TSyncSession::issueHeader(bool aNoResp)
       // - queue for status
       PDEBUGPRINTFX(DBG_PROTO,("SyncHdr: issued in MsgID=%ld, now queueing for status",(long)syncheaderP->getMsgID()));
       syncheaderP->setWaitingForStatus(true);
-      fStatusWaitCommands.push_back(syncheaderP);
+      queueStatusWaitCommand(syncheaderP);
     }
     else {
       PDEBUGPRINTFX(DBG_PROTO,("SyncHdr: issued in MsgID=%ld, now deleting",(long)syncheaderP->getMsgID()));
@@ -2494,6 +2542,19 @@ void TSyncSession::issueHeader(bool aNoResp)
 } // TSyncSession::IssueHeader
 
 
+// set while only part of the incoming message is in the workspace
+void TSyncSession::setIncomingPartial(bool aPartial)
+{
+  fIncomingPartial=aPartial;
+  if (!fIncomingPartial && fHeaderDeferred) {
+    // message is complete now, the outgoing message can follow it
+    fHeaderDeferred=false;
+    if (!fAborted)
+      issueHeader(fDeferredHeaderNoResp);
+  }
+} // TSyncSession::setIncomingPartial
+
+
 
 
 // process a command (analyze and execute it).
@@ -2915,6 +2976,62 @@ bool TSyncSession::executeDelayedCmd(TSmlCommand *aCmdP)
 #pragma segment session2
 #endif
 
+// queue command for receiving status
+void TSyncSession::queueStatusWaitCommand(TSmlCommand *aCmdP)
+{
+  TSmlCommandPContainer::iterator pos = fStatusWaitCommands.insert(fStatusWaitCommands.end(),aCmdP);
+  TStatusWaitIndex::iterator ipos = fStatusWaitIndex.insert(TStatusWaitIndex::value_type(
+    TStatusWaitKey(TStatusWaitIDs(aCmdP->getMsgID(),aCmdP->getCmdID()),fStatusWaitSeq++),
+    pos
+  )).first;
+  fStatusWaitIndexOf.insert(TStatusWaitIndexOf::value_type(aCmdP,ipos));
+} // TSyncSession::queueStatusWaitCommand
+
+
+// find command in status wait queue the given status belongs to
+// Note: like a sequential search of the queue, this finds the first queued command with matching IDs
+TSmlCommandPContainer::iterator TSyncSession::findStatusWaitCommand(TStatusCommand *aStatusCmdP)
+{
+  TStatusWaitIDs ids(aStatusCmdP->getRefMsgID(),aStatusCmdP->getRefCmdID());
+  TStatusWaitIndex::iterator ipos = fStatusWaitIndex.lower_bound(TStatusWaitKey(ids,0));
+  if (ipos!=fStatusWaitIndex.end() && ipos->first.first==ids)
+    return ipos->second;
+  return fStatusWaitCommands.end(); // not waiting
+} // TSyncSession::findStatusWaitCommand
+
+
+// update index after IDs of a command already waiting for status have changed
+void TSyncSession::reindexStatusWaitCommand(TSmlCommand *aCmdP)
+{
+  std::pair<TStatusWaitIndexOf::iterator,TStatusWaitIndexOf::iterator> r = fStatusWaitIndexOf.equal_range(aCmdP);
+  for (TStatusWaitIndexOf::iterator rpos=r.first; rpos!=r.second; ++rpos) {
+    // re-key, but keep sequence number (position in queue does not change)
+    TStatusWaitIndex::iterator ipos = rpos->second;
+    TStatusWaitKey key(TStatusWaitIDs(aCmdP->getMsgID(),aCmdP->getCmdID()),ipos->first.second);
+    TSmlCommandPContainer::iterator pos = ipos->second;
+    fStatusWaitIndex.erase(ipos);
+    rpos->second = fStatusWaitIndex.insert(TStatusWaitIndex::value_type(key,pos)).first;
+  }
+} // TSyncSession::reindexStatusWaitCommand
+
+
+// remove command from status wait queue
+// Note: must be called before the command is deleted, as it is needed to find the index entry
+void TSyncSession::removeStatusWaitCommand(TSmlCommandPContainer::iterator aPos)
+{
+  std::pair<TStatusWaitIndexOf::iterator,TStatusWaitIndexOf::iterator> r = fStatusWaitIndexOf.equal_range(*aPos);
+  for (TStatusWaitIndexOf::iterator rpos=r.first; rpos!=r.second; ++rpos) {
+    if (rpos->second->second==aPos) {
+      // this is the index entry of this queue position
+      fStatusWaitIndex.erase(rpos->second);
+      fStatusWaitIndexOf.erase(rpos);
+      break;
+    }
+  }
+  fStatusWaitCommands.erase(aPos);
+} // TSyncSession::removeStatusWaitCommand
+
+
 // %%% integrate Results command here, too (that, is, make a common
 //     ancestor for both TStatusCommand and TResultsCommand which
 //     is then handled here in common).
@@ -2938,51 +3055,48 @@ Ret_t TSyncSession::handleStatus(TStatusCommand *aStatusCommandP)
       else {
         bool found=false;
         // status is ok, find matching command
-        TSmlCommandPContainer::iterator pos;
-        for (pos=fStatusWaitCommands.begin(); pos!=fStatusWaitCommands.end(); ++pos) {
-          if ((*pos)->matchStatus(aStatusCommandP)) {
-            PDEBUGPRINTFX(DBG_PROTO,("Found matching command '%s' for Status",(*pos)->getName()));
-            (*pos)->setWaitingForStatus(false); // has received status
-            found=true;
-            if (fIgnoreIncomingCommands) {
-              // ignore statuses, but remove waiting command from queue
-              if ((*pos)->finished()) delete (*pos); // unfinished are owned otherwise and must not be deleted
-              fStatusWaitCommands.erase(pos);
-              PDEBUGPRINTFX(DBG_SESSION,("Status ignored, command considered done -> deleted"));
+        TSmlCommandPContainer::iterator pos = findStatusWaitCommand(aStatusCommandP);
+        if (pos!=fStatusWaitCommands.end()) {
+          TSmlCommand *cmdP = *pos;
+          PDEBUGPRINTFX(DBG_PROTO,("Found matching command '%s' for Status",cmdP->getName()));
+          cmdP->setWaitingForStatus(false); // has received status
+          found=true;
+          if (fIgnoreIncomingCommands) {
+            // ignore statuses, but remove waiting command from queue
+            removeStatusWaitCommand(pos);
+            if (cmdP->finished()) delete cmdP; // unfinished are owned otherwise and must not be deleted
+            PDEBUGPRINTFX(DBG_SESSION,("Status ignored, command considered done -> deleted"));
+          }
+          else {
+            // let descendants know when we process a required status
+            if (cmdP->statusEssential()) {
+              essentialStatusReceived();
             }
-            else {
-              // let descendants know when we process a required status
-              if ((*pos)->statusEssential()) {
-                essentialStatusReceived();
-              }
-              // normally process status
-              if ((*pos)->handleStatus(aStatusCommandP)) {
-                PDEBUGPRINTFX(DBG_SESSION,("Status: processed, removed command '%s' from status wait queue",(*pos)->getName()));
-                // done with command, remove from queue
-                if ((*pos)->finished()) {
-                  // - if this is an interrupted command, make sure to remove pointer
-                  if ((*pos)==fInterruptedCommandP) fInterruptedCommandP=NULL;
-                  // - delete command itself
-                  //   NOTE; if not finished, command is owned otherwise and must
-                  //   persist
-                  PDEBUGPRINTFX(DBG_SESSION,("Status: command '%s' has handled status and allows to be deleted",(*pos)->getName()));
-                  delete (*pos);
-                }
-                else {
-                  PDEBUGPRINTFX(DBG_SESSION,("Status: command '%s' has handled status, but not finished() -> NOT deleted",(*pos)->getName()));
-                }
-                // - anyway, remove from list
-                fStatusWaitCommands.erase(pos);
+            // normally process status
+            if (cmdP->handleStatus(aStatusCommandP)) {
+              PDEBUGPRINTFX(DBG_SESSION,("Status: processed, removed command '%s' from status wait queue",cmdP->getName()));
+              // done with command, remove from queue
+              removeStatusWaitCommand(pos);
+              if (cmdP->finished()) {
+                // - if this is an interrupted command, make sure to remove pointer
+                if (cmdP==fInterruptedCommandP) fInterruptedCommandP=NULL;
+                // - delete command itself
+                //   NOTE; if not finished, command is owned otherwise and must
+                //   persist
+                PDEBUGPRINTFX(DBG_SESSION,("Status: command '%s' has handled status and allows to be deleted",cmdP->getName()));
+                delete cmdP;
               }
               else {
-                // command not yet acknowledged, keep in queue
-                (*pos)->setWaitingForStatus(true); // is again waiting for a status
-                PDEBUGPRINTFX(DBG_SESSION,("(intermediate) Status processed, command kept in queue, not deleted"));
+                PDEBUGPRINTFX(DBG_SESSION,("Status: command '%s' has handled status, but not finished() -> NOT deleted",cmdP->getName()));
               }
-            } // else normal processing
-            break; // exit for loop (iterator is not ok any more)
-          }
-        } // for
+            }
+            else {
+              // command not yet acknowledged, keep in queue
+              cmdP->setWaitingForStatus(true); // is again waiting for a status
+              PDEBUGPRINTFX(DBG_SESSION,("(intermediate) Status processed, command kept in queue, not deleted"));
+            }
+          } // else normal processing
+        }
         if (!found) {
           // no matching command found
           PDEBUGPRINTFX(DBG_ERROR,("No command found for status -> ignoring"));
@@ -3232,6 +3346,147 @@ void TSyncSession::nextMessageRequest(void)
 } // TSyncSession::nextMessageRequest
 
 
+#if defined(MULTI_THREAD_SUPPORT) && defined(SYSYNC_SERVER)
+
+// Datastores converting items ahead for one message. Groups of datastores are taken
+// one by one by the session's thread and by helper work items posted to the worker pool.
+// Datastores sending with the same item type objects are in the same group, as item types
+// are shared within the session and keep state while converting.
+class TPrepareSyncCommandsBatch {
+public:
+  TPrepareSyncCommandsBatch(TSyncSession *aSessionP, uInt32 aMaxItems, sInt32 aRefs) :
+    fSessionP(aSessionP), fMaxItems(aMaxItems), fNextGroup(0), fRunning(0), fRefs(aRefs)
+  {
+    fMutex = newMutex();
+    fDoneCond = newCond();
+  };
+  ~TPrepareSyncCommandsBatch()
+  {
+    freeCond(fDoneCond);
+    freeMutex(fMutex);
+  };
+  // convert next group, returns false if no group is left
+  bool runNext(bool aHelper)
+  {
+    lockMutex(fMutex);
+    if (fNextGroup>=fGroups.size()) {
+      unlockMutex(fMutex);
+      return false;
+    }
+    TLocalDataStorePContainer &group = fGroups[fNextGroup++];
+    fRunning++;
+    unlockMutex(fMutex);
+    TLocalDataStorePContainer::iterator pos;
+    for (pos=group.begin(); pos!=group.end(); ++pos)
+      (*pos)->engPrepareSyncCommands(fMaxItems);
+    #ifdef SYDEBUG
+    // worker thread is done logging for this session (session still waits for us here)
+    if (aHelper) fSessionP->getDbgLogger()->DebugThreadOutputDone(true);
+    #endif
+    lockMutex(fMutex);
+    if (--fRunning==0 && fNextGroup>=fGroups.size())
+      broadcastCond(fDoneCond);
+    unlockMutex(fMutex);
+    return true;
+  };
+  // wait until all groups are converted (groups not started by helpers must have been run by caller)
+  void waitDone(void)
+  {
+    lockMutex(fMutex);
+    while (fRunning>0 || fNextGroup<fGroups.size())
+      waitCond(fDoneCond,fMutex);
+    unlockMutex(fMutex);
+  };
+  // release one reference, deletes batch when last one is gone
+  // (helpers might start only after all work is done and the session has continued)
+  void release(void)
+  {
+    lockMutex(fMutex);
+    bool last = --fRefs==0;
+    unlockMutex(fMutex);
+    if (last) delete this;
+  };
+  std::vector<TLocalDataStorePContainer> fGroups;
+private:
+  TSyncSession *fSessionP;
+  uInt32 fMaxItems;
+  size_t fNextGroup;
+  sInt32 fRunning;
+  sInt32 fRefs;
+  MutexPtr_t fMutex;
+  CondPtr_t fDoneCond;
+}; // TPrepareSyncCommandsBatch
+
+
+// work function for helpers
+static void PrepareSyncCommandsWorkFunc(void *aContext)
+{
+  TPrepareSyncCommandsBatch *batchP = static_cast<TPrepareSyncCommandsBatch *>(aContext);
+  while (batchP->runNext(true)) {};
+  batchP->release();
+} // PrepareSyncCommandsWorkFunc
+
+
+// convert outgoing items of all datastores in parallel before sync commands are generated
+void TSyncSession::prepareSyncCommands(void)
+{
+  uInt32 maxItems = getSessionConfig()->fParallelConvertItems;
+  if (maxItems==0) return; // not enabled
+  TWorkerPool *poolP = getSyncAppBase()->getWorkerPool();
+  if (!poolP) return; // no worker threads
+  // group datastores that can convert items now
+  std::vector<TLocalDataStorePContainer> groups;
+  TLocalDataStorePContainer::iterator pos;
+  for (pos=fLocalDataStores.begin(); pos!=fLocalDataStores.end(); ++pos) {
+    TLocalEngineDS *dsP = *pos;
+    if (!dsP->engCanPrepareSyncCommands()) continue;
+    // join all groups using one of the same type objects, merging them if there are several
+    // (type sharing is not transitive, so datastores in different groups must not share any type)
+    TSyncItemType *types[2] = { dsP->getLocalSendType(), dsP->getRemoteReceiveType() };
+    size_t g=groups.size(); // group the datastore has joined so far
+    size_t i=0;
+    while (i<groups.size()) {
+      bool shares=false;
+      TLocalDataStorePContainer::iterator gpos;
+      for (gpos=groups[i].begin(); gpos!=groups[i].end() && !shares; ++gpos) {
+        TSyncItemType *gtypes[2] = { (*gpos)->getLocalSendType(), (*gpos)->getRemoteReceiveType() };
+        for (int t=0; t<2 && !shares; t++)
+          shares = types[t] && (types[t]==gtypes[0] || types[t]==gtypes[1]);
+      }
+      if (shares && g<groups.size()) {
+        // already in a group, merge this one into it
+        groups[g].splice(groups[g].end(),groups[i]);
+        groups.erase(groups.begin()+i);
+        continue; // same index is next group now
+      }
+      if (shares) g=i;
+      i++;
+    }
+    if (g>=groups.size()) {
+      g=groups.size();
+      groups.push_back(TLocalDataStorePContainer());
+    }
+    groups[g].push_back(dsP);
+  }
+  // nothing to gain from a single group, it will be converted while generating
+  if (groups.size()<2) return;
+  PDEBUGBLOCKFMTCOLL(("PrepareSyncCommands","Converting outgoing items in parallel","groups=%ld|maxitems=%ld",(long)groups.size(),(long)maxItems));
+  // post helpers, this thread converts groups as well (so we make progress even if all workers are busy)
+  sInt32 helpers = groups.size()-1;
+  if (helpers>poolP->numThreads()) helpers=poolP->numThreads();
+  TPrepareSyncCommandsBatch *batchP = new TPrepareSyncCommandsBatch(this,maxItems,helpers+1);
+  batchP->fGroups.swap(groups);
+  for (sInt32 i=0; i<helpers; i++)
+    poolP->post(PrepareSyncCommandsWorkFunc,batchP);
+  while (batchP->runNext(false)) {};
+  batchP->waitDone();
+  batchP->release();
+  PDEBUGENDBLOCK("PrepareSyncCommands");
+} // TSyncSession::prepareSyncCommands
+
+#endif // MULTI_THREAD_SUPPORT && SYSYNC_SERVER
+
+
 
 
 // check if session must continue (for session-level reasons, that
@@ -3369,6 +3624,8 @@ void TSyncSession::setEncoding(SmlEncoding_t aEncoding)
   Ret_t err=smlSetEncoding(fSmlWorkspaceID,aEncoding);
   if (err==SML_ERR_OK) {
     fEncoding = aEncoding;
+    // outgoing WBXML messages may use the string table for repeated strings
+    smlSetWBXMLStringTable(fSmlWorkspaceID,aEncoding==SML_WBXML && getSessionConfig()->fWBXMLStringTable);
   }
 } // TSyncSession::setEncoding
 
@@ -5548,6 +5805,9 @@ Ret_t TSyncSession::EndMessage(Boolean_t final)
   // Now dump XML translation of incoming message
   XMLTranslationIncomingEnd();
   #endif
+  // end of message was decoded, so it is complete even if the app passed
+  // the last part with STEPCMD_GOTPARTIALDATA
+  setIncomingPartial(false);
   // Flush pending item change commands?
   //
   // Don't retry other commands here (like a pending Sync), because
@@ -214,6 +214,7 @@ public:
   uInt32 fDebugChunkMaxSize;
   #endif
   bool fRelyOnEarlyMaps; // if set, we rely on early maps sent by clients for adds from the previous session
+  bool fWBXMLStringTable; // if set, repeated strings in outgoing WBXML messages are sent via the string table
   // defaults for remote-rule configurable behaviour
   bool fUpdateClientDuringSlowsync; // do not update client records (due to merge) in slowsync (However, updates can still occur in first-time sync and if server wins conflict)
   bool fUpdateServerDuringSlowsync; // do not update server records during NON-FIRST-TIME slowsync (but do it for first sync!)
@@ -238,6 +239,11 @@ public:
   sInt8 fEnumDefaultPropParams;
   // decides whether multi-threading for the datastores will be used
   bool fMultiThread;
+  #ifdef MULTI_THREAD_SUPPORT
+  // if >0, server converts up to this many outgoing items per datastore on the worker pool, for all datastores in parallel,
+  // before generating sync commands (0 = convert items one by one while generating)
+  uInt32 fParallelConvertItems;
+  #endif
   // defines if the engine waits with continuing interrupted commands until previous part received status
   bool fWaitForStatusOfInterrupted;
   // accept delete commands for already deleted items with 200 (rather that 404 or 211)
@@ -357,6 +363,10 @@ public:
   virtual sInt32 RemainingRequestTime(void) { return 0x7FFFFFFF; }; // quasi infinite
   // forget commands waiting to be sent when header is generated
   void forgetHeaderWaitCommands(void);
+  #if defined(MULTI_THREAD_SUPPORT) && defined(SYSYNC_SERVER)
+  // convert outgoing items of all datastores in parallel before sync commands are generated (see fParallelConvertItems)
+  void prepareSyncCommands(void);
+  #endif
   // SyncML toolkit workspace access
   void setSmlWorkspaceID(InstanceID_t aSmlWorkspaceID);
   InstanceID_t getSmlWorkspaceID(void) { return fSmlWorkspaceID; };
@@ -487,6 +497,10 @@ public:
   void incOutgoingMessageSize(sInt32 aIncrement) { fOutgoingMsgSize+=aIncrement; };
   // - get message-global noResp status
   bool getMsgNoResp(void) { return fMsgNoResp; }
+  // - incoming message only partially in the workspace (STEPCMD_GOTPARTIALDATA),
+  //   clearing it issues the outgoing header if it was deferred meanwhile
+  void setIncomingPartial(bool aPartial);
+  bool isIncomingPartial(void) { return fIncomingPartial; }
   // - get next outgoing command ID
   sInt32 getNextOutgoingCmdID(void) { return (++fOutgoingCmdID); }
   // - get next outgoing command ID without actually consuming it
@@ -689,6 +703,12 @@ public:
   #ifdef SCRIPT_SUPPORT
   // access to session script context
   TScriptContext *getSessionScriptContext(void) { return fSessionScriptContextP; };
+  // access to idle user-defined function contexts
+  TScriptContextPool *getFunctionContextPool(void) { return fFunctionContextPoolP; };
+  #ifdef MULTI_THREAD_SUPPORT
+  // serializes access to session script variables from scripts running in worker threads
+  MutexPtr_t getSessionVarMutex(void) { return fSessionVarMutex; };
+  #endif
   #endif // SCRIPT_SUPPORT
   // unprotected options
   // - set if we should send property lists in CTCap
@@ -893,6 +913,12 @@ protected:
   #ifdef SCRIPT_SUPPORT
   // Session level script context
   TScriptContext *fSessionScriptContextP;
+  // Idle user-defined function contexts for re-use
+  TScriptContextPool *fFunctionContextPoolP;
+  #ifdef MULTI_THREAD_SUPPORT
+  // protects session script variables (SESSIONVAR/SETSESSIONVAR from parallel conversion, see fParallelConvertItems)
+  MutexPtr_t fSessionVarMutex;
+  #endif
   #endif // SCRIPT_SUPPORT
   // Session options
   bool fReadOnly;
@@ -926,6 +952,9 @@ protected:
   bool fInProgress; // if set, session is in progress and must persist beyond this request
   // incoming Message status
   bool fMsgNoResp; // if set, current message MUST not be responded to. Suppresses all status sendig attempts
+  bool fIncomingPartial; // if set, the rest of the incoming message is still to be appended to the workspace
+  bool fHeaderDeferred; // outgoing header requested while fIncomingPartial, to be issued when message is complete
+  bool fDeferredHeaderNoResp; // noResp for the deferred header
   bool fIgnoreIncomingCommands; // if set, commands dispatched will be ignored
   TSyError fStatusCodeForIgnored; // if fIgnoreIncomingCommands is set, this status code will be used to reply all incoming commands
   // - incoming data from a <moredata> split data item
@@ -937,6 +966,15 @@ protected:
   // termination flag - set when TerminateSession() has finished executing
   bool fTerminated; // session is terminated (finally, not restartable!)
 private:
+  // status wait queue
+  // - queue command for receiving status
+  void queueStatusWaitCommand(TSmlCommand *aCmdP);
+  // - find command in status wait queue the given status belongs to
+  TSmlCommandPContainer::iterator findStatusWaitCommand(TStatusCommand *aStatusCmdP);
+  // - update index after IDs of a command already waiting for status have changed
+  void reindexStatusWaitCommand(TSmlCommand *aCmdP);
+  // - remove command from status wait queue (must be called before command is deleted)
+  void removeStatusWaitCommand(TSmlCommandPContainer::iterator aPos);
   // debug logging
   #ifdef SYDEBUG
   TDebugLogger fSessionLogger; // the logger
@@ -954,6 +992,16 @@ private:
   // context-free command queues
   // - sent commands waiting for status
   TSmlCommandPContainer fStatusWaitCommands;
+  // - index of fStatusWaitCommands by (outgoing MsgID, CmdID) and queueing sequence number,
+  //   so for duplicate IDs the first entry is the command queued first
+  typedef std::pair<uInt32,uInt32> TStatusWaitIDs;
+  typedef std::pair<TStatusWaitIDs,uInt32> TStatusWaitKey;
+  typedef std::map<TStatusWaitKey,TSmlCommandPContainer::iterator> TStatusWaitIndex;
+  TStatusWaitIndex fStatusWaitIndex;
+  // - index entries by command, to re-key or remove them without searching
+  typedef std::multimap<TSmlCommand *,TStatusWaitIndex::iterator> TStatusWaitIndexOf;
+  TStatusWaitIndexOf fStatusWaitIndexOf;
+  uInt32 fStatusWaitSeq; // sequence number for next command queued
   // - received commands that could not be executed immediately
   TSmlCommandPContainer fDelayedExecutionCommands;
   sInt32 fDelayedExecSyncEnds;
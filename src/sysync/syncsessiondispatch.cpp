@@ -120,6 +120,11 @@ TSyncSessionDispatch::TSyncSessionDispatch() :
   // this is a server engine
   fIsServer = true;
   // other init
+  fLiveSessions=0;
+  #ifdef MULTI_THREAD_SUPPORT
+  for (uInt16 i=0; i<SESSION_SHARDS; i++)
+    fShards[i].fMutex=newMutex();
+  #endif
   #ifdef SYSYNC_TOOL
   fToolSessionHP=NULL; // no tool session yet
   #endif
@@ -132,16 +137,24 @@ void TSyncSessionDispatch::TerminateAllSessions(uInt16 aStatusCode)
 {
   try {
     TSyncSessionHandlePContainer::iterator pos;
-    for (pos=fSessions.begin(); pos!=fSessions.end(); ++pos) {
-      if ((pos->second)->fSessionP) {
-        (pos->second)->fSessionP->AbortSession(aStatusCode,true);
-        (pos->second)->fSessionP->ResetSession(); // reset properly before deleting
-        // delete the session handle including the session
-        MP_DELETE(DBG_OBJINST,"leftover session",(pos->second));
+    for (uInt16 i=0; i<SESSION_SHARDS; i++) {
+      TSyncSessionShard &shard = fShards[i];
+      for (pos=shard.fSessions.begin(); pos!=shard.fSessions.end(); ++pos) {
+        if ((pos->second)->fSessionP) {
+          (pos->second)->fSessionP->AbortSession(aStatusCode,true);
+          (pos->second)->fSessionP->ResetSession(); // reset properly before deleting
+          // delete the session handle including the session
+          MP_DELETE(DBG_OBJINST,"leftover session",(pos->second));
+        }
       }
+      // delete the session list of this shard
+      shard.fSessions.clear();
+      shard.fExpiry.clear();
     }
-    // delete the session list
-    fSessions.clear();
+    // delete the indexes
+    fSessionsByDevice.clear();
+    fSessionsByPtr.clear();
+    fLiveSessions=0;
   }
   catch (...)
   {
@@ -168,6 +181,10 @@ TSyncSessionDispatch::~TSyncSessionDispatch()
     fToolSessionHP=NULL;
   }
   #endif
+  #ifdef MULTI_THREAD_SUPPORT
+  for (uInt16 i=0; i<SESSION_SHARDS; i++)
+    freeMutex(fShards[i].fMutex);
+  #endif
 } // TSyncSessionDispatch::~TSyncSessionDispatch
 
 
@@ -186,14 +203,11 @@ Ret_t TSyncSessionDispatch::StartMessage(
 
   try {
     // obtain session (existing or new)
-    // - lock access to list
-    //   NOTE: Basic policy is to keep sessions locked only while executing code
-    //         that cannot throw a SE or a C++ exception, as unlocking too much
-    //         (in a general exception catcher) makes much troubles. All Code
-    //         that might throw should be executed ONLY with session list released!
-    LockSessions();
-    // - now get iterator
-    TSyncSessionHandlePContainer::iterator pos=fSessions.end();
+    // NOTE: Basic policy is to keep sessions locked only while executing code
+    //       that cannot throw a SE or a C++ exception, as unlocking too much
+    //       (in a general exception catcher) makes much troubles. All Code
+    //       that might throw should be executed ONLY with session list released!
+    bool found=false;
     // - get SessionID, either from transport (aUserData) or from TargetURI
     string sessionID;
     AssignString(sessionID,(const char *)aUserData);
@@ -215,99 +229,25 @@ Ret_t TSyncSessionDispatch::StartMessage(
     }
     // - process session ID
     if (!sessionID.empty()) {
-      // we seem to have a session ID
-      pos=fSessions.find(sessionID);
-      #ifdef SYDEBUG
-      if (pos!=fSessions.end()) {
-        PDEBUGPRINTFX(DBG_HOT,(
-          "Session found by SessionID=%s",
-          sessionID.c_str()
-        ));
+      // we seem to have a session ID, look it up
+      if (!FindAndEnterSession(sessionID,sessionHP))
+        return SML_ERR_UNSPECIFIC;
+      if (sessionHP) {
+        found=true;
+        sessionP = sessionHP->fSessionP;
       }
-      #endif
     }
     // now enter existing session or create new one
-    if (pos!=fSessions.end()) {
-      // found existing session:
-      // - get handle
-      sessionHP = (*pos).second;
-      // - get session object pointer
-      sessionP = sessionHP->fSessionP;
-      PDEBUGPRINTFX(DBG_SESSION,("Entering found session..."));
-      // Note: We have the session list locked, so we should not wait here for entering to avoid locking the entire server
-      // - try entering
-      int k=0;
-      while (true) {
-        if (sessionHP->EnterSession(0))
-          break; // successfully entered
-        // could not enter. Temporarily release sessions list and wait 10 seconds
-        ReleaseSessions();
-        if (k>60) {
-          // 60*10 = 600 sec = 10 min waited, give up
-          PDEBUGPRINTFX(DBG_ERROR,("Found session is locked for >%d seconds, giving up -> SML_ERR_UNSPECIFIC",k*10));
-          return SML_ERR_UNSPECIFIC;
-        }
-        PDEBUGPRINTFX(DBG_LOCK,("Session could not be entered after waiting %d seconds, keep trying",k*10));
-        // wait
-        sleepLineartime(10*secondToLinearTimeFactor);
-        // we need to re-find the session here, as we had given others control over the session list
-        LockSessions();
-        pos=fSessions.find(sessionID);
-        if (pos==fSessions.end()) {
-          ReleaseSessions();
-          PDEBUGPRINTFX(DBG_HOT,(
-            "SessionID=%s has disappeared from sessions list while we were waiting to enter it --> SML_ERR_UNSPECIFIC",
-            sessionID.c_str()
-          ));
-          return SML_ERR_UNSPECIFIC;
-        }
-        // - get handle again
-        sessionHP = (*pos).second;
-        k++;
-      }
-      // Session is entered, so we can release the list (no other thread will be able to enter same session)
-      ReleaseSessions();
+    if (found) {
       // Show that we entered the session
       PDEBUGPRINTFX(DBG_SESSION,("Session entered"));
     } // if session already exists
     else {
       // we need a new session
-      // Note: session list is still locked here
-      PDEBUGPRINTFX(DBG_TRANSP+DBG_EXOTIC,("No session found, will need new one"));
-      // - count sessions not belonging to this client
-      sInt32 othersessioncount = 0;
-      for (pos=fSessions.begin();pos!=fSessions.end();pos++) {
-        // - get handle
-        sessionHP = (*pos).second;
-        // - get session
-        sessionP=sessionHP->fSessionP;
-        // check if session is for same device as current request
-        if (strcmp(smlSrcTargLocURIToCharP(aContentP->source),sessionP->getRemoteURI())!=0) {
-          // other device, count if not outdated
-          if (!sessionHP->fOutdated) othersessioncount++;
-        }
-        else {
-          // this device, set outdated flag to prevent inactive sessions from being
-          // counted and limiting sessions
-          sessionHP->fOutdated=true;
-        }
-      } // for
-      PDEBUGPRINTFX(DBG_SESSION+DBG_EXOTIC,(
-        "Found %ld sessions not related to device '%s'",
-        (sInt32)othersessioncount,
-        smlSrcTargLocURIToCharP(aContentP->source)
-      ));
-      // - get sessions that need to be deleted
-      TSyncSessionHandlePList delList;
-      collectTimedOutSessions(delList);
-      // - now we can release the sessions list
-      ReleaseSessions();
-      // - actually delete them while session list is again unlocked
-      deleteListedSessions(delList);
-      // Now create new session
-      sessionHP = CreateAndEnterServerSession(NULL); // have sessionID generated
+      sInt32 othersessioncount;
+      sessionHP = AdmitServerSession(smlSrcTargLocURIToCharP(aContentP->source),othersessioncount);
       // - get session object pointer
-      sessionP = sessionHP->fSessionP;
+      sessionP = sessionHP ? sessionHP->fSessionP : NULL;
       #ifdef CONCURRENT_DEVICES_LIMIT
       // - now check session count (makes session busy if licensed session count is exceeded)
       //   Note: othersessioncount does not include our own session
@@ -345,47 +285,145 @@ Ret_t TSyncSessionDispatch::StartMessage(
 
 
 
+/// @brief Find a session by its ID and enter it
+/// @param aSessionID ID of the session
+/// @param aSessionHP receives the handle of the entered session, NULL if there is no session with this ID
+/// @return false if the session exists, but could not be entered
+/// @note only the shard the session ID belongs to is locked, and only while no session is waited for
+bool TSyncSessionDispatch::FindAndEnterSession(const string &aSessionID, TSyncSessionHandle *&aSessionHP)
+{
+  uInt16 shardidx = shardOf(aSessionID);
+  TSyncSessionHandlePContainer &sessions = fShards[shardidx].fSessions;
+
+  aSessionHP=NULL;
+  LockShard(shardidx);
+  TSyncSessionHandlePContainer::iterator pos=sessions.find(aSessionID);
+  if (pos!=sessions.end()) {
+    // found existing session:
+    PDEBUGPRINTFX(DBG_HOT,(
+      "Session found by SessionID=%s",
+      aSessionID.c_str()
+    ));
+    // - get handle
+    aSessionHP = (*pos).second;
+    PDEBUGPRINTFX(DBG_SESSION,("Entering found session..."));
+    // Note: We have the shard locked, so we should not wait here for entering to avoid locking other sessions
+    // - try entering
+    int k=0;
+    while (true) {
+      if (aSessionHP->EnterSession(0))
+        break; // successfully entered
+      // could not enter. Temporarily release shard and wait 10 seconds
+      ReleaseShard(shardidx);
+      aSessionHP=NULL;
+      if (k>60) {
+        // 60*10 = 600 sec = 10 min waited, give up
+        PDEBUGPRINTFX(DBG_ERROR,("Found session is locked for >%d seconds, giving up -> SML_ERR_UNSPECIFIC",k*10));
+        return false;
+      }
+      PDEBUGPRINTFX(DBG_LOCK,("Session could not be entered after waiting %d seconds, keep trying",k*10));
+      // wait
+      sleepLineartime(10*secondToLinearTimeFactor);
+      // we need to re-find the session here, as we had given others control over the session list
+      LockShard(shardidx);
+      pos=sessions.find(aSessionID);
+      if (pos==sessions.end()) {
+        ReleaseShard(shardidx);
+        PDEBUGPRINTFX(DBG_HOT,(
+          "SessionID=%s has disappeared from sessions list while we were waiting to enter it --> SML_ERR_UNSPECIFIC",
+          aSessionID.c_str()
+        ));
+        return false;
+      }
+      // - get handle again
+      aSessionHP = (*pos).second;
+      k++;
+    }
+  }
+  // Session is entered (or none was found), so we can release the shard (no other thread will be able to enter same session)
+  ReleaseShard(shardidx);
+  return true;
+} // TSyncSessionDispatch::FindAndEnterSession
+
+
+/// @brief Admit a new session for a device
+/// @param aRemoteURI remote URI of the requesting device
+/// @param aOtherSessionCount receives the number of live sessions of other devices
+/// @return handle of the new session (entered), NULL if none could be created
+/// @note outdates the device's older sessions and deletes timed-out sessions before
+///       creating the new one. May not be called when session list is already locked
+TSyncSessionHandle *TSyncSessionDispatch::AdmitServerSession(cAppCharP aRemoteURI, sInt32 &aOtherSessionCount)
+{
+  // - lock access to indexes
+  LockSessions();
+  PDEBUGPRINTFX(DBG_TRANSP+DBG_EXOTIC,("No session found, will need new one"));
+  // - outdate sessions of this device and count sessions not belonging to this client
+  aOtherSessionCount = OutdateDeviceSessions(aRemoteURI);
+  PDEBUGPRINTFX(DBG_SESSION+DBG_EXOTIC,(
+    "Found %ld sessions not related to device '%s'",
+    (sInt32)aOtherSessionCount,
+    aRemoteURI
+  ));
+  // - get sessions that need to be deleted
+  TSyncSessionHandlePList delList;
+  collectTimedOutSessions(delList);
+  // - now we can release the sessions list
+  ReleaseSessions();
+  // - actually delete them while session list is again unlocked
+  deleteListedSessions(delList);
+  // Now create new session
+  return CreateAndEnterServerSession(NULL,aRemoteURI); // have sessionID generated
+} // TSyncSessionDispatch::AdmitServerSession
+
+
 /// @brief Collect timed-out sessions and remove them from the session list
 /// @param aDeletableSessions to-be deleted sessions will be appended to this list
 /// @note session list must be locked before call!
+/// @note only sessions due for a timeout check are looked at. Sessions that were used
+///       since they were queued are re-queued for the time they will time out then.
 void TSyncSessionDispatch::collectTimedOutSessions(TSyncSessionHandlePList &aDeletableSessions)
 {
-  TSyncAgent *sessionP=NULL; // the session (new or existing found in fSessions)
   TSyncSessionHandle *sessionHP=NULL;
-  TAgentConfig *serverconfigP=NULL;
+  lineartime_t now = getSystemNowAs(TCTX_UTC);
+  lineartime_t expiry;
 
-  // get agent config
-  GET_CASTED_PTR(serverconfigP,TAgentConfig,fConfigP->fAgentConfigP,"missing agent (server) config");
-  // - find timed-out sessions and count sessions not belonging to this client
-  TSyncSessionHandlePContainer::iterator pos;
-  for (pos=fSessions.begin();pos!=fSessions.end();pos++) {
-    // - get handle
-    sessionHP = (*pos).second;
-    // - get session
-    sessionP=sessionHP->fSessionP;
-    // - check
-    if (getSystemNowAs(TCTX_UTC) > sessionP->getSessionLastUsed()+serverconfigP->getSessionTimeout()) {
-      // this session is too old, queue it for killing
-      aDeletableSessions.push_back(sessionHP);
+  TSyncSessionHandlePList expired;
+
+  // - check the due part of each shard's expiry queue
+  for (uInt16 i=0; i<SESSION_SHARDS; i++) {
+    TSyncSessionShard &shard = fShards[i];
+    LockShard(i);
+    TSyncSessionExpiryQueue::iterator pos = shard.fExpiry.begin();
+    while (pos!=shard.fExpiry.end() && pos->first<now) {
+      // - get handle
+      sessionHP = pos->second;
+      ++pos; // entry might get removed or re-queued now
+      expiry = sessionExpiry(sessionHP);
+      if (now > expiry) {
+        // this session is too old, remove it from the shard
+        // to make sure no other process can possibly access it, and queue it for killing
+        UnlinkFromShard(sessionHP);
+        expired.push_back(sessionHP);
+      }
+      else {
+        // session was used since it was queued, re-queue for its new expiry
+        shard.fExpiry.erase(sessionHP->fExpiryPos);
+        sessionHP->fExpiryPos = shard.fExpiry.insert(TSyncSessionExpiryQueue::value_type(expiry,sessionHP));
+      }
     }
-  } // for
-  // now remove the outdated sessions from the main session list
-  // to make sure no other process can possibly access them
+    ReleaseShard(i);
+  }
+  // now remove the outdated sessions from the indexes as well
   // - session list is locked once here
-  TSyncSessionHandlePList::iterator delpos;
   DEBUGPRINTFX(DBG_SESSION,(
     "Now removing %ld outdated sessions from the session list",
-    (sInt32)aDeletableSessions.size()
+    (sInt32)expired.size()
   ));
-  for (delpos=aDeletableSessions.begin();delpos!=aDeletableSessions.end();delpos++) {
-    // - get handle
-    sessionHP = (*delpos);
-    // - remove session handle from the list
-    //   NOTE: session list is already locked here, RemoveSession
-    //         MUST be called with locked session list!
-    if (!(sessionHP == RemoveSession(sessionHP->fSessionP)))
-      throw (TSyncException("invalid linked session/sessionhandle pair"));
+  TSyncSessionHandlePList::iterator delpos;
+  for (delpos=expired.begin();delpos!=expired.end();delpos++) {
+    UnlinkFromIndexes(*delpos);
   }
+  aDeletableSessions.splice(aDeletableSessions.end(),expired);
 } // collectTimedOutSessions
 
 
@@ -433,13 +471,13 @@ void TSyncSessionDispatch::deleteListedSessions(TSyncSessionHandlePList &aDelSes
           // re-insert into queue
           LockSessions();
           // however, if we now see that there is NO other session running, we'll risk crashing here and delete the session
-          if (fSessions.size()==0) {
+          if (numSessions()==0) {
             // we'll do no harm to other sessions because there are none - try to hard-kill the session
             PDEBUGPRINTFX(DBG_ERROR,("No non-ZOMBIE sessions running -> risking to delete this ZOMBIE",deletedsessionid.c_str()));
             delete sessionHP;
           }
           else {
-            fSessions[deletedsessionid]=sessionHP;
+            AddSession(deletedsessionid,sessionHP);
             PDEBUGPRINTFX(DBG_HOT,(
               "ZOMBIE session ID='%s' is now again in session list, waiting once more for timeout and hopefully clean deletion later",
               deletedsessionid.c_str()
@@ -461,7 +499,8 @@ void TSyncSessionDispatch::deleteListedSessions(TSyncSessionHandlePList &aDelSes
 
 /// Create new session, clean up timed-out sessions
 /// @param aPredefinedSessionID : predefined sessionID, if NULL, internal ID will be generated
-TSyncSessionHandle *TSyncSessionDispatch::CreateAndEnterServerSession(cAppCharP aPredefinedSessionID)
+/// @param aRemoteURI : remote URI of the requesting device, used to index the session by device
+TSyncSessionHandle *TSyncSessionDispatch::CreateAndEnterServerSession(cAppCharP aPredefinedSessionID, cAppCharP aRemoteURI)
 {
   TSyncAgent *sessionP=NULL; // the session (new or existing found in fSessions)
   TSyncSessionHandle *sessionHP=NULL;
@@ -537,6 +576,7 @@ TSyncSessionHandle *TSyncSessionDispatch::CreateAndEnterServerSession(cAppCharP
       // - create session object with given ID
       sessionP = static_cast<TAgentConfig *>(fConfigP->fAgentConfigP)->CreateServerSession(sessionHP,SessionIDString.c_str());
       sessionHP->fSessionP=sessionP;
+      AssignString(sessionHP->fRemoteURI,aRemoteURI);
       // debug
       PDEBUGPRINTFX(DBG_HOT,(
         "Session created: local session ID='%s', not yet in session list",
@@ -546,11 +586,11 @@ TSyncSessionHandle *TSyncSessionDispatch::CreateAndEnterServerSession(cAppCharP
       CONSOLEPRINTF(("\nStarted new SyncML session (server id=%s)",SessionIDString.c_str()));
       // - add it to session map
       LockSessions();
-      fSessions[SessionIDString]=sessionHP;
+      AddSession(SessionIDString,sessionHP);
       DEBUGPRINTFX(DBG_HOT,(
         "Session ID='%s' now in session list, total # of sessions now: %ld",
         sessionP->getLocalSessionID(),
-        (sInt32)fSessions.size()
+        (sInt32)numSessions()
       ));
       ReleaseSessions();
     }
@@ -659,28 +699,32 @@ void TSyncSessionDispatch::dbgListSessions(void)
     LockSessions();
     try {
       // View list of active sessions
+      // Note: sessions are only added to or removed from shards with the session list locked,
+      //       so we don't need to lock the shards for listing
       TSyncSessionHandlePContainer::iterator pos;
       PDEBUGPRINTFX(DBG_SESSION,("-------------------------------------------"));
-      PDEBUGPRINTFX(DBG_SESSION,("Active Sessions (%d):",fSessions.size()));
-      for (pos=fSessions.begin(); pos!=fSessions.end(); pos++) {
-        sP =(*pos).second->fSessionP;
-        if (sP) {
-          // handle has a session
-          StringObjTimestamp(ts,sP->getSessionLastUsed());
-          PDEBUGPRINTFX(DBG_SESSION,(
-            "- %s :Remote URI=%s, Local URI=%s, LastUsed=%s",
-            (*pos).first.c_str(),
-            sP->getRemoteURI(),
-            sP->getLocalURI(),
-            ts.c_str()
-          ));
-        }
-        else {
-          // Strange error: handle without session
-          PDEBUGPRINTFX(DBG_SESSION,(
-           "- %s : <error: session object already deleted>",
-           (*pos).first.c_str()
-         ));
+      PDEBUGPRINTFX(DBG_SESSION,("Active Sessions (%ld):",(sInt32)numSessions()));
+      for (uInt16 i=0; i<SESSION_SHARDS; i++) {
+        for (pos=fShards[i].fSessions.begin(); pos!=fShards[i].fSessions.end(); pos++) {
+          sP =(*pos).second->fSessionP;
+          if (sP) {
+            // handle has a session
+            StringObjTimestamp(ts,sP->getSessionLastUsed());
+            PDEBUGPRINTFX(DBG_SESSION,(
+              "- %s :Remote URI=%s, Local URI=%s, LastUsed=%s",
+              (*pos).first.c_str(),
+              sP->getRemoteURI(),
+              sP->getLocalURI(),
+              ts.c_str()
+            ));
+          }
+          else {
+            // Strange error: handle without session
+            PDEBUGPRINTFX(DBG_SESSION,(
+             "- %s : <error: session object already deleted>",
+             (*pos).first.c_str()
+           ));
+          }
         }
       }
       PDEBUGPRINTFX(DBG_SESSION,("-------------------------------------------"));
@@ -870,17 +914,16 @@ TSyncSessionHandle *TSyncSessionDispatch::RemoveSession(TSyncSession *aSessionP)
   // remove session from Dispatcher
   // - locate session
   DEBUGPRINTFX(DBG_SESSION,("TSyncSessionDispatch::RemoveSession called..."));
-  TSyncSessionHandlePContainer::iterator pos;
-  for (pos=fSessions.begin(); pos!=fSessions.end(); ++pos) {
-    TSyncSessionHandle *sessionHP = pos->second;
-    if (sessionHP && (sessionHP->fSessionP == aSessionP)) {
-      // - erase in list
-      fSessions.erase(pos);
-      DEBUGPRINTFX(DBG_SESSION,("...TSyncSessionDispatch::RemoveSession succeeded"));
-      // - return handle
-      foundhandleP=sessionHP;
-      break; // done
-    }
+  TSyncSessionPtrIndex::iterator ppos = fSessionsByPtr.find(aSessionP);
+  if (ppos!=fSessionsByPtr.end()) {
+    foundhandleP = ppos->second;
+    // - erase in its shard
+    LockShard(foundhandleP->fShard);
+    UnlinkFromShard(foundhandleP);
+    ReleaseShard(foundhandleP->fShard);
+    // - erase in indexes
+    UnlinkFromIndexes(foundhandleP);
+    DEBUGPRINTFX(DBG_SESSION,("...TSyncSessionDispatch::RemoveSession succeeded"));
   }
   // - unlock access to list
   return foundhandleP;
@@ -888,4 +931,126 @@ TSyncSessionHandle *TSyncSessionDispatch::RemoveSession(TSyncSession *aSessionP)
 
 
 
+// add session handle to session list and indexes
+// NOTES:
+// - must be called with session list locked!!!
+// - session handle must have its fSessionP set already
+void TSyncSessionDispatch::AddSession(const string &aSessionID, TSyncSessionHandle *aSessionHP)
+{
+  uInt16 shardidx = shardOf(aSessionID);
+  TSyncSessionShard &shard = fShards[shardidx];
+  // - make sure an entry with the same ID is not left in the indexes
+  TSyncSessionHandlePContainer::iterator pos = shard.fSessions.find(aSessionID);
+  if (pos!=shard.fSessions.end()) RemoveSession(pos->second->fSessionP);
+  // - add to shard
+  aSessionHP->fShard = shardidx;
+  LockShard(shardidx);
+  aSessionHP->fListPos = shard.fSessions.insert(TSyncSessionHandlePContainer::value_type(aSessionID,aSessionHP)).first;
+  aSessionHP->fExpiryPos = shard.fExpiry.insert(TSyncSessionExpiryQueue::value_type(sessionExpiry(aSessionHP),aSessionHP));
+  ReleaseShard(shardidx);
+  // - add to indexes
+  fSessionsByPtr[aSessionHP->fSessionP]=aSessionHP;
+  fSessionsByDevice.insert(TSyncSessionDeviceIndex::value_type(aSessionHP->fRemoteURI,aSessionHP));
+  if (!aSessionHP->fOutdated) fLiveSessions++;
+} // TSyncSessionDispatch::AddSession
+
+
+// mark all sessions of the given device outdated to prevent inactive sessions
+// from being counted and limiting sessions.
+// Returns the number of not outdated sessions belonging to other devices.
+// NOTE: must be called with session list locked!!!
+sInt32 TSyncSessionDispatch::OutdateDeviceSessions(cAppCharP aRemoteURI)
+{
+  string remoteURI;
+  AssignString(remoteURI,aRemoteURI);
+  pair<TSyncSessionDeviceIndex::iterator,TSyncSessionDeviceIndex::iterator> range =
+    fSessionsByDevice.equal_range(remoteURI);
+  for (TSyncSessionDeviceIndex::iterator pos=range.first; pos!=range.second; ++pos) {
+    if (!pos->second->fOutdated) {
+      pos->second->fOutdated=true;
+      fLiveSessions--;
+    }
+  }
+  // all remaining live sessions belong to other devices now
+  return fLiveSessions;
+} // TSyncSessionDispatch::OutdateDeviceSessions
+
+
+
+// remove session handle from its shard
+// NOTE: must be called with the session's shard locked!!!
+void TSyncSessionDispatch::UnlinkFromShard(TSyncSessionHandle *aSessionHP)
+{
+  TSyncSessionShard &shard = fShards[aSessionHP->fShard];
+  shard.fExpiry.erase(aSessionHP->fExpiryPos);
+  shard.fSessions.erase(aSessionHP->fListPos);
+} // TSyncSessionDispatch::UnlinkFromShard
+
+
+// remove session handle from device and pointer indexes
+// NOTE: must be called with session list locked!!!
+void TSyncSessionDispatch::UnlinkFromIndexes(TSyncSessionHandle *aSessionHP)
+{
+  fSessionsByPtr.erase(aSessionHP->fSessionP);
+  // - erase in device index (only walks the sessions of the same device)
+  pair<TSyncSessionDeviceIndex::iterator,TSyncSessionDeviceIndex::iterator> range =
+    fSessionsByDevice.equal_range(aSessionHP->fRemoteURI);
+  for (TSyncSessionDeviceIndex::iterator pos=range.first; pos!=range.second; ++pos) {
+    if (pos->second==aSessionHP) {
+      fSessionsByDevice.erase(pos);
+      break;
+    }
+  }
+  // - update live count
+  if (!aSessionHP->fOutdated) fLiveSessions--;
+} // TSyncSessionDispatch::UnlinkFromIndexes
+
+
+// number of sessions in all shards
+sInt32 TSyncSessionDispatch::numSessions(void)
+{
+  sInt32 n=0;
+  for (uInt16 i=0; i<SESSION_SHARDS; i++)
+    n+=fShards[i].fSessions.size();
+  return n;
+} // TSyncSessionDispatch::numSessions
+
+
+// shard a session ID belongs to (FNV-1a hash of the ID)
+uInt16 TSyncSessionDispatch::shardOf(const string &aSessionID)
+{
+  uInt32 h = 2166136261UL;
+  for (string::size_type i=0; i<aSessionID.size(); i++) {
+    h ^= (uInt8)aSessionID[i];
+    h *= 16777619UL;
+  }
+  return h % SESSION_SHARDS;
+} // TSyncSessionDispatch::shardOf
+
+
+// time the session is due for the next timeout check
+lineartime_t TSyncSessionDispatch::sessionExpiry(TSyncSessionHandle *aSessionHP)
+{
+  TAgentConfig *serverconfigP = static_cast<TAgentConfig *>(fConfigP->fAgentConfigP);
+  return aSessionHP->fSessionP->getSessionLastUsed()+serverconfigP->getSessionTimeout();
+} // TSyncSessionDispatch::sessionExpiry
+
+
+void TSyncSessionDispatch::LockShard(uInt16 aShard)
+{
+  #ifdef MULTI_THREAD_SUPPORT
+  lockMutex(fShards[aShard].fMutex);
+  #endif
+} // TSyncSessionDispatch::LockShard
+
+
+void TSyncSessionDispatch::ReleaseShard(uInt16 aShard)
+{
+  #ifdef MULTI_THREAD_SUPPORT
+  unlockMutex(fShards[aShard].fMutex);
+  #endif
+} // TSyncSessionDispatch::ReleaseShard
+
+
+
 // eof
@@ -15,7 +15,14 @@
 #include "sysync.h"
 #include "syncappbase.h"
 #include "syncagent.h"
+#ifdef MULTI_THREAD_SUPPORT
+  #include "platform_mutex.h"
+#endif
 
+// number of independently locked parts of the session table
+#ifndef SESSION_SHARDS
+  #define SESSION_SHARDS 16
+#endif
 
 
 namespace sysync {
@@ -24,6 +31,20 @@ namespace sysync {
 class TSyncSession;
 class TSyncAgent;
 class TSyncSessionDispatch;
+class TSyncSessionHandle;
+
+
+// Container types
+// - main session list
+typedef std::map<std::string,TSyncSessionHandle*> TSyncSessionHandlePContainer; // contains sync sessions by sessionID-String
+// - deletable sessions list
+typedef std::list<TSyncSessionHandle*> TSyncSessionHandlePList;
+// - sessions by remote (device) URI
+typedef std::multimap<std::string,TSyncSessionHandle*> TSyncSessionDeviceIndex;
+// - session handles by session pointer
+typedef std::map<TSyncSession*,TSyncSessionHandle*> TSyncSessionPtrIndex;
+// - sessions by time they are due for a timeout check
+typedef std::multimap<lineartime_t,TSyncSessionHandle*> TSyncSessionExpiryQueue;
 
 
 // Session handle, includes dispatcher-specific stuff for handling sessions
@@ -36,6 +57,12 @@ public:
   TSyncAppBase * fAppBaseP;
   // - used for counting session for session limiting
   bool fOutdated;
+  // - remote URI of the device this session was admitted for (key into device index)
+  string fRemoteURI;
+  // - shard of the session table this session lives in, and its entries there
+  uInt16 fShard;
+  TSyncSessionHandlePContainer::iterator fListPos;
+  TSyncSessionExpiryQueue::iterator fExpiryPos;
   // - enter session (re-entrance avoidance)
   virtual bool EnterSession(sInt32 aMaxWaitTime) = 0;
   // - leave session
@@ -54,11 +81,19 @@ public:
 }; // TSyncSessionHandle
 
 
-// Container types
-// - main session list
-typedef std::map<std::string,TSyncSessionHandle*> TSyncSessionHandlePContainer; // contains sync sessions by sessionID-String
-// - deletable sessions list
-typedef std::list<TSyncSessionHandle*> TSyncSessionHandlePList;
+// One part of the session table. Sessions are distributed over the shards
+// by a hash of their session ID, so requests for existing sessions only
+// need to lock the shard their session is in.
+typedef struct {
+  // sessions in this shard by sessionID-String
+  TSyncSessionHandlePContainer fSessions;
+  // sessions in this shard ordered by the time they are due for a timeout check
+  TSyncSessionExpiryQueue fExpiry;
+  #ifdef MULTI_THREAD_SUPPORT
+  // lock for this shard
+  MutexPtr_t fMutex;
+  #endif
+} TSyncSessionShard;
 
 
 /* TSyncSessionDispatch manages a list of active sync sessions
@@ -95,12 +130,16 @@ public:
   // - get buffered answer from the session's buffer if there is any
   void getBufferedAnswer(InstanceID_t aSmlWorkspaceID, MemPtr_t &aAnswer, MemSize_t &aAnswerSize);
   // Session handling
+  // - find session by ID and enter it (returns false if it exists but cannot be entered)
+  bool FindAndEnterSession(const string &aSessionID, TSyncSessionHandle *&aSessionHP);
+  // - outdate older sessions of the device, delete timed-out sessions and create and enter a new session
+  TSyncSessionHandle *AdmitServerSession(cAppCharP aRemoteURI, sInt32 &aOtherSessionCount);
   // - Collect timed-out sessions and remove them from the session list
   void collectTimedOutSessions(TSyncSessionHandlePList &aDeletableSessions);
   // - Try to enter and delete the sessions passed in one by one
   void deleteListedSessions(TSyncSessionHandlePList &aDelSessionList);
   // - create new session
-  TSyncSessionHandle *CreateAndEnterServerSession(cAppCharP aPredefinedSessionID=NULL);
+  TSyncSessionHandle *CreateAndEnterServerSession(cAppCharP aPredefinedSessionID=NULL, cAppCharP aRemoteURI=NULL);
   // - create new session handle (of correct TSessionHandle derivate for dispatcher used)
   virtual TSyncSessionHandle *CreateSessionHandle(void) = 0;
   // - extract sessionID from query string (docname or TargetURI)
@@ -111,19 +150,33 @@ public:
   // list currently active sessions to debug channel
   void dbgListSessions(void);
   // - number of sessions
-  sInt32 numSessions(void) { return fSessions.size(); };
+  sInt32 numSessions(void);
   #ifdef SYSYNC_TOOL
   // get or create a session for use with the diagnostic tool
   TSyncAgent *getSySyToolSession(void);
   #endif
 protected:
   // must be implemented in derived class to make access to
-  // fSessions thread-safe
+  // the device and pointer indexes and creation/removal of sessions thread-safe
+  // Note: when needed together, LockSessions() must be called before LockShard()
   virtual void LockSessions(void) { /* dummy in base class */ };
   virtual void ReleaseSessions(void) {  /* dummy in base class */ };
+  // lock a single shard of the session table (for finding sessions by ID)
+  void LockShard(uInt16 aShard);
+  void ReleaseShard(uInt16 aShard);
+  // shard a session ID belongs to
+  static uInt16 shardOf(const string &aSessionID);
+  // time a session is due for the next timeout check
+  lineartime_t sessionExpiry(TSyncSessionHandle *aSessionHP);
   // remove session from internal session list and return it's handle object
   // Note: session list must be locked while calling RemoveSession
   TSyncSessionHandle *RemoveSession(TSyncSession *aSessionP) throw();
+  // add session handle to session list and indexes
+  // Note: session list must be locked while calling AddSession
+  void AddSession(const string &aSessionID, TSyncSessionHandle *aSessionHP);
+  // mark all sessions of given device outdated, returns number of non-outdated sessions of other devices
+  // Note: session list must be locked while calling OutdateDeviceSessions
+  sInt32 OutdateDeviceSessions(cAppCharP aRemoteURI);
   // remove and kill session
   // Note: may not be called when session list is already locked
   void KillServerSession(TSyncAgent *aSessionP, uInt16 aStatusCode, const char *aMsg=NULL, uInt32 aErrorCode=0); // by pointer
@@ -136,8 +189,17 @@ protected:
   virtual void ReleaseToolkit(void) {  /* dummy in base class */ };
   #endif
 private:
-  // session map
-  TSyncSessionHandlePContainer fSessions;
+  // remove session handle from its shard (shard must be locked)
+  void UnlinkFromShard(TSyncSessionHandle *aSessionHP);
+  // remove session handle from the device and pointer indexes (session list must be locked)
+  void UnlinkFromIndexes(TSyncSessionHandle *aSessionHP);
+  // session map, split into shards
+  TSyncSessionShard fShards[SESSION_SHARDS];
+  // secondary indexes over all shards (kept in sync by AddSession/RemoveSession)
+  TSyncSessionDeviceIndex fSessionsByDevice;
+  TSyncSessionPtrIndex fSessionsByPtr;
+  // number of listed sessions not flagged fOutdated
+  sInt32 fLiveSessions;
   #ifdef SYSYNC_TOOL
   TSyncSessionHandle *fToolSessionHP;
   #endif
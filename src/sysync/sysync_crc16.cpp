@@ -1,6 +1,6 @@
 /*
  *  sysync_crc16.cpp
- *    CRC 16 checksumming functions
+ *    CRC 16 and 64 bit hash checksumming functions
  *
  *  Copyright (c) 2002-2011 by Synthesis AG + plan44.ch
  *
@@ -141,6 +141,42 @@ uInt16 sysync_crc16_block(const void* dataP, uInt32 len, uInt16 crc)
   return crc;
 } // sysync_crc16_block
 
+
+// add block of bytes to 64 bit hash
+// - MurmurHash64A mixing, seeded with the hash so far, so hashes of subsequent
+//   blocks can be chained. Block boundaries are part of the hash (length is mixed in),
+//   and unlike with the CRC, empty blocks change the hash as well.
+uInt64 sysync_hash64_block(const void* dataP, uInt32 len, uInt64 hash)
+{
+  const uInt64 m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  const uInt8 *p = (const uInt8 *)dataP;
+  const uInt8 *endP = p + (len & ~7);
+  uInt64 h = hash ^ (len * m);
+  uInt64 k;
+  // whole 8-byte words
+  while (p!=endP) {
+    memcpy(&k,p,sizeof(k)); // no alignment requirements
+    p += sizeof(k);
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  // remaining bytes
+  uInt32 rest = len & 7;
+  if (rest) {
+    while (rest--) h ^= uInt64(p[rest]) << (8*rest);
+    h *= m;
+  }
+  // finalize
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+} // sysync_hash64_block
+
 } // namespace sysync
 
 /* eof */
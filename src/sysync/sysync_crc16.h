@@ -1,6 +1,6 @@
 /*
  *  sysync_crc16.h
- *    CRC 16 checksumming functions
+ *    CRC 16 and 64 bit hash checksumming functions
  *
  *  Copyright (c) 2002-2011 by Synthesis AG + plan44.ch
  *
@@ -18,6 +18,9 @@ uInt16 sysync_crc16(uInt16 crc,uInt8 b);
 // add next block of bytes to CRC
 uInt16 sysync_crc16_block(const void* dataP, uInt32 len, uInt16 crc);
 
+// add next block of bytes to 64 bit hash (processes 8 bytes per step)
+uInt64 sysync_hash64_block(const void* dataP, uInt32 len, uInt64 hash);
+
 } // namespace sysync
 
 /* eof */
@@ -301,6 +301,7 @@ typedef enum {
 // built-in function definition
 class TItemField;
 class TScriptContext;
+class TScriptContextPool;
 
 typedef void (*TBuiltinFunc)(TItemField *&aTermP, TScriptContext *aFuncContextP);
 
@@ -0,0 +1,202 @@
+/*
+ *  File:         workerpool.cpp
+ *
+ *  TWorkerPool
+ *    Fixed pool of worker threads executing posted work items,
+ *    with one queue per worker and work stealing between them.
+ *
+ *  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+ *
+ */
+
+#include "prefix_file.h"
+#include "sysync.h"
+
+#ifdef MULTI_THREAD_SUPPORT
+
+#include "workerpool.h"
+
+
+namespace sysync {
+
+
+// TWorkerPool
+// ===========
+
+// constructor, starts the worker threads
+TWorkerPool::TWorkerPool(uInt16 aNumThreads) :
+  fNumThreads(aNumThreads>0 ? aNumThreads : 1),
+  fNextWorker(0),
+  fQueued(0),
+  fPending(0),
+  fTerminating(false)
+{
+  fStateMutex = newMutex();
+  fWorkCond = newCond();
+  fIdleCond = newCond();
+  fWorkers = new TWorker[fNumThreads];
+  for (uInt16 i=0; i<fNumThreads; i++) {
+    fWorkers[i].fPoolP = this;
+    fWorkers[i].fIndex = i;
+    fWorkers[i].fMutex = newMutex();
+    fWorkers[i].fThreadP = new TThreadObject;
+  }
+  // start threads only when all workers are set up, as they steal from each other
+  for (uInt16 i=0; i<fNumThreads; i++) {
+    fWorkers[i].fThreadP->launch(WorkerThreadFunc,(uIntArch)&fWorkers[i]);
+  }
+} // TWorkerPool::TWorkerPool
+
+
+// destructor, completes all posted work and stops the worker threads
+TWorkerPool::~TWorkerPool()
+{
+  // request termination (workers only exit when no queued work is left)
+  lockMutex(fStateMutex);
+  fTerminating=true;
+  broadcastCond(fWorkCond);
+  unlockMutex(fStateMutex);
+  // wait for all threads before freeing anything, as workers access each other's queues
+  for (uInt16 i=0; i<fNumThreads; i++) {
+    fWorkers[i].fThreadP->waitfor(-1);
+  }
+  for (uInt16 i=0; i<fNumThreads; i++) {
+    delete fWorkers[i].fThreadP;
+    freeMutex(fWorkers[i].fMutex);
+  }
+  delete[] fWorkers;
+  freeCond(fIdleCond);
+  freeCond(fWorkCond);
+  freeMutex(fStateMutex);
+} // TWorkerPool::~TWorkerPool
+
+
+// post work to the pool
+void TWorkerPool::post(TWorkFunc aWorkFunc, void *aContext, TWorkDoneFunc aDoneFunc, void *aDoneContext, uIntArch aAffinity)
+{
+  TWorkItem item;
+  item.fWorkFunc = aWorkFunc;
+  item.fContext = aContext;
+  item.fDoneFunc = aDoneFunc;
+  item.fDoneContext = aDoneContext;
+  // select worker
+  uInt32 w;
+  lockMutex(fStateMutex);
+  if (aAffinity)
+    w = (uInt32)((aAffinity >> 4) % fNumThreads); // low bits of pointers are usually constant
+  else
+    w = fNextWorker++ % fNumThreads;
+  fPending++;
+  unlockMutex(fStateMutex);
+  // queue it
+  TWorker &worker = fWorkers[w];
+  lockMutex(worker.fMutex);
+  worker.fQueue.push_back(item);
+  unlockMutex(worker.fMutex);
+  // wake a worker
+  // Note: the item might already be taken by now, so fQueued can be negative for a moment
+  lockMutex(fStateMutex);
+  fQueued++;
+  signalCond(fWorkCond);
+  unlockMutex(fStateMutex);
+} // TWorkerPool::post
+
+
+// wait until all work posted so far has completed
+void TWorkerPool::waitIdle(void)
+{
+  lockMutex(fStateMutex);
+  while (fPending>0)
+    waitCond(fIdleCond,fStateMutex);
+  unlockMutex(fStateMutex);
+} // TWorkerPool::waitIdle
+
+
+// true if called from one of the pool's worker threads
+bool TWorkerPool::isWorkerThread(void)
+{
+  uIntArch me = myThreadID();
+  for (uInt16 i=0; i<fNumThreads; i++) {
+    if (fWorkers[i].fThreadP->getid()==me) return true;
+  }
+  return false;
+} // TWorkerPool::isWorkerThread
+
+
+// get next work item for a worker
+bool TWorkerPool::getWork(TWorker &aWorker, TWorkItem &aItem)
+{
+  // - own queue first, oldest first
+  lockMutex(aWorker.fMutex);
+  if (!aWorker.fQueue.empty()) {
+    aItem = aWorker.fQueue.front();
+    aWorker.fQueue.pop_front();
+    unlockMutex(aWorker.fMutex);
+    return true;
+  }
+  unlockMutex(aWorker.fMutex);
+  // - steal newest item from other workers, starting with the next one
+  for (uInt16 i=1; i<fNumThreads; i++) {
+    TWorker &victim = fWorkers[(aWorker.fIndex+i) % fNumThreads];
+    lockMutex(victim.fMutex);
+    if (!victim.fQueue.empty()) {
+      aItem = victim.fQueue.back();
+      victim.fQueue.pop_back();
+      unlockMutex(victim.fMutex);
+      return true;
+    }
+    unlockMutex(victim.fMutex);
+  }
+  return false;
+} // TWorkerPool::getWork
+
+
+// worker main loop
+uInt32 TWorkerPool::workerLoop(TWorker &aWorker)
+{
+  TWorkItem item;
+  while (true) {
+    if (getWork(aWorker,item)) {
+      lockMutex(fStateMutex);
+      fQueued--;
+      unlockMutex(fStateMutex);
+      // execute
+      try {
+        item.fWorkFunc(item.fContext);
+        if (item.fDoneFunc) item.fDoneFunc(item.fDoneContext);
+      }
+      catch (...) {
+        PNCDEBUGPRINTFX(DBG_ERROR,("TWorkerPool: exception in work item on worker %hd", aWorker.fIndex));
+      }
+      // completed
+      lockMutex(fStateMutex);
+      if (--fPending<=0) broadcastCond(fIdleCond);
+      unlockMutex(fStateMutex);
+    }
+    else {
+      // nothing to do, sleep until work is posted
+      lockMutex(fStateMutex);
+      while (fQueued<=0 && !fTerminating)
+        waitCond(fWorkCond,fStateMutex);
+      bool done = fTerminating && fQueued<=0;
+      unlockMutex(fStateMutex);
+      if (done) break;
+    }
+  }
+  return 0;
+} // TWorkerPool::workerLoop
+
+
+// thread function
+uInt32 TWorkerPool::WorkerThreadFunc(TThreadObject *aThreadObject, uIntArch aParam)
+{
+  TWorker *workerP = (TWorker *)aParam;
+  return workerP->fPoolP->workerLoop(*workerP);
+} // TWorkerPool::WorkerThreadFunc
+
+
+} // namespace sysync
+
+#endif // MULTI_THREAD_SUPPORT
+
+// eof
@@ -0,0 +1,103 @@
+/*
+ *  File:         workerpool.h
+ *
+ *  TWorkerPool
+ *    Fixed pool of worker threads executing posted work items,
+ *    with one queue per worker and work stealing between them.
+ *
+ *  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+ *
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#ifdef MULTI_THREAD_SUPPORT
+
+#include "generic_types.h"
+#include "platform_mutex.h"
+#include "platform_thread.h"
+#include "sysync_noncopyable.h"
+
+#include <deque>
+
+namespace sysync {
+
+
+/// @brief work function, executed on one of the worker threads
+typedef void (*TWorkFunc)(void *aContext);
+/// @brief completion callback, executed on the same worker thread after the work function has returned
+typedef void (*TWorkDoneFunc)(void *aContext);
+
+
+/// @brief Fixed size pool of worker threads
+/// @note Each worker has its own queue. Work posted with the same affinity goes to the
+///       same worker's queue (keeps e.g. a session's work on one thread as long as that
+///       thread is not overloaded). Idle workers steal from the other end of other
+///       workers' queues.
+/// @note Work items must not throw; exceptions escaping a work function are caught and
+///       only logged.
+class TWorkerPool : noncopyable {
+public:
+  /// @param aNumThreads number of worker threads to start
+  TWorkerPool(uInt16 aNumThreads);
+  /// @note waits for all posted work to complete before stopping the threads
+  virtual ~TWorkerPool();
+  /// @brief post work to the pool
+  /// @param aWorkFunc function to execute
+  /// @param aContext passed to aWorkFunc
+  /// @param aDoneFunc if not NULL, called after aWorkFunc has completed
+  /// @param aDoneContext passed to aDoneFunc
+  /// @param aAffinity selects the preferred worker (any value, e.g. a session pointer), 0 = round robin
+  void post(TWorkFunc aWorkFunc, void *aContext, TWorkDoneFunc aDoneFunc=NULL, void *aDoneContext=NULL, uIntArch aAffinity=0);
+  /// @brief wait until all work posted so far has completed
+  /// @note must not be called from a work function
+  void waitIdle(void);
+  /// @brief number of worker threads
+  uInt16 numThreads(void) { return fNumThreads; };
+  /// @brief true if called from one of this pool's worker threads
+  bool isWorkerThread(void);
+private:
+  // a posted work item
+  typedef struct {
+    TWorkFunc fWorkFunc;
+    void *fContext;
+    TWorkDoneFunc fDoneFunc;
+    void *fDoneContext;
+  } TWorkItem;
+  typedef std::deque<TWorkItem> TWorkQueue;
+  // a worker
+  typedef struct {
+    TWorkerPool *fPoolP;
+    uInt16 fIndex;
+    TThreadObject *fThreadP;
+    TWorkQueue fQueue; // owner takes from front, thieves from back
+    MutexPtr_t fMutex; // protects fQueue
+  } TWorker;
+  // thread function
+  static uInt32 WorkerThreadFunc(TThreadObject *aThreadObject, uIntArch aParam);
+  // run work for a worker until pool terminates
+  uInt32 workerLoop(TWorker &aWorker);
+  // get next work item for a worker, from its own queue or stolen from another one
+  bool getWork(TWorker &aWorker, TWorkItem &aItem);
+  // the workers
+  uInt16 fNumThreads;
+  TWorker *fWorkers;
+  uInt32 fNextWorker; // for round robin
+  // pool state, protected by fStateMutex
+  MutexPtr_t fStateMutex;
+  CondPtr_t fWorkCond; // signalled when work is posted or the pool terminates
+  CondPtr_t fIdleCond; // signalled when fPending drops to zero
+  sInt32 fQueued; // posted but not yet taken by a worker
+  sInt32 fPending; // posted but not yet completed
+  bool fTerminating;
+}; // TWorkerPool
+
+
+} // namespace sysync
+
+#endif // MULTI_THREAD_SUPPORT
+
+#endif // WORKERPOOL_H
+
+// eof
@@ -229,6 +229,7 @@ TSyError Module_Capabilities( CContext mContext, appCharP *mCapabilities )
   Manufacturer( s, "Synthesis AG" );                 // **** can be adapted ***
   Description ( s, "Text database module. Writes data directly to TDB_*.txt file" );
   YesField    ( s,  CA_ADMIN_Info );
+  YesField    ( s,  CA_ResumeSupported ); // InsertMapItem & co are implemented
   MinVersion  ( s,  VP_GlobMulti  ); // at least V1.5.1
 
   if              (mc->fCC) {
@@ -244,6 +244,13 @@ enum TStepCmdEnum {
   /** run next step (after receiving STEPCMD_SENDDATA and sending SyncML
       data from buffer using GetSyncMLBuffer/ReturnSyncMLBuffer) */
   STEPCMD_SENTDATA = 12,
+  /** run next step (after receiving STEPCMD_NEEDDATA and putting only a part of
+      the received SyncML message into the buffer). The engine processes the
+      commands that have arrived completely and returns STEPCMD_NEEDDATA again
+      for the next part, which is appended to the buffer. The last part of the
+      message should be passed with STEPCMD_GOTDATA, so that a truncated
+      message is reported as an error instead of waiting for more data */
+  STEPCMD_GOTPARTIALDATA = 13,
 
   /** suspend the session. Note that this command can be issued out-of order
       instead of the next pending command (STEPCMD_GOTDATA, STEPCMD_SENTDATA, STEPCMD_STEP)
@@ -31,301 +31,203 @@ void b64::free(void *mem)
 
 
 
-char *b64::encode (const uInt8 *instr, uInt32 len, uInt32 *outlenP, sInt16 maxLineLen, bool crLineEnd) {
-
-
-  // no line breaks -- this is just a straight b64 transform
-
-  uInt32 i_off = 0;
-  uInt32 o_off = 0;
-  uInt8 inbuf [3];
-  uInt32 inlen,outlen,inover;
-  uInt32 triples;
-  uInt32 i;
-  sInt16 linechars;
-  char *outstr = NULL;
-
-  if ( (instr == NULL) || (len == 0) ) {
-    return(NULL);
-  }
+// decoding table: 0..63 for B64 chars, B64_PAD for '=', B64_SKIP for all others
+#define B64_SKIP -1
+#define B64_PAD -2
+
+static const sInt8 dectable [256] = {
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,62,-1,-1,-1,63,
+  52,53,54,55,56,57,58,59,60,61,-1,-1,-1,-2,-1,-1,
+  -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,
+  15,16,17,18,19,20,21,22,23,24,25,-1,-1,-1,-1,-1,
+  -1,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
+  41,42,43,44,45,46,47,48,49,50,51,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+  -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
+};
 
-  inlen = len;
-  inover = inlen%3;
-  triples = ((inlen-inover)/3);
 
-  outlen = 4*triples+1;
-  if (inover) {
-    outlen+=4;
-  }
+// size of the buffer needed by encodeTo() (including a NUL terminator)
+static uInt32 encodedSize(uInt32 len, sInt16 maxLineLen, bool crLineEnd)
+{
+  uInt32 outlen = 4*((len+2)/3)+1;
   if (maxLineLen) {
-    // make whole number of quads fit on one line
-    maxLineLen &= ~3; // clear bit 0&1
-    // also add room for CRs or CRLFs
+    // add room for CRs or CRLFs
     outlen +=
       (outlen/maxLineLen+1) << (crLineEnd ? 0 : 1);
   }
+  return outlen;
+} // encodedSize
 
-  outstr = (char *)malloc(outlen*sizeof(char));
-  memset(outstr,0,outlen);
 
-  linechars=0;
-  o_off=0;
-  for (i = 0; i < triples; i++) {
-
-    i_off = i*3;
-    // o_off = i*4; %%% not ok as there might be line ends in between
-
-    inbuf[0] = instr[i_off];
-    inbuf[1] = instr[i_off+1];
-    inbuf[2] = instr[i_off+2];
-
-    outstr[o_off++] = table[(inbuf [0] & 0xFC) >> 2];
-    outstr[o_off++] = table[((inbuf [0] & 0x03) << 4) | ((inbuf [1] & 0xF0) >> 4)];
-    outstr[o_off++] = table[((inbuf [1] & 0x0F) << 2) | ((inbuf [2] & 0xC0) >> 6)];
-    outstr[o_off++] = table[inbuf [2] & 0x3F];
+// encode into buffer of encodedSize(), returns number of chars (without terminator)
+// - maxLineLen must be a multiple of 4 already
+static uInt32 encodeTo(char *outstr, const uInt8 *instr, uInt32 len, sInt16 maxLineLen, bool crLineEnd)
+{
+  uInt32 triples = len/3;
+  uInt32 inover = len%3;
+  uInt32 i,v;
+  sInt16 linechars=0;
+  char *o=outstr;
 
+  for (i = 0; i < triples; i++) {
+    v = ((uInt32)instr[0] << 16) | ((uInt32)instr[1] << 8) | instr[2];
+    instr+=3;
+    o[0] = table[v >> 18];
+    o[1] = table[(v >> 12) & 0x3F];
+    o[2] = table[(v >> 6) & 0x3F];
+    o[3] = table[v & 0x3F];
+    o+=4;
     // check line wrapping
-    linechars+=4;
-    if (
-      maxLineLen && linechars>=maxLineLen && // line limit enabled
-      (i<triples-1 || inover) // and more to come (either full quad or inover padded quad)
-    ) {
-      if (crLineEnd)
-        outstr[o_off++]='\r';
-      else {
-        outstr[o_off++]=0x0D;
-        outstr[o_off++]=0x0A;
+    if (maxLineLen) {
+      linechars+=4;
+      if (
+        linechars>=maxLineLen && // line limit reached
+        (i<triples-1 || inover) // and more to come (either full quad or inover padded quad)
+      ) {
+        if (crLineEnd)
+          *o++='\r';
+        else {
+          *o++=0x0D;
+          *o++=0x0A;
+        }
+        linechars=0;
       }
-      linechars=0;
     }
   }
 
   if (inover) {
-    i_off = i*3;
-    // o_off = i*4; %%% not ok as there might be line ends in between
-
-    memset(inbuf,0,3);
-    inbuf[0] = instr[i_off];
-    if (inover > 1 ) {
-      inbuf[1] = instr[i_off+1];
-    }
-    inbuf[2] = 0;
-
-    outstr[o_off] = table[(inbuf [0] & 0xFC) >> 2];
-    outstr[o_off+1] = table[((inbuf [0] & 0x03) << 4) | ((inbuf [1] & 0xF0) >> 4)];
-    outstr[o_off+2] = table[((inbuf [1] & 0x0F) << 2) | ((inbuf [2] & 0xC0) >> 6)];
-    outstr[o_off+3] = table[inbuf [2] & 0x3F];
-
     //   generate b64 strings that are padded with = to
     //   make multiple's of 4 (this is how it must be)
+    v = (uInt32)instr[0] << 16;
+    if (inover > 1) v |= (uInt32)instr[1] << 8;
+    o[0] = table[v >> 18];
+    o[1] = table[(v >> 12) & 0x3F];
+    o[2] = inover > 1 ? table[(v >> 6) & 0x3F] : '=';
+    o[3] = '=';
+    o+=4;
+  }
+  return o-outstr;
+} // encodeTo
 
-    if (inover < 3 ) {
-      outstr[o_off+3] = '=';
-      if (inover < 2 ) {
-        outstr[o_off+2] = '=';
+
+// decode into buffer of at least 3*(len/4+1) bytes, returns number of bytes
+static uInt32 decodeTo(uInt8 *outstr, const char *instr, uInt32 len)
+{
+  const uInt8 *p = (const uInt8 *)instr;
+  const uInt8 *eot = p+len;
+  uInt8 inbuf [4];
+  sInt16 quadi=0; // index within quad
+  sInt8 a,b,c,d;
+  uInt8 *q=outstr;
+
+  while (p<eot) {
+    if (quadi==0 && eot-p>=4) {
+      // fast path: a complete quad without line ends, padding or garbage
+      a = dectable[p[0]];
+      b = dectable[p[1]];
+      c = dectable[p[2]];
+      d = dectable[p[3]];
+      if ((a|b|c|d)>=0) {
+        *q++ = (a << 2) | (b >> 4);
+        *q++ = (b << 4) | (c >> 2);
+        *q++ = (c << 6) | d;
+        p+=4;
+        continue;
       }
     }
+    a = dectable[*p++];
+    if (a==B64_PAD) break; // reaching a "=" is like end of data
+    if (a==B64_SKIP) continue; // ignore all others
+    inbuf[quadi++] = a;
+    if (quadi==4) {
+      // full quad, produce three bytes
+      *q++ = (inbuf [0] << 2) | (inbuf [1] >> 4);
+      *q++ = (inbuf [1] << 4) | (inbuf [2] >> 2);
+      *q++ = (inbuf [2] << 6) | inbuf [3];
+      quadi=0;
+    }
   }
+  // produce data from incomplete last quad
+  if (quadi>=2) {
+    // two input bytes, first byte is there for sure
+    *q++ = (inbuf [0] << 2) | (inbuf [1] >> 4);
+    if (quadi>=3) {
+      // three input bytes, two output bytes are there
+      *q++ = (inbuf [1] << 4) | (inbuf [2] >> 2);
+    }
+  }
+  return q-outstr;
+} // decodeTo
 
-  // output length is either size of all complete quadruples including line feeds (o_off) or 4 more if
-  // input was not evenly divisible by 3
-  // (%%% luz added case for inover<>0, which produced 4 NULLs at end of string on inover==0)
-  if (outlenP) *outlenP = o_off+ (inover==0 ? 0 : 4);
 
+char *b64::encode (const uInt8 *instr, uInt32 len, uInt32 *outlenP, sInt16 maxLineLen, bool crLineEnd)
+{
+  if ( (instr == NULL) || (len == 0) ) {
+    return(NULL);
+  }
+  // make whole number of quads fit on one line
+  maxLineLen &= ~3; // clear bit 0&1
+  char *outstr = (char *)malloc(encodedSize(len,maxLineLen,crLineEnd)*sizeof(char));
+  if (!outstr) return NULL;
+  uInt32 outlen = encodeTo(outstr,instr,len,maxLineLen,crLineEnd);
+  // make sure output ends with NUL, callers use it as a c string
+  outstr[outlen]=0;
+  if (outlenP) *outlenP = outlen;
   return(outstr);
-}
+} // b64::encode
 
 
 uInt8 *b64::decode(const char *instr, uInt32 len, uInt32 *outlenP)
 {
-
-  uInt8 inbuf [4];
-  uInt32 n;
-  sInt16 quadi;
-  bool done;
-  const char *p;
-  char c=0;
-  uInt8 *outstr,*q;
-
   // get length if not passed as argument
   if (!instr)
     len=0;
   else
     if (len==0) len=strlen(instr);
-  p = instr;
 
   // this should always be more than enough len:
   // 3 times number of quads touched plus one for NUL terminator
-  outstr = (uInt8 *)malloc(((3*(len/4+1))+1) * sizeof(uInt8));
+  uInt8 *outstr = (uInt8 *)malloc(((3*(len/4+1))+1) * sizeof(uInt8));
   if (!outstr) return NULL;
-  q=outstr;
-
-  // process input string now
-  n=0;
-  quadi=0; // index within quad
-  done=false; // not done yet
-
-  while (!done) {
-    if (n<len) {
-      // init new quad if needed
-      if (quadi==0) {
-        // new quad starting, clear buffer
-        memset(inbuf,0,4);
-      }
-      // get next char
-      c=*p++;
-      n++;
-      // process char
-      if ((c >= 'A') && (c <= 'Z'))
-        c = c - 'A';
-      else if ((c >= 'a') && (c <= 'z'))
-        c = c - 'a' + 26;
-      else if ((c >= '0') && (c <= '9'))
-        c = c - '0' + 52;
-      else if (c == '+')
-        c = 62;
-      else if (c == '/')
-        c = 63;
-      else if (c == '=') {
-        // reaching a "=" is like end of data
-        done=true;
-      }
-      else
-        continue; // ignore all others
-    }
-    else
-      done=true;
-    // save in char
-    if (!done) inbuf[quadi++] = c;
-    // check if done or full quadruple
-    if (done || quadi==4) {
-      // produce data now
-      if (quadi>=2) {
-        // two input bytes, first byte is there for sure
-        *q++ = (inbuf [0] << 2) | ((inbuf [1] & 0x30) >> 4);
-        if (quadi>=3) {
-          // three input bytes, two output bytes are there
-          *q++ = ((inbuf [1] & 0x0F) << 4) | ((inbuf [2] & 0x3C) >> 2);
-          if (quadi==4) {
-            // all 4 bytes there, produce three bytes
-            *q++ = ((inbuf [2] & 0x03) << 6) | (inbuf [3] & 0x3F);
-          }
-        }
-      }
-      // start new quad
-      quadi=0;
-    }
-  } // while
-
+  uInt32 outlen = decodeTo(outstr,instr,len);
   // return length if requested
-  if (outlenP) *outlenP = q-outstr;
+  if (outlenP) *outlenP = outlen;
   // make sure output ends with NUL in case it is interpreted as a c string
-  *q=0;
-  // return string
+  outstr[outlen]=0;
   return(outstr);
+} // b64::decode
 
 
-  /*
-  unsigned int i_off, o_off;
-  uInt8 inbuf [4];
-  unsigned int inlen,outlen,inover;
-  unsigned int quads;
-  int i,cnt;
-  uInt8 *outstr = NULL;
-  char ch;
-
-  if (len==0) len=strlen(instr);
-
-  if ( (instr == NULL) || (len==0) ) {
-    return(NULL);
-  }
-
-  inlen = len;
-  inover = inlen%4;
-  quads = ((inlen-inover)/4);
-
-  // this should always be more than enough len
-  outlen = (3*(quads+1))+1;
-
-  outstr = (uInt8 *)malloc(outlen * sizeof(char));
-  memset(outstr,0,outlen);
-  for (i = 0; i < quads; i++) {
-
-    i_off = i*4;
-    o_off = i*3;
-
-    for (cnt = 0; cnt < 4; cnt++) {
-      ch = instr[i_off+cnt];
-
-      if ((ch >= 'A') && (ch <= 'Z'))
-        ch = ch - 'A';
-
-      else if ((ch >= 'a') && (ch <= 'z'))
-        ch = ch - 'a' + 26;
-
-      else if ((ch >= '0') && (ch <= '9'))
-        ch = ch - '0' + 52;
-
-      else if (ch == '+')
-        ch = 62;
-
-      else if (ch == '=') //no op -- can't ignore this one*
-        ch = 0;
-
-      else if (ch == '/')
-        ch = 63;
-
-      inbuf[cnt] = ch;
-
-    }
-
-    outstr[o_off] = (inbuf [0] << 2) | ((inbuf [1] & 0x30) >> 4);
-    outstr[o_off+1] = ((inbuf [1] & 0x0F) << 4) | ((inbuf [2] & 0x3C) >> 2);
-    outstr[o_off+2] = ((inbuf [2] & 0x03) << 6) | (inbuf [3] & 0x3F);
-  }
-
-  // handle b64 strings that are not padded correctly
-
-  if (inover) {
-    i_off = i*4;
-    o_off = i*3;
-
-    memset(inbuf,0,4);
-
-    for (cnt = 0; cnt < inover; cnt++) {
-      ch = instr[i_off+cnt];
-
-      if ((ch >= 'A') && (ch <= 'Z'))
-        ch = ch - 'A';
-
-      else if ((ch >= 'a') && (ch <= 'z'))
-        ch = ch - 'a' + 26;
-
-      else if ((ch >= '0') && (ch <= '9'))
-        ch = ch - '0' + 52;
-
-      else if (ch == '+')
-        ch = 62;
-
-      else if (ch == '=') //no op -- can't ignore this one*
-        ch = 0;
-
-      else if (ch == '/')
-        ch = 63;
-
-      inbuf[cnt] = ch;
-    }
-
-    outstr[o_off] = (inbuf [0] << 2) | ((inbuf [1] & 0x30) >> 4);
-    outstr[o_off+1] = ((inbuf [1] & 0x0F) << 4) | ((inbuf [2] & 0x3C) >> 2);
-    outstr[o_off+2] = ((inbuf [2] & 0x03) << 6) | (inbuf [3] & 0x3F);
-
-  }
+// encode data to B64 and append it to aString
+void b64::appendEncoded(std::string &aString, const uInt8 *instr, uInt32 len, sInt16 maxLineLen, bool crLineEnd)
+{
+  if ( (instr == NULL) || (len == 0) ) return;
+  maxLineLen &= ~3; // clear bit 0&1
+  // encode directly into the string
+  std::string::size_type start = aString.size();
+  aString.resize(start+encodedSize(len,maxLineLen,crLineEnd));
+  aString.resize(start+encodeTo(&aString[start],instr,len,maxLineLen,crLineEnd));
+} // b64::appendEncoded
 
-  if (outlenP) *outlenP = o_off+3;
 
-  return(outstr);
-  */
-}
+// decode B64 string and append the data to aString
+void b64::appendDecoded(std::string &aString, const char *instr, uInt32 len)
+{
+  if (!instr) return;
+  if (len==0) len=strlen(instr);
+  // decode directly into the string
+  std::string::size_type start = aString.size();
+  aString.resize(start+3*(len/4+1));
+  aString.resize(start+decodeTo((uInt8 *)&aString[start],instr,len));
+} // b64::appendDecoded
 
 // eof
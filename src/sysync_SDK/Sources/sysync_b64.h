@@ -4,6 +4,7 @@
 #define SYSYNC_B64_H
 
 #include "generic_types.h"
+#include <string>
 
 using namespace sysync;
 
@@ -22,6 +23,16 @@ uInt8 *decode(const char *instr, uInt32 len=0, uInt32 *outlenP=NULL);
 // free memory allocated with encode or decode above
 void free(void *mem);
 
+// encode data to B64 and append it to aString (no intermediate buffer)
+// does line breaks if maxLineLen!=0
+void appendEncoded(
+  std::string &aString, const uInt8 *instr, uInt32 len,
+  sInt16 maxLineLen=0, bool crLineEnd=false
+);
+
+// decode B64 string and append the data to aString (len=0 calculates string length automatically)
+void appendDecoded(std::string &aString, const char *instr, uInt32 len=0);
+
 }
 
 #endif /* SYSYNC_B64_H */
@@ -629,40 +629,42 @@ const char *appendDecoded(
 {
   char c;
   const char *p=aText;
-  uInt32 binsz;
-  uInt8 *binP;
+  const char *q;
 
   switch (aEncoding) {
     case enc_quoted_printable :
       // decode quoted-printable content
-      while ((c=*p++)) {
-        // char found
-        if (c=='=') {
-          uInt16 code;
-          char hex[2];
-          // check for soft break first
-          if (*p=='\x0D' || *p=='\x0A') {
-            // soft break, swallow
-            if (*p=='\x0D') p++;
-            if (*p=='\x0A') p++;
-            continue;
-          }
-          // decode
-          hex[0]=*p;
+      for (;;) {
+        // append run of plain chars up to the next escape at once
+        for (q=p; *q && *q!='='; q++);
+        aBinString.append(p,q-p);
+        p=q;
+        if (!(c=*p++)) break; // end of text
+        // escape found, c is '='
+        uInt16 code;
+        char hex[2];
+        // check for soft break first
+        if (*p=='\x0D' || *p=='\x0A') {
+          // soft break, swallow
+          if (*p=='\x0D') p++;
+          if (*p=='\x0A') p++;
+          continue;
+        }
+        // decode
+        hex[0]=*p;
+        if (*p) {
+          p++;
+          hex[1]=*p;
           if (*p) {
             p++;
-            hex[1]=*p;
-            if (*p) {
-              p++;
-              if (HexStrToUShort(hex,code,2)==2) {
-                c=code; // decoded char
-              }
-              else continue; // simply ignore
+            if (HexStrToUShort(hex,code,2)==2) {
+              c=code; // decoded char
             }
-            else break;
+            else continue; // simply ignore
           }
           else break;
         }
+        else break;
         // append char
         aBinString+=c;
       }
@@ -670,11 +672,8 @@ const char *appendDecoded(
       break;
     case enc_base64:
     case enc_b:
-      // decode base 64
-      binsz=0;
-      binP = b64::decode(aText, aSize, &binsz);
-      aBinString.append((const char *)binP,binsz);
-      b64::free(binP);
+      // decode base 64 directly into the string
+      b64::appendDecoded(aBinString, aText, aSize);
       aText+=aSize;
       break;
     case enc_7bit:
@@ -702,6 +701,15 @@ const char *appendDecoded(
 
 
 
+// true for chars which quoted-printable encoding copies as-is
+static inline bool isQPPlain(uInt8 c, bool aEncodeBinary)
+{
+  return
+    c>=0x20 && c<=0x7F && c!='=' // no control chars, no 8bit chars, not the escape char itself
+    && (c!='<' || !aEncodeBinary); // avoid XML mismatch problems
+} // isQPPlain
+
+
 // encode binary stream and append to string
 void appendEncoded(
   const uInt8 *aBinary,
@@ -715,11 +723,9 @@ void appendEncoded(
 )
 {
   char c;
-  string::size_type linestart;
-  const uInt8 *p;
+  string::size_type linestart, limit, room;
+  const uInt8 *p, *q;
   bool softbreak;
-  uInt32 b64len;
-  char *b64;
   bool processed;
 
   switch (aEncoding) {
@@ -735,7 +741,17 @@ void appendEncoded(
       // - determine start of last line in aString
       //   Note: this is because property text will be folded when lines aMaxLineSize
       linestart=aString.size()-aCurrLineSize;
+      limit=string::size_type(aMaxLineSize)-8;
       for (p=aBinary;p<aBinary+aSize;p++) { // '\0' will not terminate the 'for' loop
+        // append run of chars which need no encoding at once, as long as it stays below the
+        // soft break limit (the chars are copied as-is by the code below in that case as well)
+        room = !aMaxLineSize ? aSize : (aString.size()-linestart<limit ? limit-(aString.size()-linestart) : 0);
+        for (q=p; q<aBinary+aSize && room>0 && isQPPlain(*q,aEncodeBinary); q++, room--);
+        if (q>p) {
+          aString.append((const char *)p,q-p);
+          p=q-1;
+          continue;
+        }
         c=*p;
         if (!aEncodeBinary && !c) break; // still exit at NUL when not encoding real binary data
         processed=false; // input data in c is not yet processed
@@ -790,18 +806,12 @@ void appendEncoded(
       // use base64 encoding
       if (aSize>0) {
         // don't call b64 with size=0!
-        b64 = b64::encode(
+        b64::appendEncoded(
+          aString, // append directly to output
           aBinary,aSize, // what to encode
-          &b64len, // output size
           aMaxLineSize, // max line size
           aSoftBreaksAsCR
         );
-        // append to output, if any
-        if (b64) {
-          aString.append(b64,b64len);
-          // release buffer
-          b64::free(b64);
-        }
         if (aEncoding!=enc_b) {
           // make sure it ends with a newline for "base64" (but NOT for "b" as used in RFC2047)
           // Note: when used in vCard2.1, that newline is part of the property and show as an
@@ -0,0 +1,379 @@
+/*
+ *  decodebench
+ *    Benchmark for decoding SyncML messages in several threads at once.
+ *    Each thread has its own pair of SyncML toolkit instances and decodes
+ *    a generated message with a Sync full of Adds over and over again,
+ *    transcoding it into XML like sysytool wbxml2xml does. Checks that
+ *    every thread produces exactly the translation of a single threaded
+ *    run, and prints the throughput and the speedup over one thread
+ *    as JSON.
+ *
+ *  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+ *
+ */
+
+#include "sysync.h"
+#include "platform_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+using namespace sysync;
+
+
+#ifdef CONSOLEINFO_LIBC
+// the decoder reports each tag without attributes as a parsing error
+static int quietConsolePrintf(FILE *stream, const char *format, ...)
+{
+  return 0;
+} // quietConsolePrintf
+#endif
+
+
+static double nowUS(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec*1000000.0+ts.tv_nsec/1000.0;
+} // nowUS
+
+
+// the message to decode: a client's first Sync with aNumItems Adds of contacts
+static string makeMessage(long aNumItems)
+{
+  string msg;
+  char buf[1024];
+  msg =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+    "<SyncML xmlns='SYNCML:SYNCML1.2'>"
+    "<SyncHdr>"
+    "<VerDTD>1.2</VerDTD><VerProto>SyncML/1.2</VerProto>"
+    "<SessionID>42</SessionID><MsgID>2</MsgID>"
+    "<Target><LocURI>http://sync.example.com/sync</LocURI></Target>"
+    "<Source><LocURI>IMEI:493005100592800</LocURI></Source>"
+    "</SyncHdr>"
+    "<SyncBody>"
+    "<Sync><CmdID>1</CmdID>"
+    "<Target><LocURI>contacts</LocURI></Target>"
+    "<Source><LocURI>./contacts</LocURI></Source>";
+  for (long i=0; i<aNumItems; i++) {
+    snprintf(buf,sizeof(buf),
+      "<Add><CmdID>%ld</CmdID>"
+      "<Meta><Type xmlns='syncml:metinf'>text/x-vcard</Type></Meta>"
+      "<Item><Source><LocURI>%ld</LocURI></Source>"
+      "<Data>BEGIN:VCARD\r\nVERSION:2.1\r\nN:Contact%ld;Test;;;\r\n"
+      "FN:Test Contact%ld\r\nTEL;CELL:+41 79 555 %04ld\r\n"
+      "EMAIL;INTERNET:test.contact%ld@example.com\r\n"
+      "NOTE:just some text to make the item a bit longer\r\nEND:VCARD\r\n</Data>"
+      "</Item></Add>",
+      i+2,i+1,i,i,i%10000,i
+    );
+    msg += buf;
+  }
+  msg += "</Sync><Final/></SyncBody></SyncML>";
+  return msg;
+} // makeMessage
+
+
+// SyncML toolkit callbacks re-encoding everything decoded into another instance.
+// userData is a TTranscoder, decoded content is freed after being transcoded
+
+typedef struct {
+  InstanceID_t fOutInstance;
+  Ret_t fErr; // first error while encoding
+} TTranscoder;
+
+static Ret_t transcoded(VoidPtr_t aUserData, Ret_t aErr)
+{
+  TTranscoder *tP = (TTranscoder *)aUserData;
+  if (tP->fErr==SML_ERR_OK)
+    tP->fErr = aErr;
+  return SML_ERR_OK;
+} // transcoded
+
+#define OUTINSTANCE(u) (((TTranscoder *)(u))->fOutInstance)
+
+static Ret_t startMessageCallback(InstanceID_t id, VoidPtr_t userData, SmlSyncHdrPtr_t pContent)
+{
+  Ret_t r = smlStartMessageExt(OUTINSTANCE(userData),pContent,SML_VERS_1_2);
+  smlFreeProtoElement(pContent);
+  return transcoded(userData,r);
+}
+
+static Ret_t endMessageCallback(InstanceID_t id, VoidPtr_t userData, Boolean_t final)
+{
+  return transcoded(userData,smlEndMessage(OUTINSTANCE(userData),final));
+}
+
+static Ret_t startSyncCallback(InstanceID_t id, VoidPtr_t userData, SmlSyncPtr_t pContent)
+{
+  Ret_t r = smlStartSync(OUTINSTANCE(userData),pContent);
+  smlFreeProtoElement(pContent);
+  return transcoded(userData,r);
+}
+
+static Ret_t endSyncCallback(InstanceID_t id, VoidPtr_t userData)
+{
+  return transcoded(userData,smlEndSync(OUTINSTANCE(userData)));
+}
+
+static Ret_t addCmdCallback(InstanceID_t id, VoidPtr_t userData, SmlAddPtr_t pContent)
+{
+  Ret_t r = smlAddCmd(OUTINSTANCE(userData),pContent);
+  smlFreeProtoElement(pContent);
+  return transcoded(userData,r);
+}
+
+static Ret_t handleErrorCallback(InstanceID_t id, VoidPtr_t userData)
+{
+  return SML_ERR_OK;
+}
+
+
+// callbacks for the commands the generated message contains, the
+// toolkit reports all others as not handled
+static SmlCallbacks_t TranscodeCallbacks;
+
+static void initCallbacks(void)
+{
+  memset(&TranscodeCallbacks,0,sizeof(TranscodeCallbacks));
+  TranscodeCallbacks.startMessageFunc = startMessageCallback;
+  TranscodeCallbacks.endMessageFunc = endMessageCallback;
+  TranscodeCallbacks.startSyncFunc = startSyncCallback;
+  TranscodeCallbacks.endSyncFunc = endSyncCallback;
+  TranscodeCallbacks.addCmdFunc = addCmdCallback;
+  TranscodeCallbacks.handleErrorFunc = handleErrorCallback;
+} // initCallbacks
+
+
+// a decoding instance and the instance it transcodes into
+class TDecoder {
+public:
+  TDecoder() : fDecInstance(NULL) { fTranscoder.fOutInstance = NULL; };
+  ~TDecoder();
+  bool init(SmlEncoding_t aInEncoding, SmlEncoding_t aOutEncoding, MemSize_t aMsgSize);
+  // decode aMsg, transcoded message is in aOut afterwards
+  bool decode(const string &aMsg, string &aOut);
+  Ret_t fErr;
+private:
+  InstanceID_t fDecInstance;
+  TTranscoder fTranscoder;
+}; // TDecoder
+
+
+TDecoder::~TDecoder()
+{
+  if (fDecInstance) smlTerminateInstance(fDecInstance);
+  if (fTranscoder.fOutInstance) smlTerminateInstance(fTranscoder.fOutInstance);
+} // TDecoder::~TDecoder
+
+
+bool TDecoder::init(SmlEncoding_t aInEncoding, SmlEncoding_t aOutEncoding, MemSize_t aMsgSize)
+{
+  SmlInstanceOptions_t opts;
+  memset(&opts,0,sizeof(opts));
+  opts.encoding = aInEncoding;
+  opts.workspaceSize = aMsgSize+1024;
+  fErr = smlInitInstance(&TranscodeCallbacks,&opts,&fTranscoder,&fDecInstance);
+  if (fErr!=SML_ERR_OK) return false;
+  // transcoding can get longer (WBXML to XML), and with no limit on the outgoing size.
+  // The toolkit does not accept instances without callbacks, but encoding never calls them
+  opts.encoding = aOutEncoding;
+  opts.workspaceSize = 4*aMsgSize+64*1024;
+  fErr = smlInitInstance(&TranscodeCallbacks,&opts,NULL,&fTranscoder.fOutInstance);
+  return fErr==SML_ERR_OK;
+} // TDecoder::init
+
+
+bool TDecoder::decode(const string &aMsg, string &aOut)
+{
+  MemPtr_t bufP;
+  MemSize_t bufSiz;
+  fTranscoder.fErr = SML_ERR_OK;
+  fErr = smlLockWriteBuffer(fDecInstance,&bufP,&bufSiz);
+  if (fErr!=SML_ERR_OK) return false;
+  memcpy(bufP,aMsg.c_str(),aMsg.size());
+  smlUnlockWriteBuffer(fDecInstance,aMsg.size());
+  do {
+    fErr = smlProcessData(fDecInstance,SML_NEXT_COMMAND);
+  } while (fErr==SML_ERR_CONTINUE);
+  if (fErr==SML_ERR_OK)
+    fErr = fTranscoder.fErr;
+  if (smlLockReadBuffer(fTranscoder.fOutInstance,&bufP,&bufSiz)==SML_ERR_OK) {
+    aOut.assign((const char *)bufP,bufSiz);
+    smlUnlockReadBuffer(fTranscoder.fOutInstance,bufSiz);
+  }
+  return fErr==SML_ERR_OK;
+} // TDecoder::decode
+
+
+// one decoding thread
+typedef struct {
+  const string *fMsgP;
+  const string *fRefP; // expected XML translation
+  SmlEncoding_t fEncoding;
+  long fRounds;
+  long fDone; // rounds decoded into the expected translation
+  string fError;
+} TWorker;
+
+
+static uInt32 DecodeThreadFunc(TThreadObject *aThreadObject, uIntArch aParam)
+{
+  TWorker *wP = (TWorker *)aParam;
+  TDecoder dec;
+  string out;
+  char buf[80];
+  if (!dec.init(wP->fEncoding,SML_XML,wP->fMsgP->size())) {
+    snprintf(buf,sizeof(buf),"cannot create toolkit instances, err=%d",(int)dec.fErr);
+    wP->fError = buf;
+    return 0;
+  }
+  for (wP->fDone=0; wP->fDone<wP->fRounds; wP->fDone++) {
+    if (!dec.decode(*wP->fMsgP,out)) {
+      snprintf(buf,sizeof(buf),"decoding failed, err=%d",(int)dec.fErr);
+      wP->fError = buf;
+      break;
+    }
+    if (out!=*wP->fRefP) {
+      wP->fError = "translation differs from single threaded run";
+      break;
+    }
+  }
+  return 0;
+} // DecodeThreadFunc
+
+
+// decode in aNumThreads threads at once, returns MB/s of all threads together
+static double runThreads(
+  const string &aMsg, const string &aRef, SmlEncoding_t aEncoding,
+  long aNumThreads, long aRounds, string &aError
+)
+{
+  TWorker *workers = new TWorker[aNumThreads];
+  TThreadObject *threadObjs = new TThreadObject[aNumThreads];
+  long launched = 0;
+  double startUS = nowUS();
+  for (; launched<aNumThreads; launched++) {
+    TWorker &w = workers[launched];
+    w.fMsgP = &aMsg;
+    w.fRefP = &aRef;
+    w.fEncoding = aEncoding;
+    w.fRounds = aRounds;
+    w.fDone = 0;
+    if (!threadObjs[launched].launch(DecodeThreadFunc,(uIntArch)&w)) {
+      aError = "cannot launch decoding thread";
+      break;
+    }
+  }
+  for (long i=0; i<launched; i++)
+    threadObjs[i].waitfor(-1);
+  double us = nowUS()-startUS;
+  double bytes = 0;
+  for (long i=0; i<launched; i++) {
+    if (aError.empty() && !workers[i].fError.empty())
+      aError = workers[i].fError;
+    bytes += (double)aMsg.size()*workers[i].fDone;
+  }
+  delete[] threadObjs;
+  delete[] workers;
+  return us>0 ? bytes/1024/1024*1000000/us : 0;
+} // runThreads
+
+
+static void usage(void)
+{
+  fprintf(stderr,
+    "Usage: decodebench [-n items] [-r rounds] [-t maxthreads] [-e xml|wbxml]\n"
+    "  -n  number of Adds in the message (default 100)\n"
+    "  -r  number of times each thread decodes the message (default 200)\n"
+    "  -t  decode in 1, 2, 4... up to this many threads (default 8)\n"
+    "  -e  only measure this encoding (default both)\n"
+  );
+} // usage
+
+
+int main(int argc, char *argv[])
+{
+  long numItems = 100;
+  long rounds = 200;
+  long maxThreads = 8;
+  const char *encArg = NULL;
+  int c;
+  while ((c=getopt(argc,argv,"n:r:t:e:"))!=-1) {
+    switch (c) {
+      case 'n': numItems = atol(optarg); break;
+      case 'r': rounds = atol(optarg); break;
+      case 't': maxThreads = atol(optarg); break;
+      case 'e': encArg = optarg; break;
+      default: usage(); return EXIT_FAILURE;
+    }
+  }
+  if (
+    numItems<1 || rounds<1 || maxThreads<1 ||
+    (encArg && strcmp(encArg,"xml")!=0 && strcmp(encArg,"wbxml")!=0)
+  ) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  #ifdef CONSOLEINFO_LIBC
+  SySync_ConsolePrintf = quietConsolePrintf;
+  #endif
+  initCallbacks();
+
+  // the message in both encodings, and its translation as produced
+  // by a single thread
+  string msg[2], ref[2];
+  SmlEncoding_t encodings[2] = { SML_XML, SML_WBXML };
+  msg[0] = makeMessage(numItems);
+  TDecoder toWBXML, fromWBXML, fromXML;
+  if (
+    !toWBXML.init(SML_XML,SML_WBXML,msg[0].size()) ||
+    !toWBXML.decode(msg[0],msg[1]) ||
+    !fromWBXML.init(SML_WBXML,SML_XML,msg[0].size()) ||
+    !fromWBXML.decode(msg[1],ref[1]) ||
+    !fromXML.init(SML_XML,SML_XML,msg[0].size()) ||
+    !fromXML.decode(msg[0],ref[0])
+  ) {
+    fprintf(stderr,"decodebench: cannot prepare message\n");
+    return EXIT_FAILURE;
+  }
+  if (ref[0].empty() || ref[0]!=ref[1]) {
+    fprintf(stderr,"decodebench: XML and WBXML message do not translate to the same XML\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("{\n");
+  printf("  \"items\": %ld,\n",numItems);
+  printf("  \"rounds\": %ld,\n",rounds);
+  printf("  \"cpus\": %ld,\n",sysconf(_SC_NPROCESSORS_ONLN));
+  printf("  \"runs\": [");
+  string error;
+  bool first = true;
+  for (int e=0; e<2 && error.empty(); e++) {
+    const char *encName = encodings[e]==SML_XML ? "xml" : "wbxml";
+    if (encArg && strcmp(encArg,encName)!=0) continue;
+    double single = 0;
+    for (long threads=1; threads<=maxThreads && error.empty(); threads*=2) {
+      double mbps = runThreads(msg[e],ref[e],encodings[e],threads,rounds,error);
+      if (threads==1) single = mbps;
+      printf(
+        "%s\n    { \"encoding\": \"%s\", \"message_bytes\": %ld, \"threads\": %ld, \"mb_per_sec\": %.2f, \"speedup\": %.2f }",
+        first ? "" : ",", encName, (long)msg[e].size(), threads, mbps, single>0 ? mbps/single : 0
+      );
+      first = false;
+    }
+  }
+  printf("\n  ]\n}\n");
+  if (!error.empty()) {
+    fprintf(stderr,"decodebench: %s\n",error.c_str());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+} // main
+
+
+// eof
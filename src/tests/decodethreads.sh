@@ -0,0 +1,12 @@
+#!/bin/sh
+#
+#  decodethreads
+#    Runs tests/decodebench with 1, 2, 4 and 8 threads decoding at the
+#    same time. decodebench fails if any thread cannot decode the message
+#    or does not produce the same translation as a single thread.
+#
+#  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+#
+
+./tests/decodebench -n 20 -r 20 -t 8 >/dev/null || exit 1
+exit 0
@@ -0,0 +1,432 @@
+/*
+ *  dispatchbench
+ *    Stress test and benchmark for the sharded session table of
+ *    TSyncSessionDispatch. Worker threads look up and enter their sessions,
+ *    admit new sessions (which sweeps timed-out ones), end sessions and
+ *    abandon sessions so that they time out, while another thread runs the
+ *    expiry sweep continuously. Checks that no session in use gets lost or
+ *    mixed up and that the table is consistent at the end, and prints the
+ *    dispatch latencies as JSON.
+ *
+ *  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+ *
+ */
+
+#include "syncsessiondispatch.h"
+#include "enginesessiondispatch.h"
+#include "platform_mutex.h"
+#include "platform_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <algorithm>
+
+using namespace sysync;
+
+
+static const char *ConfigTemplate =
+  "<?xml version=\"1.0\"?>\n"
+  "<sysync_config version=\"1.0\">\n"
+  "  <debug><sessionlogs>no</sessionlogs></debug>\n"
+  "  <server type=\"plugin\">\n"
+  "    <plugin_module>[SDK_textdb]</plugin_module>\n"
+  "    <sessiontimeout>%ld</sessiontimeout>\n"
+  "  </server>\n"
+  "</sysync_config>\n";
+
+
+#ifdef CONSOLEINFO_LIBC
+// keeps the "Started new SyncML session" messages out of the measurements
+static int quietConsolePrintf(FILE *stream, const char *format, ...)
+{
+  return 0;
+} // quietConsolePrintf
+#endif
+
+
+static double nowUS(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return ts.tv_sec*1000000.0+ts.tv_nsec/1000.0;
+} // nowUS
+
+
+class TBenchDispatch;
+
+// session handle with a real lock, as used by multithreaded servers
+class TBenchSessionHandle : public TSyncSessionHandle {
+  typedef TSyncSessionHandle inherited;
+public:
+  TBenchSessionHandle(TBenchDispatch *aDispatchP);
+  virtual ~TBenchSessionHandle();
+  virtual bool EnterSession(sInt32 aMaxWaitTime);
+  virtual void LeaveSession(void);
+  virtual bool EnterAndTerminateSession(uInt16 aStatusCode);
+private:
+  TBenchDispatch *fDispatchP;
+  MutexPtr_t fMutex;
+}; // TBenchSessionHandle
+
+
+// dispatcher with a session list lock, counting its session handles
+class TBenchDispatch : public TSyncSessionDispatch {
+  typedef TSyncSessionDispatch inherited;
+public:
+  TBenchDispatch();
+  virtual ~TBenchDispatch();
+  virtual TSyncSessionHandle *CreateSessionHandle(void) { return new TBenchSessionHandle(this); };
+  // end a session the way EndRequest does when the session is done
+  void EndSession(TSyncAgent *aSessionP) { KillServerSession(aSessionP,0,"end of session"); };
+  // delete timed-out sessions, returns number of sessions found timed out
+  sInt32 SweepSessions(void);
+  // session handle accounting
+  void countHandle(sInt32 aDiff);
+  sInt32 handles(void) { return fHandles; };
+protected:
+  virtual void LockSessions(void) { lockMutex(fSessionsMutex); };
+  virtual void ReleaseSessions(void) { unlockMutex(fSessionsMutex); };
+private:
+  MutexPtr_t fSessionsMutex;
+  MutexPtr_t fCountMutex;
+  sInt32 fHandles;
+}; // TBenchDispatch
+
+
+// engine interface creating the benchmark dispatcher as its appbase
+class TBenchServerEngine : public TServerEngineInterface {
+  typedef TServerEngineInterface inherited;
+public:
+  virtual TSyncAppBase *newSyncAppBase(void) { return new TBenchDispatch; };
+}; // TBenchServerEngine
+
+
+TBenchSessionHandle::TBenchSessionHandle(TBenchDispatch *aDispatchP) :
+  inherited(aDispatchP),
+  fDispatchP(aDispatchP)
+{
+  fMutex = newMutex();
+  fDispatchP->countHandle(1);
+} // TBenchSessionHandle::TBenchSessionHandle
+
+
+TBenchSessionHandle::~TBenchSessionHandle()
+{
+  freeMutex(fMutex);
+  fDispatchP->countHandle(-1);
+} // TBenchSessionHandle::~TBenchSessionHandle
+
+
+bool TBenchSessionHandle::EnterSession(sInt32 aMaxWaitTime)
+{
+  return aMaxWaitTime==0 ? tryLockMutex(fMutex) : lockMutex(fMutex);
+} // TBenchSessionHandle::EnterSession
+
+
+void TBenchSessionHandle::LeaveSession(void)
+{
+  unlockMutex(fMutex);
+} // TBenchSessionHandle::LeaveSession
+
+
+bool TBenchSessionHandle::EnterAndTerminateSession(uInt16 aStatusCode)
+{
+  // wait until the thread using the session has left it. The handle is not
+  // in the session table any more, so the lock can be released again before
+  // the handle is deleted
+  lockMutex(fMutex);
+  bool ok = TerminateSession(aStatusCode);
+  unlockMutex(fMutex);
+  return ok;
+} // TBenchSessionHandle::EnterAndTerminateSession
+
+
+TBenchDispatch::TBenchDispatch()
+{
+  fConfigP = new TEngineServerRootConfig(this);
+  fSessionsMutex = newMutex();
+  fCountMutex = newMutex();
+  fHandles = 0;
+} // TBenchDispatch::TBenchDispatch
+
+
+TBenchDispatch::~TBenchDispatch()
+{
+  fDeleting=true; // flag deletion to block calling critical (virtual) methods
+  // delete sessions now, while the handles can still be counted
+  TerminateAllSessions(500);
+  freeMutex(fSessionsMutex);
+  freeMutex(fCountMutex);
+} // TBenchDispatch::~TBenchDispatch
+
+
+sInt32 TBenchDispatch::SweepSessions(void)
+{
+  TSyncSessionHandlePList delList;
+  LockSessions();
+  collectTimedOutSessions(delList);
+  ReleaseSessions();
+  sInt32 n = delList.size();
+  deleteListedSessions(delList);
+  return n;
+} // TBenchDispatch::SweepSessions
+
+
+void TBenchDispatch::countHandle(sInt32 aDiff)
+{
+  lockMutex(fCountMutex);
+  fHandles+=aDiff;
+  unlockMutex(fCountMutex);
+} // TBenchDispatch::countHandle
+
+
+// state and results of one worker thread
+typedef struct {
+  TBenchDispatch *fDispatchP;
+  int fIndex;
+  long fSlots; // number of devices (sessions) of this worker
+  double fEndUS; // time to stop at
+  vector<double> fLookupUS; // lookup and enter of existing sessions
+  vector<double> fAdmitUS; // admission of new sessions, including the sweep
+  long fEnded; // sessions ended regularly
+  long fAbandoned; // sessions left to time out
+  long fLost; // sessions in use which were not found any more
+  long fWrong; // lookups returning another session
+  string fError;
+} TWorker;
+
+
+// state and results of the sweeper thread
+typedef struct {
+  TBenchDispatch *fDispatchP;
+  double fEndUS; // time to stop at
+  vector<double> fSweepUS;
+  long fExpired;
+} TSweeper;
+
+
+static uInt32 WorkerThreadFunc(TThreadObject *aThreadObject, uIntArch aParam)
+{
+  TWorker *w = (TWorker *)aParam;
+  vector<string> sessionIDs(w->fSlots);
+  TSyncSessionHandle *sessionHP;
+  double t;
+  char uri[50];
+  for (long op=0; nowUS()<w->fEndUS; op++) {
+    long slot = op % w->fSlots;
+    string &sessionID = sessionIDs[slot];
+    if (sessionID.empty()) {
+      // device starts a new session
+      snprintf(uri,sizeof(uri),"bench-%d-%ld",w->fIndex,slot);
+      sInt32 others;
+      t = nowUS();
+      sessionHP = w->fDispatchP->AdmitServerSession(uri,others);
+      w->fAdmitUS.push_back(nowUS()-t);
+      if (!sessionHP) {
+        w->fError = "no session admitted";
+        return 1;
+      }
+      sessionID = sessionHP->fSessionP->getLocalSessionID();
+      sessionHP->LeaveSession();
+    }
+    else if (op % 97 == 0) {
+      // device goes away, session must time out
+      sessionID.erase();
+      w->fAbandoned++;
+    }
+    else {
+      // next request for an existing session
+      t = nowUS();
+      if (!w->fDispatchP->FindAndEnterSession(sessionID,sessionHP)) {
+        w->fError = "session could not be entered";
+        return 1;
+      }
+      w->fLookupUS.push_back(nowUS()-t);
+      if (!sessionHP) {
+        w->fLost++;
+        sessionID.erase();
+        continue;
+      }
+      TSyncAgent *sessionP = sessionHP->fSessionP;
+      if (sessionID!=sessionP->getLocalSessionID())
+        w->fWrong++;
+      sessionP->SessionUsed();
+      sessionHP->LeaveSession();
+      if (op % 89 == 0) {
+        // last request of the session
+        w->fDispatchP->EndSession(sessionP);
+        sessionID.erase();
+        w->fEnded++;
+      }
+    }
+  }
+  return 0;
+} // WorkerThreadFunc
+
+
+static uInt32 SweeperThreadFunc(TThreadObject *aThreadObject, uIntArch aParam)
+{
+  TSweeper *s = (TSweeper *)aParam;
+  while (nowUS()<s->fEndUS) {
+    double t = nowUS();
+    s->fExpired += s->fDispatchP->SweepSessions();
+    s->fSweepUS.push_back(nowUS()-t);
+    sleepLineartime(secondToLinearTimeFactor/100);
+  }
+  return 0;
+} // SweeperThreadFunc
+
+
+// print count and percentiles of latencies
+static void printLatencies(const char *aName, vector<double> &aUS, bool aLast)
+{
+  sort(aUS.begin(),aUS.end());
+  size_t n = aUS.size();
+  printf(
+    "  \"%s\": { \"count\": %ld, \"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f }%s\n",
+    aName,
+    (long)n,
+    n ? aUS[n/2] : 0.0,
+    n ? aUS[n*99/100] : 0.0,
+    n ? aUS[n-1] : 0.0,
+    aLast ? "" : ","
+  );
+} // printLatencies
+
+
+static void usage(const char *aProgName)
+{
+  fprintf(stderr,"usage: %s [-t <threads>] [-s <sessions per thread>] [-d <seconds>] [-x <session timeout seconds>]\n",aProgName);
+} // usage
+
+
+int main(int argc, char *argv[])
+{
+  long numThreads = 4;
+  long numSlots = 20;
+  long duration = 3;
+  long timeout = 1;
+  int opt;
+  while ((opt=getopt(argc,argv,"t:s:d:x:"))!=-1) {
+    switch (opt) {
+      case 't' : numThreads = atol(optarg); break;
+      case 's' : numSlots = atol(optarg); break;
+      case 'd' : duration = atol(optarg); break;
+      case 'x' : timeout = atol(optarg); break;
+      default : usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if (numThreads<=0 || numSlots<=0 || duration<=0 || timeout<=0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  #ifdef CONSOLEINFO_LIBC
+  SySync_ConsolePrintf = quietConsolePrintf;
+  #endif
+  // engine with the benchmark dispatcher
+  char config[1024];
+  snprintf(config,sizeof(config),ConfigTemplate,timeout);
+  TBenchServerEngine *engineP = new TBenchServerEngine;
+  TSyError sta = engineP->Connect("",0,0);
+  if (sta==LOCERR_OK)
+    sta = engineP->InitEngineXML(config);
+  if (sta!=LOCERR_OK) {
+    fprintf(stderr,"dispatchbench failed: engine init, err=%hu\n",sta);
+    delete engineP;
+    return EXIT_FAILURE;
+  }
+  TBenchDispatch *dispatchP = static_cast<TBenchDispatch *>(engineP->getSyncAppBase());
+  // run workers and sweeper
+  vector<TWorker> workers(numThreads);
+  TSweeper sweeper;
+  sweeper.fDispatchP = dispatchP;
+  sweeper.fExpired = 0;
+  TThreadObject *threadObjs = new TThreadObject[numThreads+1];
+  string error;
+  long launched = 0;
+  double start = nowUS();
+  double endUS = start+duration*1000000.0;
+  sweeper.fEndUS = endUS;
+  for (; launched<numThreads; launched++) {
+    TWorker &w = workers[launched];
+    w.fDispatchP = dispatchP;
+    w.fIndex = launched;
+    w.fSlots = numSlots;
+    w.fEndUS = endUS;
+    w.fEnded = 0;
+    w.fAbandoned = 0;
+    w.fLost = 0;
+    w.fWrong = 0;
+    if (!threadObjs[launched].launch(WorkerThreadFunc,(uIntArch)&w)) {
+      error = "cannot launch worker thread";
+      break;
+    }
+  }
+  bool sweeping = error.empty() && threadObjs[numThreads].launch(SweeperThreadFunc,(uIntArch)&sweeper);
+  if (error.empty() && !sweeping)
+    error = "cannot launch sweeper thread";
+  for (long i=0; i<launched; i++)
+    threadObjs[i].waitfor(-1);
+  if (sweeping)
+    threadObjs[numThreads].waitfor(-1);
+  double elapsedS = (nowUS()-start)/1000000;
+  delete[] threadObjs;
+  // collect results and check them
+  vector<double> lookupUS, admitUS;
+  long ended = 0, abandoned = 0, lost = 0, wrong = 0;
+  for (long i=0; i<launched; i++) {
+    TWorker &w = workers[i];
+    if (error.empty() && !w.fError.empty()) error = w.fError;
+    lookupUS.insert(lookupUS.end(),w.fLookupUS.begin(),w.fLookupUS.end());
+    admitUS.insert(admitUS.end(),w.fAdmitUS.begin(),w.fAdmitUS.end());
+    ended += w.fEnded;
+    abandoned += w.fAbandoned;
+    lost += w.fLost;
+    wrong += w.fWrong;
+  }
+  sInt32 listed = dispatchP->numSessions();
+  sInt32 handles = dispatchP->handles();
+  if (error.empty()) {
+    char buf[100];
+    if (lost || wrong) {
+      snprintf(buf,sizeof(buf),"%ld sessions in use lost, %ld wrong sessions found",lost,wrong);
+      error = buf;
+    }
+    else if (listed!=handles) {
+      snprintf(buf,sizeof(buf),"%ld sessions listed, but %ld session handles exist",(long)listed,(long)handles);
+      error = buf;
+    }
+    else if (duration>=2*timeout && abandoned>0 && admitUS.size()-ended==(size_t)listed) {
+      // all sessions ever admitted and not ended are still there
+      error = "no abandoned session timed out";
+    }
+  }
+  engineP->Disconnect();
+  delete engineP;
+  if (!error.empty()) {
+    fprintf(stderr,"dispatchbench failed: %s\n",error.c_str());
+    return EXIT_FAILURE;
+  }
+  // report
+  printf("{\n");
+  printf("  \"threads\": %ld,\n",numThreads);
+  printf("  \"sessions_per_thread\": %ld,\n",numSlots);
+  printf("  \"shards\": %d,\n",SESSION_SHARDS);
+  printf("  \"seconds\": %.1f,\n",elapsedS);
+  printf("  \"session_timeout\": %ld,\n",timeout);
+  printf("  \"requests_per_sec\": %.1f,\n",(lookupUS.size()+admitUS.size())/elapsedS);
+  printf("  \"ended\": %ld,\n",ended);
+  printf("  \"abandoned\": %ld,\n",abandoned);
+  printf("  \"expired\": %ld,\n",(long)(admitUS.size()-ended-listed));
+  printf("  \"expired_by_sweeper\": %ld,\n",sweeper.fExpired);
+  printf("  \"sessions_left\": %ld,\n",(long)listed);
+  printLatencies("lookup",lookupUS,false);
+  printLatencies("admission",admitUS,false);
+  printLatencies("sweep",sweeper.fSweepUS,true);
+  printf("}\n");
+  return EXIT_SUCCESS;
+} // main
+
+/* eof */
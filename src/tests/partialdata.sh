@@ -0,0 +1,14 @@
+#!/bin/sh
+#
+#  partialdata
+#    Runs tests/syncbench with every SyncML message passed to the engines in
+#    small parts (STEPCMD_GOTPARTIALDATA), for XML and WBXML. syncbench fails
+#    if a sync reports an error or the client does not end up with all items.
+#
+#  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+#
+
+for enc in wbxml xml; do
+  ./tests/syncbench -n 20 -e $enc -p 61 >/dev/null || exit 1
+done
+exit 0
@@ -0,0 +1,15 @@
+#!/bin/sh
+#
+#  sessiondispatch
+#    Runs tests/dispatchbench with one and with several worker threads.
+#    dispatchbench fails if a session in use gets lost or mixed up, if the
+#    session table and the session handles do not match at the end, or if
+#    no abandoned session timed out.
+#
+#  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+#
+
+for threads in 1 8; do
+  ./tests/dispatchbench -t $threads -s 10 -d 2 >/dev/null || exit 1
+done
+exit 0
@@ -0,0 +1,138 @@
+/*
+ *  sessionstepasync
+ *    Checks TServerEngineInterface::SessionStepAsync with a step chained
+ *    from the completion callback of the previous one and the session
+ *    closed from the completion callback of the chained step, once
+ *    executed synchronously (no <workerthreads>) and once on a worker pool.
+ *
+ *  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+ *
+ */
+
+#include "enginesessiondispatch.h"
+#include "platform_mutex.h"
+
+#include <stdio.h>
+
+using namespace sysync;
+
+
+static const char *ConfigTemplate =
+  "<?xml version=\"1.0\"?>\n"
+  "<sysync_config version=\"1.0\">\n"
+  "  <debug><sessionlogs>no</sessionlogs></debug>\n"
+  "  %s\n"
+  "  <server type=\"plugin\">\n"
+  "    <plugin_module>[SDK_textdb]</plugin_module>\n"
+  "  </server>\n"
+  "</sysync_config>\n";
+
+
+// state shared between the test and the completion callbacks
+typedef struct {
+  TServerEngineInterface *fEngineP;
+  MutexPtr_t fMutex;
+  CondPtr_t fCond;
+  int fCallbacks; // number of completion callbacks so far
+  TSyError fChainSta; // result of posting the second step from the first callback
+  TSyError fCloseSta; // result of CloseSession from the second callback
+  TSyError fAfterCloseSta; // result of posting another step after CloseSession
+  bool fDone;
+} TStepTestState;
+
+
+static void StepDone(SessionH aSessionH, uInt16 aStepCmd, TSyError aStatus, void *aContext)
+{
+  TStepTestState *stateP = static_cast<TStepTestState *>(aContext);
+  lockMutex(stateP->fMutex);
+  int n = ++stateP->fCallbacks;
+  unlockMutex(stateP->fMutex);
+  if (n==1) {
+    // chain the next step (runs nested when there is no pool)
+    TSyError sta = stateP->fEngineP->SessionStepAsync(aSessionH, STEPCMD_STEP, NULL, StepDone, aContext);
+    lockMutex(stateP->fMutex);
+    stateP->fChainSta = sta;
+    unlockMutex(stateP->fMutex);
+  }
+  else {
+    // close from the second callback, the handle must stay valid until all frames have returned
+    TSyError sta = stateP->fEngineP->CloseSession(aSessionH);
+    TSyError sta2 = stateP->fEngineP->SessionStepAsync(aSessionH, STEPCMD_STEP, NULL, StepDone, aContext);
+    lockMutex(stateP->fMutex);
+    stateP->fCloseSta = sta;
+    stateP->fAfterCloseSta = sta2;
+    stateP->fDone = true;
+    signalCond(stateP->fCond);
+    unlockMutex(stateP->fMutex);
+  }
+} // StepDone
+
+
+// run chained steps on one engine, returns number of failures
+static int runChainedSteps(const char *aOptions, int aRounds)
+{
+  int failures = 0;
+  char config[1024];
+  snprintf(config, sizeof(config), ConfigTemplate, aOptions);
+  TServerEngineInterface *engineP = static_cast<TServerEngineInterface *>(newServerEngine());
+  TSyError sta = engineP->Connect("", 0, 0);
+  if (sta==LOCERR_OK)
+    sta = engineP->InitEngineXML(config);
+  if (sta!=LOCERR_OK) {
+    printf("FAIL %s: engine init, err=%hu\n", aOptions, sta);
+    delete engineP;
+    return 1;
+  }
+  TWorkerPool *poolP = engineP->getSyncAppBase()->getWorkerPool();
+  for (int i=0; i<aRounds; i++) {
+    TStepTestState state;
+    state.fEngineP = engineP;
+    state.fMutex = newMutex();
+    state.fCond = newCond();
+    state.fCallbacks = 0;
+    state.fChainSta = LOCERR_UNDEFINED;
+    state.fCloseSta = LOCERR_UNDEFINED;
+    state.fAfterCloseSta = LOCERR_UNDEFINED;
+    state.fDone = false;
+    SessionH sessionH = NULL;
+    sta = engineP->OpenSession(sessionH, 0, "steptest");
+    if (sta==LOCERR_OK)
+      sta = engineP->SessionStepAsync(sessionH, STEPCMD_STEP, NULL, StepDone, &state);
+    if (sta!=LOCERR_OK) {
+      printf("FAIL %s: round %d, starting step, err=%hu\n", aOptions, i, sta);
+      failures++;
+    }
+    else {
+      lockMutex(state.fMutex);
+      while (!state.fDone) waitCond(state.fCond, state.fMutex);
+      unlockMutex(state.fMutex);
+      // let the first step's frame return as well
+      if (poolP) poolP->waitIdle();
+      if (state.fCallbacks!=2 || state.fChainSta!=LOCERR_OK || state.fCloseSta!=LOCERR_OK || state.fAfterCloseSta!=LOCERR_WRONGUSAGE) {
+        printf(
+          "FAIL %s: round %d, callbacks=%d chain=%hu close=%hu afterclose=%hu\n",
+          aOptions, i, state.fCallbacks, state.fChainSta, state.fCloseSta, state.fAfterCloseSta
+        );
+        failures++;
+      }
+    }
+    freeCond(state.fCond);
+    freeMutex(state.fMutex);
+  }
+  engineP->Disconnect();
+  delete engineP;
+  printf("%s %s: %d rounds\n", failures ? "FAIL" : "PASS", *aOptions ? aOptions : "no pool", aRounds);
+  return failures;
+} // runChainedSteps
+
+
+int main(int argc, char *argv[])
+{
+  int failures = 0;
+  failures += runChainedSteps("", 20);
+  failures += runChainedSteps("<workerthreads>1</workerthreads>", 100);
+  failures += runChainedSteps("<workerthreads>4</workerthreads>", 100);
+  return failures ? 1 : 0;
+} // main
+
+/* eof */
@@ -0,0 +1,639 @@
+/*
+ *  syncbench
+ *    End-to-end sync benchmark: runs a client engine against a server engine
+ *    in the same process, passing SyncML messages through memory buffers.
+ *    Both use the SDK_textdb plugin with the sample configs. Measures slow,
+ *    two-way, refresh and resume syncs of the "contacts" datastore and prints
+ *    the results as JSON. With -p, both engines get each message in parts of
+ *    the given size (STEPCMD_GOTPARTIALDATA), as from a slow network.
+ *
+ *  Copyright (c) 2001-2011 by Synthesis AG + plan44.ch
+ *
+ */
+
+#include "engineinterface.h"
+#include "lineartime.h"
+#include "iso8601.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <sys/resource.h>
+
+using namespace sysync;
+
+#ifndef SYNCBENCH_CONFIGDIR
+#define SYNCBENCH_CONFIGDIR "sysync_SDK/configs"
+#endif
+
+#define BENCH_DATASTORE "contacts"
+#define BENCH_USER "test"
+#define BENCH_CLIENT_USER "singleuser" // textdb user name of the client's datastore files
+
+
+// measurements of one sync session (or of a suspended plus resumed pair)
+typedef struct {
+  const char *fName;
+  double fClientMS; // time spent in client engine steps
+  double fServerMS; // time spent in server engine steps
+  long fMessages; // client to server messages
+  long fClientBytes; // bytes sent by client
+  long fServerBytes; // bytes sent by server
+  long fItems; // items added/updated/deleted on both sides, as reported by the client
+  long fSyncEndError; // error reported with PEV_SYNCEND or PEV_SESSIONEND, 0 if ok
+} TBenchResult;
+
+
+// the engines and the state of the current session
+typedef struct {
+  TEngineModuleBase *fClientP;
+  TEngineModuleBase *fServerP;
+  SessionH fServerSessionH;
+  sInt32 fProfileID;
+  string fResponse; // last server response, to be passed to the client
+  long fPartSize; // if >0, messages are passed in parts of this size with STEPCMD_GOTPARTIALDATA
+  string fError;
+} TBench;
+
+
+static double elapsedMS(lineartime_t aStart)
+{
+  return (double)(getSystemNowAs(TCTX_UTC,NULL)-aStart)*1000/secondToLinearTimeFactor;
+} // elapsedMS
+
+
+// read a file into a string
+static bool readFile(const string &aFileName, string &aData)
+{
+  FILE *f = fopen(aFileName.c_str(),"rb");
+  if (!f) return false;
+  char chunk[4096];
+  size_t n;
+  aData.erase();
+  while ((n=fread(chunk,1,sizeof(chunk),f))>0)
+    aData.append(chunk,n);
+  fclose(f);
+  return true;
+} // readFile
+
+
+static bool writeFile(const string &aFileName, const string &aData)
+{
+  FILE *f = fopen(aFileName.c_str(),"wb");
+  if (!f) return false;
+  bool ok = fwrite(aData.c_str(),1,aData.size(),f)==aData.size();
+  return fclose(f)==0 && ok;
+} // writeFile
+
+
+// replace all occurrences of aOld by aNew
+static void replaceAll(string &aStr, const string &aOld, const string &aNew)
+{
+  string::size_type n = 0;
+  while ((n=aStr.find(aOld,n))!=string::npos) {
+    aStr.replace(n,aOld.size(),aNew);
+    n+=aNew.size();
+  }
+} // replaceAll
+
+
+// adapt sample config: no logs, given message size, text files in aDataDir
+static void adaptConfig(string &aConfig, sInt32 aMaxMsgSize, const string &aDataDir, bool aClient)
+{
+  string pathParams =
+    "<datafilepath>" + aDataDir + "</datafilepath><mapfilepath>" + aDataDir + "</mapfilepath>";
+  // no session logs
+  replaceAll(aConfig,"<sessionlogs>yes</sessionlogs>","<sessionlogs>no</sessionlogs>");
+  replaceAll(aConfig,"<logenabled>yes</logenabled>","<logenabled>no</logenabled>");
+  // message size
+  char buf[100];
+  snprintf(buf,sizeof(buf),"<maxmsgsize>%ld</maxmsgsize>",(long)aMaxMsgSize);
+  replaceAll(aConfig,"<sysync_config version=\"1.0\">",string("<sysync_config version=\"1.0\">")+buf);
+  if (aClient) {
+    // client: binfiles and datastore text files in data dir (client datastores have no plugin params)
+    replaceAll(aConfig,"<client type=\"plugin\">","<client type=\"plugin\"><binfilespath>" + aDataDir + "</binfilespath>");
+    replaceAll(aConfig,"<plugin_module>[SDK_textdb]</plugin_module>","<plugin_module>[SDK_textdb]</plugin_module><plugin_params>" + pathParams + "</plugin_params>");
+  }
+  else {
+    // server: text files in data dir
+    replaceAll(aConfig,"<plugin_params>","<plugin_params>" + pathParams);
+  }
+} // adaptConfig
+
+
+// create and initialize an engine
+static TEngineModuleBase *newEngine(bool aServer, const string &aConfig, string &aError)
+{
+  TEngineModuleBase *engineP = aServer ? newServerEngine() : newClientEngine();
+  TSyError sta = engineP->Connect("",0,0);
+  if (sta==LOCERR_OK)
+    sta = engineP->InitEngineXML(aConfig.c_str());
+  if (sta!=LOCERR_OK) {
+    char buf[100];
+    snprintf(buf,sizeof(buf),"%s engine init failed, err=%hu",aServer ? "server" : "client",sta);
+    aError = buf;
+    engineP->Disconnect();
+    delete engineP;
+    return NULL;
+  }
+  return engineP;
+} // newEngine
+
+
+// create the client profile with only the benchmark datastore enabled
+static TSyError setupProfile(TBench &aBench, SmlEncoding_t aEncoding)
+{
+  TEngineModuleBase *e = aBench.fClientP;
+  KeyH profilesH = NULL, profileH = NULL, targetsH = NULL, targetH = NULL;
+  TSyError sta = e->OpenKeyByPath(profilesH,NULL,"/profiles",0);
+  if (sta==LOCERR_OK) sta = e->OpenSubkey(profileH,profilesH,KEYVAL_ID_NEW_DEFAULT,0);
+  if (sta==LOCERR_OK) sta = e->GetKeyID(profileH,aBench.fProfileID);
+  if (sta==LOCERR_OK) sta = e->SetStrValue(profileH,"serverURI","http://localhost/syncbench");
+  if (sta==LOCERR_OK) sta = e->SetStrValue(profileH,"serverUser",BENCH_USER);
+  if (sta==LOCERR_OK) sta = e->SetStrValue(profileH,"serverPassword",BENCH_USER);
+  if (sta==LOCERR_OK) sta = e->SetInt16Value(profileH,"encoding",aEncoding);
+  if (sta==LOCERR_OK) sta = e->OpenKeyByPath(targetsH,profileH,"targets",0);
+  if (sta==LOCERR_OK) {
+    sInt32 id = KEYVAL_ID_FIRST;
+    while (sta==LOCERR_OK) {
+      if (e->OpenSubkey(targetH,targetsH,id,0)!=LOCERR_OK) break;
+      id = KEYVAL_ID_NEXT;
+      string dbname;
+      sta = e->GetStrValue(targetH,"dbname",dbname);
+      if (sta==LOCERR_OK) sta = e->SetInt16Value(targetH,"enabled",dbname==BENCH_DATASTORE);
+      if (sta==LOCERR_OK && dbname==BENCH_DATASTORE) sta = e->SetStrValue(targetH,"remotepath",BENCH_DATASTORE);
+      e->CloseKey(targetH);
+    }
+  }
+  if (targetsH) e->CloseKey(targetsH);
+  if (profileH) e->CloseKey(profileH);
+  if (profilesH) e->CloseKey(profilesH);
+  return sta;
+} // setupProfile
+
+
+// set sync mode of the benchmark datastore's target
+static TSyError setSyncMode(TBench &aBench, uInt16 aSyncMode, bool aForceSlow)
+{
+  TEngineModuleBase *e = aBench.fClientP;
+  KeyH profilesH = NULL, profileH = NULL, targetsH = NULL, targetH = NULL;
+  TSyError sta = e->OpenKeyByPath(profilesH,NULL,"/profiles",0);
+  if (sta==LOCERR_OK) sta = e->OpenSubkey(profileH,profilesH,aBench.fProfileID,0);
+  if (sta==LOCERR_OK) sta = e->OpenKeyByPath(targetsH,profileH,"targets",0);
+  if (sta==LOCERR_OK) {
+    sInt32 id = KEYVAL_ID_FIRST;
+    while (sta==LOCERR_OK) {
+      if (e->OpenSubkey(targetH,targetsH,id,0)!=LOCERR_OK) break;
+      id = KEYVAL_ID_NEXT;
+      string dbname;
+      sta = e->GetStrValue(targetH,"dbname",dbname);
+      if (sta==LOCERR_OK && dbname==BENCH_DATASTORE) {
+        sta = e->SetInt16Value(targetH,"syncmode",aSyncMode);
+        if (sta==LOCERR_OK) sta = e->SetInt16Value(targetH,"forceslow",aForceSlow);
+      }
+      e->CloseKey(targetH);
+    }
+  }
+  if (targetsH) e->CloseKey(targetsH);
+  if (profileH) e->CloseKey(profileH);
+  if (profilesH) e->CloseKey(profilesH);
+  return sta;
+} // setSyncMode
+
+
+// write the next part of a message into the engine's buffer, returns the
+// step command to pass it with
+static uInt16 writeNextPart(TBench &aBench, TEngineModuleBase *aEngineP, SessionH aSessionH, const char *aData, memSize aSize, memSize &aWritten, TSyError &aSta)
+{
+  memSize n = aSize-aWritten;
+  if (aBench.fPartSize>0 && n>(memSize)aBench.fPartSize)
+    n = aBench.fPartSize;
+  aSta = aEngineP->WriteSyncMLBuffer(aSessionH,(appPointer)(aData+aWritten),n);
+  aWritten += n;
+  return aWritten<aSize ? STEPCMD_GOTPARTIALDATA : STEPCMD_GOTDATA;
+} // writeNextPart
+
+
+// pass one client message to the server, leaves the response in aBench.fResponse
+static bool serverRequest(TBench &aBench, appPointer aData, memSize aSize, TBenchResult &aResult)
+{
+  TEngineModuleBase *e = aBench.fServerP;
+  lineartime_t start = getSystemNowAs(TCTX_UTC,NULL);
+  TSyError sta = LOCERR_OK;
+  if (!aBench.fServerSessionH)
+    sta = e->OpenSession(aBench.fServerSessionH,0,"syncbench");
+  memSize written = 0;
+  uInt16 stepCmd = STEPCMD_GOTDATA;
+  if (sta==LOCERR_OK)
+    stepCmd = writeNextPart(aBench,e,aBench.fServerSessionH,(const char *)aData,aSize,written,sta);
+  bool gotResponse = false;
+  while (sta==LOCERR_OK) {
+    sta = e->SessionStep(aBench.fServerSessionH,stepCmd);
+    if (sta!=LOCERR_OK) break;
+    if (stepCmd==STEPCMD_OK || stepCmd==STEPCMD_PROGRESS) {
+      stepCmd = STEPCMD_STEP;
+    }
+    else if (stepCmd==STEPCMD_SENDDATA) {
+      appPointer bufP;
+      memSize bufSize;
+      sta = e->GetSyncMLBuffer(aBench.fServerSessionH,true,bufP,bufSize);
+      if (sta!=LOCERR_OK) break;
+      aBench.fResponse.assign((const char *)bufP,bufSize);
+      e->RetSyncMLBuffer(aBench.fServerSessionH,true,bufSize);
+      aResult.fServerBytes += bufSize;
+      gotResponse = true;
+      stepCmd = STEPCMD_SENTDATA;
+    }
+    else if (stepCmd==STEPCMD_NEEDDATA) {
+      if (gotResponse || written>=aSize) {
+        // waiting for next request
+        break;
+      }
+      // waiting for the next part of this request
+      stepCmd = writeNextPart(aBench,e,aBench.fServerSessionH,(const char *)aData,aSize,written,sta);
+    }
+    else if (stepCmd==STEPCMD_DONE) {
+      // session is over
+      if (!gotResponse) {
+        // a session aborted by the request (e.g. suspend alert) reports DONE
+        // right away, but still has the final answer in the buffer
+        appPointer bufP;
+        memSize bufSize;
+        if (e->GetSyncMLBuffer(aBench.fServerSessionH,true,bufP,bufSize)==LOCERR_OK) {
+          aBench.fResponse.assign((const char *)bufP,bufSize);
+          e->RetSyncMLBuffer(aBench.fServerSessionH,true,bufSize);
+          aResult.fServerBytes += bufSize;
+          gotResponse = bufSize>0;
+        }
+      }
+      e->CloseSession(aBench.fServerSessionH);
+      aBench.fServerSessionH = NULL;
+      break;
+    }
+    else {
+      sta = LOCERR_UNDEFINED; // error or unexpected step
+      break;
+    }
+  }
+  aResult.fServerMS += elapsedMS(start);
+  if (sta!=LOCERR_OK || !gotResponse) {
+    char buf[100];
+    snprintf(buf,sizeof(buf),"server step failed, err=%hu, stepcmd=%hu",sta,stepCmd);
+    aBench.fError = buf;
+    return false;
+  }
+  return true;
+} // serverRequest
+
+
+// run one client session, suspend it after aSuspendAfter messages if >0
+static bool runSession(TBench &aBench, TBenchResult &aResult, long aSuspendAfter)
+{
+  TEngineModuleBase *e = aBench.fClientP;
+  SessionH sessionH = NULL;
+  TSyError sta = e->OpenSession(sessionH,aBench.fProfileID,"syncbench");
+  uInt16 stepCmd = STEPCMD_CLIENTSTART;
+  long messages = 0;
+  bool suspended = false;
+  memSize responseWritten = 0; // part of aBench.fResponse already passed to the client
+  while (sta==LOCERR_OK) {
+    TEngineProgressInfo info;
+    lineartime_t start = getSystemNowAs(TCTX_UTC,NULL);
+    sta = e->SessionStep(sessionH,stepCmd,&info);
+    aResult.fClientMS += elapsedMS(start);
+    if (sta!=LOCERR_OK) break;
+    if (stepCmd==STEPCMD_PROGRESS) {
+      if (info.eventtype==PEV_DSSTATS_L || info.eventtype==PEV_DSSTATS_R)
+        aResult.fItems += info.extra1+info.extra2+info.extra3;
+      else if (
+        (info.eventtype==PEV_SYNCEND || info.eventtype==PEV_SESSIONEND) &&
+        info.extra1!=0 && aResult.fSyncEndError==0 &&
+        !(suspended && info.extra1==LOCERR_USERSUSPEND)
+      )
+        aResult.fSyncEndError = info.extra1;
+      stepCmd = STEPCMD_STEP;
+    }
+    else if (stepCmd==STEPCMD_OK || stepCmd==STEPCMD_RESTART) {
+      stepCmd = STEPCMD_STEP;
+    }
+    else if (stepCmd==STEPCMD_SENDDATA) {
+      appPointer bufP;
+      memSize bufSize;
+      sta = e->GetSyncMLBuffer(sessionH,true,bufP,bufSize);
+      if (sta!=LOCERR_OK) break;
+      aResult.fClientBytes += bufSize;
+      aResult.fMessages++;
+      messages++;
+      bool ok = serverRequest(aBench,bufP,bufSize,aResult);
+      e->RetSyncMLBuffer(sessionH,true,bufSize);
+      responseWritten = 0;
+      if (!ok) {
+        sta = LOCERR_UNDEFINED;
+        break;
+      }
+      stepCmd = STEPCMD_SENTDATA;
+    }
+    else if (stepCmd==STEPCMD_NEEDDATA) {
+      if (responseWritten>=aBench.fResponse.size()) {
+        aBench.fError = "client needs more data than the server sent";
+        sta = LOCERR_UNDEFINED;
+        break;
+      }
+      if (responseWritten==0 && aSuspendAfter>0 && messages>=aSuspendAfter && !suspended) {
+        // suspend now, session continues with the pending step and sends the suspend alert
+        uInt16 suspendCmd = STEPCMD_SUSPEND;
+        start = getSystemNowAs(TCTX_UTC,NULL);
+        sta = e->SessionStep(sessionH,suspendCmd);
+        aResult.fClientMS += elapsedMS(start);
+        suspended = true;
+        if (sta!=LOCERR_OK) break;
+      }
+      start = getSystemNowAs(TCTX_UTC,NULL);
+      stepCmd = writeNextPart(aBench,e,sessionH,aBench.fResponse.c_str(),aBench.fResponse.size(),responseWritten,sta);
+      aResult.fClientMS += elapsedMS(start);
+    }
+    else if (stepCmd==STEPCMD_DONE) {
+      break;
+    }
+    else {
+      sta = LOCERR_UNDEFINED; // error or unexpected step
+    }
+  }
+  if (sessionH) e->CloseSession(sessionH);
+  if (aBench.fServerSessionH) {
+    // server did not finish
+    aBench.fServerP->CloseSession(aBench.fServerSessionH);
+    aBench.fServerSessionH = NULL;
+  }
+  if (sta!=LOCERR_OK) {
+    if (aBench.fError.empty()) {
+      char buf[100];
+      snprintf(buf,sizeof(buf),"client step failed, err=%hu, stepcmd=%hu",sta,stepCmd);
+      aBench.fError = buf;
+    }
+    return false;
+  }
+  return true;
+} // runSession
+
+
+// run a sync of the benchmark datastore
+static bool runSync(TBench &aBench, TBenchResult &aResult, const char *aName, uInt16 aSyncMode, bool aSlow, long aSuspendAfter=0)
+{
+  memset(&aResult,0,sizeof(aResult));
+  aResult.fName = aName;
+  if (setSyncMode(aBench,aSyncMode,aSlow)!=LOCERR_OK) {
+    aBench.fError = "cannot set sync mode";
+    return false;
+  }
+  if (!runSession(aBench,aResult,aSuspendAfter)) return false;
+  if (aSuspendAfter>0) {
+    // resume the suspended session (without forcing a slow sync again)
+    if (setSyncMode(aBench,aSyncMode,false)!=LOCERR_OK) {
+      aBench.fError = "cannot set sync mode";
+      return false;
+    }
+    if (!runSession(aBench,aResult,0)) return false;
+  }
+  if (aResult.fSyncEndError) {
+    char buf[100];
+    snprintf(buf,sizeof(buf),"%s: sync ended with error %ld",aName,aResult.fSyncEndError);
+    aBench.fError = buf;
+    return false;
+  }
+  return true;
+} // runSync
+
+
+// mark all items in a textdb file as modified now by updating the change token column
+static bool touchItems(const string &aFileName)
+{
+  string data, out;
+  if (!readFile(aFileName,data)) return false;
+  // token: ISO8601 UTC timestamp in second column of each item line
+  string token;
+  TimestampToISO8601Str(token,getSystemNowAs(TCTX_UTC,NULL)+secondToLinearTimeFactor,TCTX_UTC,false,false);
+  string::size_type n = 0;
+  while (n<data.size()) {
+    string::size_type e = data.find('\n',n);
+    if (e==string::npos) e = data.size(); else e++;
+    string line = data.substr(n,e-n);
+    string::size_type t1 = line.find('\t');
+    string::size_type t2 = t1==string::npos ? string::npos : line.find('\t',t1+1);
+    if (t2!=string::npos)
+      line.replace(t1+1,t2-t1-1,token);
+    out += line;
+    n = e;
+  }
+  return writeFile(aFileName,out);
+} // touchItems
+
+
+// check that a textdb file has aNumItems items, a session can end without
+// error on the client even though the server gave up on the datastore
+static bool checkItems(TBench &aBench, const char *aName, const string &aFileName, long aNumItems)
+{
+  string data;
+  long n = 0;
+  if (readFile(aFileName,data)) {
+    for (string::size_type i=0; i<data.size(); i++)
+      if (data[i]=='\n') n++;
+  }
+  if (n!=aNumItems) {
+    char buf[100];
+    snprintf(buf,sizeof(buf),"%s: client has %ld of %ld items",aName,n,aNumItems);
+    aBench.fError = buf;
+    return false;
+  }
+  return true;
+} // checkItems
+
+
+// textdb file with aNumItems contacts
+// (the sample datastore automaps the columns after ID and token to the "contacts"
+// fieldlist by index: 0=SYNCLVL (10=visible), 2=N_LAST, 3=N_FIRST, 11=ORG_NAME,
+// 14=TEL, 18=EMAIL)
+static string makeItems(long aNumItems)
+{
+  string token;
+  TimestampToISO8601Str(token,getSystemNowAs(TCTX_UTC,NULL)-secondToLinearTimeFactor*3600,TCTX_UTC,false,false);
+  string data = "\xEF\xBB\xBF";
+  char buf[512];
+  for (long i=0; i<aNumItems; i++) {
+    snprintf(buf,sizeof(buf),
+      "%ld\t%s\t10\t\tDoe%ld\tJohn%ld\t\t\t\t\t\t\t\tSyncbench %ld\t\t\t+41 44 555 %04ld\t\t\t\tjohn%ld@example.com\r\n",
+      i+1,token.c_str(),i,i,i/100,i%10000,i
+    );
+    data += buf;
+  }
+  return data;
+} // makeItems
+
+
+static void printResult(const TBenchResult &aResult, bool aLast)
+{
+  double totalMS = aResult.fClientMS+aResult.fServerMS;
+  printf("    { \"sync\": \"%s\", \"items\": %ld, \"messages\": %ld, ",aResult.fName,aResult.fItems,aResult.fMessages);
+  printf("\"items_per_sec\": %.1f, ",totalMS>0 ? aResult.fItems*1000.0/totalMS : 0.0);
+  printf("\"client_bytes_per_message\": %.1f, ",aResult.fMessages ? (double)aResult.fClientBytes/aResult.fMessages : 0.0);
+  printf("\"server_bytes_per_message\": %.1f, ",aResult.fMessages ? (double)aResult.fServerBytes/aResult.fMessages : 0.0);
+  printf("\"client_ms\": %.1f, \"server_ms\": %.1f }%s\n",aResult.fClientMS,aResult.fServerMS,aLast ? "" : ",");
+} // printResult
+
+
+// remove a data directory and the files in it
+static void removeDataDir(const string &aDir)
+{
+  DIR *dirP = opendir(aDir.c_str());
+  if (dirP) {
+    struct dirent *entryP;
+    while ((entryP=readdir(dirP))!=NULL) {
+      if (entryP->d_name[0]!='.')
+        unlink((aDir+"/"+entryP->d_name).c_str());
+    }
+    closedir(dirP);
+  }
+  rmdir(aDir.c_str());
+} // removeDataDir
+
+
+static void usage(const char *aProgName)
+{
+  fprintf(stderr,"usage: %s [-n <items>] [-m <max message size>] [-e xml|wbxml] [-c <config dir>] [-w <work dir>] [-p <part size>]\n",aProgName);
+} // usage
+
+
+int main(int argc, char *argv[])
+{
+  long numItems = 500;
+  long maxMsgSize = 20000;
+  SmlEncoding_t encoding = SML_WBXML;
+  string configDir = SYNCBENCH_CONFIGDIR;
+  string workDir;
+  long partSize = 0;
+  int opt;
+  while ((opt=getopt(argc,argv,"n:m:e:c:w:p:"))!=-1) {
+    switch (opt) {
+      case 'n' : numItems = atol(optarg); break;
+      case 'm' : maxMsgSize = atol(optarg); break;
+      case 'e' : encoding = strcmp(optarg,"xml")==0 ? SML_XML : SML_WBXML; break;
+      case 'c' : configDir = optarg; break;
+      case 'w' : workDir = optarg; break;
+      case 'p' : partSize = atol(optarg); break;
+      default : usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if (numItems<=0 || maxMsgSize<=1000 || partSize<0) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  // configs
+  string serverConfig, clientConfig;
+  if (
+    !readFile(configDir+"/syncserv_sample_config.xml",serverConfig) ||
+    !readFile(configDir+"/syncclient_sample_config.xml",clientConfig)
+  ) {
+    fprintf(stderr,"cannot read sample configs from %s\n",configDir.c_str());
+    return EXIT_FAILURE;
+  }
+  // work directory with separate data for client and server
+  bool tempWorkDir = workDir.empty();
+  if (tempWorkDir) {
+    char tmpl[] = "/tmp/syncbench-XXXXXX";
+    if (!mkdtemp(tmpl)) {
+      fprintf(stderr,"cannot create work directory\n");
+      return EXIT_FAILURE;
+    }
+    workDir = tmpl;
+  }
+  string serverDir = workDir+"/server";
+  string clientDir = workDir+"/client";
+  mkdir(serverDir.c_str(),0700);
+  mkdir(clientDir.c_str(),0700);
+  adaptConfig(serverConfig,maxMsgSize,serverDir,false);
+  adaptConfig(clientConfig,maxMsgSize,clientDir,true);
+  // server has the items
+  string serverDataFile = serverDir+"/TDB_" BENCH_USER "_" BENCH_DATASTORE ".txt";
+  string clientDataFile = clientDir+"/TDB_" BENCH_CLIENT_USER "_" BENCH_DATASTORE ".txt";
+  TBench bench;
+  bench.fClientP = NULL;
+  bench.fServerP = NULL;
+  bench.fServerSessionH = NULL;
+  bench.fProfileID = 0;
+  bench.fPartSize = partSize;
+  bool ok = writeFile(serverDataFile,makeItems(numItems));
+  if (!ok)
+    bench.fError = "cannot write "+serverDataFile;
+  // engines
+  if (ok) {
+    bench.fServerP = newEngine(true,serverConfig,bench.fError);
+    if (bench.fServerP)
+      bench.fClientP = newEngine(false,clientConfig,bench.fError);
+    ok = bench.fClientP!=NULL;
+  }
+  if (ok && setupProfile(bench,encoding)!=LOCERR_OK) {
+    bench.fError = "cannot set up client profile";
+    ok = false;
+  }
+  // syncs
+  const int numSyncs = 4;
+  TBenchResult results[numSyncs];
+  int done = 0;
+  // - slow sync: all server items go to the empty client
+  if (ok) ok = runSync(bench,results[done++],"slow",smo_twoway,true);
+  if (ok) ok = checkItems(bench,"slow",clientDataFile,numItems);
+  // - two-way: all client items modified
+  if (ok && !touchItems(clientDataFile)) {
+    bench.fError = "cannot modify client items";
+    ok = false;
+  }
+  if (ok) ok = runSync(bench,results[done++],"twoway",smo_twoway,false);
+  if (ok) ok = checkItems(bench,"twoway",clientDataFile,numItems);
+  // - refresh from server
+  if (ok) ok = runSync(bench,results[done++],"refresh",smo_fromserver,true);
+  if (ok) ok = checkItems(bench,"refresh",clientDataFile,numItems);
+  // - refresh from server suspended after the second message, then resumed
+  if (ok) ok = runSync(bench,results[done++],"resume",smo_fromserver,true,2);
+  if (ok) ok = checkItems(bench,"resume",clientDataFile,numItems);
+  // clean up
+  if (bench.fClientP) {
+    bench.fClientP->Disconnect();
+    delete bench.fClientP;
+  }
+  if (bench.fServerP) {
+    bench.fServerP->Disconnect();
+    delete bench.fServerP;
+  }
+  if (tempWorkDir) {
+    removeDataDir(serverDir);
+    removeDataDir(clientDir);
+    rmdir(workDir.c_str());
+  }
+  if (!ok) {
+    fprintf(stderr,"syncbench failed: %s\n",bench.fError.c_str());
+    return EXIT_FAILURE;
+  }
+  // report
+  long peakRSSkB = -1;
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)==0)
+    peakRSSkB = usage.ru_maxrss;
+  printf("{\n");
+  printf("  \"datastore\": \"%s\",\n",BENCH_DATASTORE);
+  printf("  \"encoding\": \"%s\",\n",encoding==SML_XML ? "xml" : "wbxml");
+  printf("  \"items\": %ld,\n",numItems);
+  printf("  \"maxmsgsize\": %ld,\n",maxMsgSize);
+  printf("  \"partsize\": %ld,\n",partSize);
+  printf("  \"syncs\": [\n");
+  for (int i=0; i<numSyncs; i++)
+    printResult(results[i],i==numSyncs-1);
+  printf("  ],\n");
+  printf("  \"peak_rss_kb\": %ld\n",peakRSSkB);
+  printf("}\n");
+  return EXIT_SUCCESS;
+} // main
+
+/* eof */